@@ -1,10 +1,18 @@
 # Main program files: threads, console...
 SET (sphere_SRCS
+src/sphere/asyncauth.cpp
+src/sphere/asyncauth.h
 src/sphere/asyncdb.cpp
 src/sphere/asyncdb.h
+src/sphere/asynclog.cpp
+src/sphere/asynclog.h
+src/sphere/asyncscript.cpp
+src/sphere/asyncscript.h
 src/sphere/containers.h
 src/sphere/ConsoleInterface.cpp
 src/sphere/ConsoleInterface.h
+src/sphere/Metrics.cpp
+src/sphere/Metrics.h
 src/sphere/ProfileData.cpp
 src/sphere/ProfileData.h
 src/sphere/ProfileTask.cpp
@@ -28,6 +36,8 @@ src/network/CIPHistoryManager.cpp
 src/network/CIPHistoryManager.h
 src/network/CNetState.cpp
 src/network/CNetState.h
+src/network/CNetOutQueue.cpp
+src/network/CNetOutQueue.h
 src/network/CNetworkInput.cpp
 src/network/CNetworkInput.h
 src/network/CNetworkManager.cpp
@@ -38,6 +48,8 @@ src/network/CNetworkThread.cpp
 src/network/CNetworkThread.h
 src/network/CPacketManager.cpp
 src/network/CPacketManager.h
+src/network/CPacketPool.cpp
+src/network/CPacketPool.h
 src/network/CSocket.cpp
 src/network/CSocket.h
 src/network/linuxev.cpp
@@ -215,6 +227,8 @@ src/common/resource/sections/CSkillClassDef.cpp
 src/common/resource/sections/CSkillClassDef.h
 src/common/resource/sections/CSkillDef.cpp
 src/common/resource/sections/CSkillDef.h
+src/common/resource/sections/CSpeechDef.cpp
+src/common/resource/sections/CSpeechDef.h
 src/common/resource/sections/CSpellDef.cpp
 src/common/resource/sections/CSpellDef.h
 src/common/resource/sections/CWebPageDef.cpp
@@ -276,6 +290,8 @@ SOURCE_GROUP (common\\sphere_library FILES ${spherelibrary_SRCS})
 SET (game_SRCS
 src/game/CBase.cpp
 src/game/CBase.h
+src/game/CBenchmark.cpp
+src/game/CBenchmark.h
 src/game/CContainer.cpp
 src/game/CContainer.h
 src/game/CComponent.cpp
@@ -317,6 +333,8 @@ src/game/CServerTime.h
 src/game/CStartLoc.h
 src/game/CTeleport.cpp
 src/game/CTeleport.h
+src/game/CTickScheduler.cpp
+src/game/CTickScheduler.h
 src/game/CTimedFunction.cpp
 src/game/CTimedFunction.h
 src/game/CTimedFunctionHandler.cpp
@@ -1,6 +1,8 @@
 
 #include "../sphere/threads.h"
+#include "CExpression.h"
 #include "CCacheableScriptFile.h"
+#include <algorithm>
 
 #ifdef _WIN32
 #include <io.h> // for _get_osfhandle (used by STDFUNC_FILENO)
@@ -13,6 +15,7 @@ CCacheableScriptFile::CCacheableScriptFile()
     _fClosed = true;
     _fRealFile = false;
     _iCurrentLine = 0;
+    _uiContentHash = 0;
 }
 
 CCacheableScriptFile::~CCacheableScriptFile() 
@@ -61,6 +64,8 @@ bool CCacheableScriptFile::_Open(lpctstr ptcFilename, uint uiModeFlags)
         delete _fileContent;
         _fileContent = nullptr;
     }
+    _vSectionLines.clear();
+    _uiContentHash = 0;
 
     if ((uiModeFlags & OF_WRITE) || (uiModeFlags & OF_READWRITE))
     {
@@ -72,6 +77,7 @@ bool CCacheableScriptFile::_Open(lpctstr ptcFilename, uint uiModeFlags)
         tchar* ptcBuf = tsBuf.buffer();
         size_t uiStrLen;
         bool fUTF = false, fFirstLine = true;
+        ullong uiHash = 14695981039346656037ull;  // FNV-1a
         const int iFileLength = _GetLength();
         _fileContent = new std::vector<std::string>;
         _fileContent->reserve(iFileLength / 20);
@@ -108,6 +114,16 @@ bool CCacheableScriptFile::_Open(lpctstr ptcFilename, uint uiModeFlags)
                 _fileContent->emplace_back();
             else
                 _fileContent->emplace_back(str_start, len_to_copy);
+
+            // Index the section headers, so that FindNextSection doesn't need to read all the lines in between.
+            lpctstr ptcLineStart = str_start;
+            GETNONWHITESPACE(ptcLineStart);
+            if (*ptcLineStart == '[')
+                _vSectionLines.emplace_back(int(_fileContent->size() - 1));
+
+            for (size_t i = 0; i < len_to_copy; ++i)
+                uiHash = (uiHash ^ uchar(str_start[i])) * 1099511628211ull;
+            uiHash = (uiHash ^ uchar('\n')) * 1099511628211ull;
             fFirstLine = false;
             fUTF = false;
         }
@@ -118,6 +134,8 @@ bool CCacheableScriptFile::_Open(lpctstr ptcFilename, uint uiModeFlags)
         _uiMode = 0;
         _iCurrentLine = 0;
         _fileContent->shrink_to_fit();
+        _vSectionLines.shrink_to_fit();
+        _uiContentHash = uiHash;
     }
 
     return true;
@@ -248,6 +266,19 @@ bool CCacheableScriptFile::HasCache() const
     THREAD_SHARED_LOCK_RETURN(_HasCache());
 }
 
+int CCacheableScriptFile::_GetNextSectionLine(int iLine) const
+{
+    if ( !_fRealFile || _useDefaultFile() || (_fileContent == nullptr) )
+        return -1;
+
+    const auto itHead = std::lower_bound(_vSectionLines.begin(), _vSectionLines.end(), iLine);
+    return (itHead == _vSectionLines.end()) ? int(_fileContent->size()) : *itHead;
+}
+int CCacheableScriptFile::GetNextSectionLine(int iLine) const
+{
+    THREAD_SHARED_LOCK_RETURN(_GetNextSectionLine(iLine));
+}
+
 bool CCacheableScriptFile::_useDefaultFile() const 
 {
     if ( _IsWriteMode() || ( _GetFullMode() & OF_DEFAULTMODE )) 
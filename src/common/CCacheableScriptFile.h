@@ -44,6 +44,13 @@ protected:
 protected:  bool _HasCache() const;
 public:     bool HasCache() const;
 
+            // Line of the first section header at or after iLine (size of the file if there's none), -1 if we don't have the index.
+protected:  int _GetNextSectionLine(int iLine) const;
+public:     int GetNextSectionLine(int iLine) const;
+            ullong GetContentHash() const noexcept {
+                return _uiContentHash;
+            }
+
 public:
 	bool _fClosed;
 	bool _fRealFile;
@@ -51,6 +58,8 @@ public:
 
 protected:
 	std::vector<std::string>* _fileContent; // It's better to have a pointer so that CResourceLock can access to this
+	std::vector<int> _vSectionLines;        // Lines starting with '[', built when caching the file (not shared with the copies)
+	ullong _uiContentHash;                  // Hash of the cached content, to tell if a file really changed
 
 private:    bool _useDefaultFile() const;
 //public:     bool useDefaultFile() const;
@@ -226,6 +226,7 @@ void _cdecl Sphere_Exception_Windows( unsigned int id, struct _EXCEPTION_POINTER
 	size_t pAddr = (size_t)pData->ExceptionRecord->ExceptionAddress;
 	pAddr -= pCodeStart;
 
+	g_Log.FlushQueue();
 	throw CWinException(id, pAddr);
 }
 
@@ -271,6 +272,7 @@ void _cdecl Signal_Terminate(int sig = 0) // If shutdown is initialized
         _Signal_Terminate_stack_printed = true;
     }
 #endif
+    g_Log.FlushQueue();
 
     if (sig)
     {
@@ -329,6 +331,7 @@ void _cdecl Signal_Illegal_Instruction(int sig = 0)
 #ifdef THREAD_TRACK_CALLSTACK
     StackDebugInformation::freezeCallStack(false);
 #endif
+    g_Log.FlushQueue();
     throw CSError(LOGL_FATAL, sig, strsignal(sig));
 }
 
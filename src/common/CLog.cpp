@@ -1,9 +1,12 @@
 
+#include "../sphere/asynclog.h"
 #include "../sphere/ProfileTask.h"
 #include "../game/CServer.h"
 #include "CException.h"
 #include "CScript.h"
 #include "CLog.h"
+#include <chrono>
+#include <thread>
 
 
 int CEventLog::VEvent(dword dwMask, lpctstr pszFormat, va_list args) noexcept
@@ -74,7 +77,9 @@ int CEventLog::EventEvent(lpctstr pszFormat, ...) noexcept
 
 //-------
 
-CLog::CLog()
+CLog::CLog() :
+	_uiQueueMask(0), _uiQueueHead(0), _uiQueueTail(0), _fQueueActive(false),
+	_uiQueuedLines(0), _uiDroppedLines(0), _uiWaitedLines(0), _uiDroppedReported(0)
 {
 	m_fLockOpen = false;
 	m_pScriptContext = nullptr;
@@ -204,6 +209,232 @@ bool CLog::OpenLog(lpctstr pszBaseDirName)	// name set previously.
 	THREAD_UNIQUE_LOCK_RETURN(CLog::_OpenLog(pszBaseDirName));
 }
 
+bool CLog::StartQueue(int iLength)
+{
+	ADDTOCALLSTACK("CLog::StartQueue");
+	if ( (iLength <= 0) || IsQueueActive() )
+		return false;
+
+	size_t uiLength = 2;	// must be a power of 2
+	while ( uiLength < (size_t)iLength )
+		uiLength <<= 1;
+
+	THREAD_UNIQUE_LOCK_SET;
+	if ( !_pQueue )
+	{
+		_pQueue = std::make_unique<QueuedLine[]>(uiLength);
+		_pQueueBatch = std::make_unique<tchar[]>(LOGQUEUE_BATCH_LENGTH);
+		_uiQueueMask = uiLength - 1;
+	}
+	for ( size_t i = 0; i <= _uiQueueMask; ++i )
+	{
+		_pQueue[i].uiSeq.store(i, std::memory_order_relaxed);
+		_pQueue[i].ptcLongText = nullptr;
+	}
+	_uiQueueHead.store(0, std::memory_order_relaxed);
+	_uiQueueTail.store(0, std::memory_order_relaxed);
+	_fQueueActive.store(true, std::memory_order_release);
+	return true;
+}
+
+void CLog::StopQueue()
+{
+	ADDTOCALLSTACK("CLog::StopQueue");
+	if ( !IsQueueActive() )
+		return;
+
+	// The queue isn't freed: another thread might still be putting a line in it.
+	_fQueueActive.store(false, std::memory_order_release);
+	THREAD_UNIQUE_LOCK_SET;
+	_WriteQueue();
+}
+
+void CLog::WriteQueue()
+{
+	ADDTOCALLSTACK("CLog::WriteQueue");
+	THREAD_UNIQUE_LOCK_SET;
+	_WriteQueue();
+}
+
+void CLog::FlushQueue() noexcept
+{
+	if ( !IsQueueActive() )
+		return;
+
+	try
+	{
+		// Don't wait for the lock: we might be crashing in the thread holding it.
+		std::unique_lock<std::shared_mutex> lock(THREAD_CMUTEX, std::try_to_lock);
+		if ( lock.owns_lock() )
+			_WriteQueue();
+	}
+	catch (...)
+	{
+		// Not much we can do about this
+	}
+}
+
+size_t CLog::GetQueueUsed() const noexcept
+{
+	// Approximate, it's read without locking: head and tail are loaded one after the other.
+	if ( !IsQueueActive() )
+		return 0;
+	const size_t uiHead = _uiQueueHead.load(std::memory_order_relaxed);
+	const size_t uiTail = _uiQueueTail.load(std::memory_order_relaxed);
+	return (uiHead > uiTail) ? minimum(uiHead - uiTail, _uiQueueMask + 1) : 0;
+}
+
+bool CLog::_QueueLine(dword dwMask, int iDay, lpctstr ptcTime, lpctstr ptcLabel, lpctstr ptcContext, lpctstr ptcMsg) noexcept
+{
+	// Called by any thread: get a free slot, then fill it and mark it as ready for the writer.
+	const uint uiLevel = (dwMask & LOGL_QTY);
+	const bool fError = (uiLevel != 0) && (uiLevel <= LOGL_ERROR);
+	llong iTimeWaitStart = 0;
+
+	QueuedLine* pLine;
+	size_t uiPos = _uiQueueHead.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		pLine = &_pQueue[uiPos & _uiQueueMask];
+		const size_t uiSeq = pLine->uiSeq.load(std::memory_order_acquire);
+		const intptr_t iDiff = (intptr_t)uiSeq - (intptr_t)uiPos;
+		if ( iDiff == 0 )
+		{
+			if ( _uiQueueHead.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed) )
+				break;
+		}
+		else if ( iDiff < 0 )
+		{
+			// The queue is full: the errors wait a bit for the writer to make some room (unless we are the writer), the other lines are dropped.
+			if ( !fError || g_asyncLog.isCurrentThread() )
+			{
+				_uiDroppedLines.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			const llong iTimeNow = CSTime::GetPreciseSysTimeMilli();
+			if ( iTimeWaitStart == 0 )
+			{
+				iTimeWaitStart = iTimeNow;
+				_uiWaitedLines.fetch_add(1, std::memory_order_relaxed);
+			}
+			else if ( iTimeNow - iTimeWaitStart > LOGQUEUE_WAIT_MAX )
+			{
+				_uiDroppedLines.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			g_asyncLog.awaken();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			uiPos = _uiQueueHead.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			uiPos = _uiQueueHead.load(std::memory_order_relaxed);
+		}
+	}
+
+	tchar* ptcDest = pLine->szText;
+	size_t uiDestSize = sizeof(pLine->szText);
+	const size_t uiLen = strlen(ptcTime) + strlen(ptcLabel) + strlen(ptcContext) + strlen(ptcMsg) + 1;
+	if ( uiLen > uiDestSize )
+	{
+		pLine->ptcLongText = new (std::nothrow) tchar[uiLen];
+		if ( pLine->ptcLongText != nullptr )
+		{
+			ptcDest = pLine->ptcLongText;
+			uiDestSize = uiLen;
+		}
+	}
+	snprintf(ptcDest, uiDestSize, "%s%s%s%s", ptcTime, ptcLabel, ptcContext, ptcMsg);
+	pLine->iDay = iDay;
+	pLine->uiSeq.store(uiPos + 1, std::memory_order_release);
+
+	_uiQueuedLines.fetch_add(1, std::memory_order_relaxed);
+	if ( (uiPos & (_uiQueueMask >> 1)) == 0 )
+		g_asyncLog.awaken();	// every half queue of lines, don't wait for the writer's next tick
+	return true;
+}
+
+void CLog::_WriteQueue()
+{
+	// Assume we have the mutex already locked here
+	if ( !_pQueue )
+		return;
+
+	if ( !_IsFileOpen() )
+	{
+		// On Linux the file is closed after each line written directly.
+		_Open(nullptr, OF_READWRITE|OF_TEXT|OF_SHARE_DENY_NONE);
+	}
+
+	tchar* ptcBatch = _pQueueBatch.get();
+	size_t uiBatchLen = 0;
+	auto WriteBatch = [this, ptcBatch, &uiBatchLen]() -> void
+	{
+		if ( uiBatchLen > 0 )
+		{
+			_Write(ptcBatch, (int)uiBatchLen);
+			uiBatchLen = 0;
+		}
+	};
+	auto AddToBatch = [this, ptcBatch, &uiBatchLen, &WriteBatch](lpctstr ptcText) -> void
+	{
+		const size_t uiLen = strlen(ptcText);
+		if ( uiBatchLen + uiLen > LOGQUEUE_BATCH_LENGTH )
+		{
+			WriteBatch();
+			if ( uiLen > LOGQUEUE_BATCH_LENGTH )
+			{
+				_Write(ptcText, (int)uiLen);
+				return;
+			}
+		}
+		memcpy(ptcBatch + uiBatchLen, ptcText, uiLen);
+		uiBatchLen += uiLen;
+	};
+
+	const ullong uiDropped = _uiDroppedLines.load(std::memory_order_relaxed);
+	if ( uiDropped != _uiDroppedReported )
+	{
+		tchar szMsg[96];
+		snprintf(szMsg, sizeof(szMsg), "WARNING:%" PRIu64 " lines not logged, the log queue was full.\n", uiDropped - _uiDroppedReported);
+		_uiDroppedReported = uiDropped;
+		AddToBatch(szMsg);
+	}
+
+	size_t uiTail = _uiQueueTail.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		QueuedLine& line = _pQueue[uiTail & _uiQueueMask];
+		if ( line.uiSeq.load(std::memory_order_acquire) != uiTail + 1 )
+			break;	// empty, or its producer is still filling the next line
+
+		if ( line.iDay != m_dateStamp.GetDay() )
+		{
+			// it's a new day, open a log file with new day name.
+			WriteBatch();
+			_Close();
+			_OpenLog();
+			_Printf("Log date: %s\n", m_dateStamp.Format(nullptr));
+		}
+
+		if ( line.ptcLongText != nullptr )
+		{
+			AddToBatch(line.ptcLongText);
+			delete[] line.ptcLongText;
+			line.ptcLongText = nullptr;
+		}
+		else
+		{
+			AddToBatch(line.szText);
+		}
+
+		line.uiSeq.store(uiTail + _uiQueueMask + 1, std::memory_order_release);
+		++uiTail;
+		_uiQueueTail.store(uiTail, std::memory_order_relaxed);
+	}
+	WriteBatch();
+}
+
 int CLog::EventStr( dword dwMask, lpctstr pszMsg ) noexcept
 {
     ADDTOCALLSTACK("CLog::EventStr");
@@ -292,7 +523,12 @@ int CLog::EventStr( dword dwMask, lpctstr pszMsg ) noexcept
 		}
 
 		// Print to log file.
-		if ( !(dwMask & LOGF_CONSOLE_ONLY) )
+		if ( !(dwMask & LOGF_CONSOLE_ONLY) && _fQueueActive.load(std::memory_order_acquire) )
+		{
+			// The log writer thread will write it.
+			_QueueLine(dwMask, datetime.GetDay(), szTime, pszLabel ? pszLabel : "", szScriptContext, pszMsg);
+		}
+		else if ( !(dwMask & LOGF_CONSOLE_ONLY) )
 		{
 			THREAD_UNIQUE_LOCK_SET;
 
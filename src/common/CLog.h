@@ -10,7 +10,9 @@
 #include "sphere_library/CSTime.h"
 #include "../sphere/ConsoleInterface.h"
 #include "../sphere/UnixTerminal.h"
+#include <atomic>
 #include <exception>
+#include <memory>
 
 // -----------------------------
 //	CEventLog
@@ -52,6 +54,11 @@ class CScript;
 class CScriptObj;
 
 
+#define LOGQUEUE_LINE_LENGTH	512		// queued lines longer than this are allocated apart
+#define LOGQUEUE_BATCH_LENGTH	0x10000	// bytes written to the log file at once by the log writer
+#define LOGQUEUE_WAIT_MAX		200		// max msecs an error waits for room in a full queue, before being dropped
+
+
 class CEventLog
 {
 	// Any text event stream. (destination is independant)
@@ -94,6 +101,32 @@ private:
 
 	static CSTime sm_prevCatchTick;			// don't flood with these.
 
+	// When the log writer thread is running, the lines for the log file are put in this queue by any thread (without locks)
+	//  and written by the log writer, in batches and keeping the file open. It's a bounded ring: each slot has a sequence number
+	//  telling if it's free for the producers or ready for the writer. When it's full, errors wait a bit for some room, the other
+	//  lines are dropped (and counted).
+	struct QueuedLine
+	{
+		std::atomic<size_t> uiSeq;
+		tchar* ptcLongText;				// the line didn't fit in szText
+		int iDay;						// day of the month when the line was logged, to change the log file
+		tchar szText[LOGQUEUE_LINE_LENGTH];
+	};
+	std::unique_ptr<QueuedLine[]> _pQueue;
+	std::unique_ptr<tchar[]> _pQueueBatch;	// lines to be written at once in the log file
+	size_t _uiQueueMask;
+	std::atomic<size_t> _uiQueueHead;		// next slot for the producers
+	std::atomic<size_t> _uiQueueTail;		// next slot for the writer (written with the file locked, read by GetQueueUsed)
+	std::atomic<bool> _fQueueActive;
+
+	std::atomic<ullong> _uiQueuedLines;
+	std::atomic<ullong> _uiDroppedLines;	// the queue was full
+	std::atomic<ullong> _uiWaitedLines;		// errors which had to wait for room in the queue
+	ullong _uiDroppedReported;				// dropped lines already reported in the log file
+
+	bool _QueueLine(dword dwMask, int iDay, lpctstr ptcTime, lpctstr ptcLabel, lpctstr ptcContext, lpctstr ptcMsg) noexcept;
+	void _WriteQueue();
+
 public:
 	bool m_fLockOpen;
 
@@ -108,6 +141,24 @@ public:		bool OpenLog(lpctstr pszName = nullptr);
 
 	bool SetFilePath(lpctstr pszName);
 
+	bool StartQueue(int iLength);	// start queueing the lines for the log writer thread
+	void StopQueue();				// go back to write the lines directly, writing the ones still queued
+	void WriteQueue();				// log writer thread: write the queued lines
+	void FlushQueue() noexcept;		// write the queued lines right now, ie. from a crash handler
+	bool IsQueueActive() const noexcept {
+		return _fQueueActive.load(std::memory_order_relaxed);
+	}
+	size_t GetQueueUsed() const noexcept;
+	ullong GetQueuedLines() const noexcept {
+		return _uiQueuedLines.load(std::memory_order_relaxed);
+	}
+	ullong GetDroppedLines() const noexcept {
+		return _uiDroppedLines.load(std::memory_order_relaxed);
+	}
+	ullong GetWaitedLines() const noexcept {
+		return _uiWaitedLines.load(std::memory_order_relaxed);
+	}
+
 	lpctstr GetLogDir() const;
 	dword GetLogMask() const;
 	void SetLogMask( dword dwMask );
@@ -601,6 +601,15 @@ bool CScript::FindNextSection()
 
 	for (;;)
 	{
+		// Jump straight to the next line starting with '[', if the file has the index of the section headers.
+		const int iCurLine = GetPosition();
+		const int iHeadLine = GetNextSectionLine(iCurLine);
+		if ( iHeadLine > iCurLine )
+		{
+			m_iLineNum += (iHeadLine - iCurLine);
+			CCacheableScriptFile::Seek(iHeadLine, SEEK_SET);
+		}
+
 		if ( !ReadTextLine(true) )
 		{
 			m_iSectionData = GetPosition();
@@ -15,6 +15,7 @@
 #include "../game/CWorld.h"
 #include "../game/CWorldMap.h"
 #include "../game/CWorldTimedFunctions.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ProfileTask.h"
 #include "crypto/CBCrypt.h"
 #include "crypto/CMD5.h"
@@ -2833,6 +2834,9 @@ TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextCo
         return clean_return(TRIGRET_RET_ABORTED);
     }
 
+	// Measure only the outermost script run, the nested ones are included in its time.
+	const MetricTimer scriptTimer(METRIC_SCRIPT_RUN, (g_reentrant_OnTriggerRun == 1));
+
 	//	Script execution is always not threaded action
 	EXC_TRY("TriggerRun");
 
@@ -153,3 +153,13 @@ bool CBCrypt::ValidateBCrypt(const char* password, const char* hash) // static
 {
     return (bcrypt_checkpw(password, hash) == 0);
 }
+
+bool CBCrypt::IsBCryptHash(const char* hash) // static
+{
+    // $2a$, $2b$ or $2y$, followed by the cost, the salt and the hash: 60 chars.
+    if ((hash[0] != '$') || (hash[1] != '2'))
+        return false;
+    if ((hash[2] != 'a') && (hash[2] != 'b') && (hash[2] != 'y'))
+        return false;
+    return (hash[3] == '$') && (strlen(hash) == 60);
+}
@@ -7,6 +7,7 @@ struct CBCrypt
 {
     static CSString HashBCrypt(const char* password, int iPrefixCode = 2, int iCost = 4);
     static bool ValidateBCrypt(const char* password, const char* hash);
+    static bool IsBCryptHash(const char* hash);
 };
 
 #endif	// _INC_CBCRYPT_H
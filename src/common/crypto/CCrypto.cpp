@@ -26,10 +26,19 @@ CCryptoKeysHolder* CCryptoKeysHolder::get() noexcept
 	return &instance;
 }
 
+CCryptoKeysHolder::CCryptoKeysHolder() :
+	_uiRecentLoginKeysNext(0), _iRecentGameEnc(ENC_NONE)
+{
+	for (std::atomic<uint>& uiKey : _uiRecentLoginKeys)
+		uiKey = UINT32_MAX;	// no key
+}
+
 void CCryptoKeysHolder::LoadKeyTable(CScript& s)
 {
 	ADDTOCALLSTACK("CCrypto::LoadKeyTable");
 	client_keys.clear();
+	for (std::atomic<uint>& uiKey : _uiRecentLoginKeys)
+		uiKey = UINT32_MAX;
 
 	// Always add nocrypt
 	addNoCryptKey();
@@ -53,6 +62,24 @@ void CCryptoKeysHolder::addNoCryptKey(void)
 	client_keys.emplace_back(std::move(c));
 }
 
+void CCryptoKeysHolder::AddRecentLoginKey(uint uiKey)
+{
+	if (IsRecentLoginKey(uiKey))
+		return;
+	// Replace the oldest one. Concurrent logins may overwrite each other's slot: no harm, these are only hints.
+	_uiRecentLoginKeys[_uiRecentLoginKeysNext++ % CRYPT_RECENT_KEYS] = uiKey;
+}
+
+bool CCryptoKeysHolder::IsRecentLoginKey(uint uiKey) const
+{
+	for (const std::atomic<uint>& uiRecent : _uiRecentLoginKeys)
+	{
+		if (uiRecent == uiKey)
+			return true;
+	}
+	return false;
+}
+
 // --
 
 void CCrypto::SetClientVersion( dword iVer )
@@ -625,88 +652,123 @@ bool CCrypto::LoginCryptStart( dword dwIP, const byte * pEvent, uint inLen )
 	SetCryptMask(tmp_CryptMaskHi, tmp_CryptMaskLo);
 
 	CCryptoKeysHolder* keys_holder = CCryptoKeysHolder::get();
-
-	for (uint i = 0, iAccountNameLen = 0;;)
+	const uint uiKeys = (uint)keys_holder->client_keys.size();
+
+	// The clients connecting to a shard usually are of a few versions: try first the keys which matched the last logins,
+	//  then scan the whole key table (skipping the keys already tried).
+	// NOTE: this changes the precedence when a packet is validated by more than one key (ie. the 4.0.0 keys, see the sanity
+	//  check in LoginCryptTryKey): a recent key now wins over a key coming before it in the table, if that one isn't recent too.
+	//  Among the recent keys the table order is kept.
+	uint uiRecentKeys[CRYPT_RECENT_KEYS];
+	for (uint n = 0; n < CRYPT_RECENT_KEYS; ++n)
+		uiRecentKeys[n] = keys_holder->_uiRecentLoginKeys[n];
+	std::sort(uiRecentKeys, uiRecentKeys + CRYPT_RECENT_KEYS);	// in table order (no key = UINT32_MAX goes last)
+
+	for (uint n = 0; ; ++n)
 	{
-		if ( i >= keys_holder->client_keys.size() )
+		if ( n >= CRYPT_RECENT_KEYS + uiKeys )
 		{
 			// Unknown client !!! Set as unencrypted and let Sphere do the rest.
 #ifdef DEBUG_CRYPT_MSGS
-			DEBUG_ERR(("Unknown client, i = %" PRIuSIZE_T "\n", i));
+			DEBUG_ERR(("Unknown client, tried %u keys\n", uiKeys));
 #endif
 			SetClientVerIndex(0);
 			SetCryptMask(tmp_CryptMaskHi, tmp_CryptMaskLo); // Hi - Lo
 			break;
 		}
 
-		SetCryptMask(tmp_CryptMaskHi, tmp_CryptMaskLo);
-		// Set client version properties
-		SetClientVerIndex(i);
-
-		// Test Decrypt
-		if (!Decrypt(pRaw.get(), pEvent, MAX_BUFFER, inLen ))
-        {
-            g_Log.EventError("NET-IN: LoginCryptStart failed (decrypt).\n");
-            return false;
-        }
-
-#ifdef DEBUG_CRYPT_MSGS
-		DEBUG_MSG(("LoginCrypt %" PRIuSIZE_T " (%" PRIu32 ") type %" PRIx8 "-%" PRIx8 "\n", i, GetClientVer(), m_Raw[0], pEvent[0]));
-#endif
-		bool isValid = (pRaw[0] == 0x80 && pRaw[30] == 0x00 && pRaw[60] == 0x00 );
-		if ( isValid )
+		uint i;
+		if ( n < CRYPT_RECENT_KEYS )
 		{
-			// -----------------------------------------------------
-			// This is a sanity check, sometimes client keys (like 4.0.0) can intercept, incorrectly,
-			// a login packet. When is decrypted it is done not correctly (strange chars after
-			// regular account name/password). This prevents that fact, choosing the right keys
-			// to decrypt it correctly :)
-			for (int toCheck = 21; toCheck <= 30; ++toCheck)
-			{
-				// no official client allows the account name or password to
-				// exceed 20 chars (2d=16,kr=20), meaning that chars 21-30 must
-				// always be 0x00 (some unofficial clients may allow the user
-				// to enter more, but as they generally don't use encryption
-				// it shouldn't be a problem)
-				if (pRaw[toCheck] == 0x00 && pRaw[toCheck+30] == 0x00)
-					continue;
-
-				isValid = false;
-				break;
-			}
-
-			if ( isValid == true )
-			{
-                char pszAccountNameCheck[MAX_ACCOUNT_NAME_SIZE];
-				lpctstr sRawAccountName = reinterpret_cast<lpctstr>(pRaw.get() + 1 );
-				iAccountNameLen = (uint)Str_GetBare(pszAccountNameCheck, sRawAccountName, MAX_ACCOUNT_NAME_SIZE, ACCOUNT_NAME_VALID_CHAR);
-
-				// (matex) TODO: What for? We do not really need pszAccountNameCheck here do we?!
-				if (iAccountNameLen > 0)
-					pszAccountNameCheck[iAccountNameLen-1] = '\0';
-				if (iAccountNameLen != strlen(sRawAccountName))
-				{
-					iAccountNameLen = 0;
-					++i;
-
-					continue;
-				}
-
-				// set seed, clientversion, cryptmask
-				SetClientVerIndex(i);
-				SetCryptMask(tmp_CryptMaskHi, tmp_CryptMaskLo);
-				break;
-			}
+			i = uiRecentKeys[n];
+			if ( i >= uiKeys )
+				continue;
+		}
+		else
+		{
+			i = n - CRYPT_RECENT_KEYS;
+			if ( std::find(uiRecentKeys, uiRecentKeys + CRYPT_RECENT_KEYS, i) != (uiRecentKeys + CRYPT_RECENT_KEYS) )
+				continue;
 		}
 
-		// Next one
-		++i;
+		const int iResult = LoginCryptTryKey(i, tmp_CryptMaskHi, tmp_CryptMaskLo, pRaw.get(), pEvent, inLen);
+		if ( iResult < 0 )
+		{
+			g_Log.EventError("NET-IN: LoginCryptStart failed (decrypt).\n");
+			return false;
+		}
+		if ( iResult > 0 )
+		{
+			// set seed, clientversion, cryptmask
+			SetClientVerIndex(i);
+			SetCryptMask(tmp_CryptMaskHi, tmp_CryptMaskLo);
+			keys_holder->AddRecentLoginKey(i);
+			break;
+		}
 	}
 
 	m_fInit = true;
     return true;
 }
 
+int CCrypto::LoginCryptTryKey( uint uiKey, dword dwMaskHi, dword dwMaskLo, byte * pRaw, const byte * pEvent, uint inLen )
+{
+	ADDTOCALLSTACK("CCrypto::LoginCryptTryKey");
+	// Test if the login packet is decrypted correctly by this client key.
+	// Return: 1 = it is, 0 = it isn't, -1 = error.
+
+	SetCryptMask(dwMaskHi, dwMaskLo);
+	// Set client version properties
+	SetClientVerIndex(uiKey);
+
+	// The login encryption is a stream cipher: decrypt first the packet id and the account name, and the password only if they are valid.
+	//  With the wrong keys the account name is garbage, so this saves decrypting half of the packet for almost all the keys tried.
+	const uint uiNameEnd = minimum(inLen, 31u);
+	if ( !Decrypt(pRaw, pEvent, MAX_BUFFER, uiNameEnd) )
+		return -1;
+
+#ifdef DEBUG_CRYPT_MSGS
+	DEBUG_MSG(("LoginCrypt %u (%" PRIu32 ") type %" PRIx8 "-%" PRIx8 "\n", uiKey, GetClientVer(), pRaw[0], pEvent[0]));
+#endif
+	if ( pRaw[0] != 0x80 || pRaw[30] != 0x00 )
+		return 0;
+
+	// -----------------------------------------------------
+	// This is a sanity check, sometimes client keys (like 4.0.0) can intercept, incorrectly,
+	// a login packet. When is decrypted it is done not correctly (strange chars after
+	// regular account name/password). This prevents that fact, choosing the right keys
+	// to decrypt it correctly :)
+	// No official client allows the account name or password to
+	// exceed 20 chars (2d=16,kr=20), meaning that chars 21-30 must
+	// always be 0x00 (some unofficial clients may allow the user
+	// to enter more, but as they generally don't use encryption
+	// it shouldn't be a problem)
+	for (uint toCheck = 21; toCheck <= 30; ++toCheck)
+	{
+		if (pRaw[toCheck] != 0x00)
+			return 0;
+	}
+
+	char pszAccountNameCheck[MAX_ACCOUNT_NAME_SIZE];
+	lpctstr sRawAccountName = reinterpret_cast<lpctstr>(pRaw + 1);
+	const uint iAccountNameLen = (uint)Str_GetBare(pszAccountNameCheck, sRawAccountName, MAX_ACCOUNT_NAME_SIZE, ACCOUNT_NAME_VALID_CHAR);
+	if (iAccountNameLen != strlen(sRawAccountName))
+		return 0;
+
+	// Now the password.
+	if ( inLen > uiNameEnd )
+	{
+		if ( !Decrypt(pRaw + uiNameEnd, pEvent + uiNameEnd, MAX_BUFFER - uiNameEnd, inLen - uiNameEnd) )
+			return -1;
+	}
+	for (uint toCheck = 51; toCheck <= 60; ++toCheck)
+	{
+		if (pRaw[toCheck] != 0x00)
+			return 0;
+	}
+	return 1;
+}
+
 bool CCrypto::GameCryptStart( dword dwIP, const byte * pEvent, uint inLen )
 {
 	ADDTOCALLSTACK("CCrypto::GameCryptStart");
@@ -720,10 +782,17 @@ bool CCrypto::GameCryptStart( dword dwIP, const byte * pEvent, uint inLen )
 	SetConnectType( CONNECT_GAME );
 
 	bool bOut = false;
+	CCryptoKeysHolder* keys_holder = CCryptoKeysHolder::get();
 
-    // Auto-detect if the encryption is BFISH, BTFISH or TFISH
-	for ( uint i = ENC_NONE; i <= ENC_TFISH; ++i )
+    // Auto-detect if the encryption is BFISH, BTFISH or TFISH.
+	// Try first the one detected last time: initializing the ciphers for each type is the expensive part.
+	const int iRecentEnc = keys_holder->_iRecentGameEnc;
+	for ( int n = -1; n <= ENC_TFISH; ++n )
 	{
+		const int i = (n < 0) ? iRecentEnc : n;
+		if ( (n >= 0) && (i == iRecentEnc) )
+			continue;
+
 		SetEncryptionType( (ENCRYPTION_TYPE)i );
 		if ( GetEncryptionType() == ENC_TFISH || GetEncryptionType() == ENC_BTFISH )
 			InitTwoFish();
@@ -745,6 +814,7 @@ bool CCrypto::GameCryptStart( dword dwIP, const byte * pEvent, uint inLen )
             if ( pRaw[34] == 0x00 && pRaw[64] == 0x00)
             {
                 bOut = true;    // Ok the new detected encryption is ok (legit post-login packet: 0x91)
+				keys_holder->_iRecentGameEnc = i;
                 break;
             }
 		}
@@ -757,7 +827,6 @@ bool CCrypto::GameCryptStart( dword dwIP, const byte * pEvent, uint inLen )
         const dword tmp_CryptMaskHi = ((( m_seed) ^ 0x43210000) >> 16) | (((~m_seed) ^ 0xabcdffff) & 0xffff0000);
         SetClientVerIndex(0);
 
-		CCryptoKeysHolder* keys_holder = CCryptoKeysHolder::get();
         for (size_t i = 0;;)
         {
             if ( i >= keys_holder->client_keys.size() )
@@ -7,6 +7,7 @@
 #define _INC_CCRYPT_H
 
 #include "../common.h"
+#include <atomic>
 #include <vector>
 
 #define CLIENT_END 0x00000001
@@ -94,8 +95,18 @@ struct CCryptoKeysHolder
 
 	std::vector<CCryptoClientKey> client_keys;
 
+	// Keys which recently matched a login packet, tried first at the next logins (they can be accessed by many network threads).
+#define CRYPT_RECENT_KEYS	4
+	std::atomic<uint> _uiRecentLoginKeys[CRYPT_RECENT_KEYS];
+	std::atomic<uint> _uiRecentLoginKeysNext;
+	std::atomic<int> _iRecentGameEnc;	// last ENCRYPTION_TYPE detected for a game packet
+
+	CCryptoKeysHolder();
+
 	void LoadKeyTable(CScript& s);
 	void addNoCryptKey(void);
+	void AddRecentLoginKey(uint uiKey);
+	bool IsRecentLoginKey(uint uiKey) const;
 };
 
 struct CCrypto
@@ -222,6 +233,7 @@ public:
 	bool Encrypt( byte * pOutput, const byte * pInput, uint outLen, uint inLen );
 protected:
 	bool LoginCryptStart( dword dwIP, const  byte * pEvent, uint inLen );
+	int LoginCryptTryKey( uint uiKey, dword dwMaskHi, dword dwMaskLo, byte * pRaw, const byte * pEvent, uint inLen );
 	bool GameCryptStart( dword dwIP, const byte * pEvent, uint inLen );
 	bool RelayGameCryptStart( byte * pOutput, const byte * pInput, uint outLen, uint inLen );
    
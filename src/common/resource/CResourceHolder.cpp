@@ -145,14 +145,12 @@ CResourceScript * CResourceHolder::AddResourceFile( lpctstr pszName )
 	if ( pNewRes )
 		return pNewRes;
 
-	// Find correct path
-    pNewRes = new CResourceScript();
-    if (! OpenResourceFind(static_cast<CScript&>(*pNewRes), szName))
-    {
-        delete pNewRes;
+	// Find correct path. The file will be read later, when loading the resources.
+    CSString sPath;
+    if (! FindResourcePath(sPath, szName))
         return nullptr;
-    }
 
+    pNewRes = new CResourceScript(sPath);
     m_ResourceFiles.emplace_back(pNewRes);
     pNewRes->m_iResourceFileIndex = int(m_ResourceFiles.size() -1);
     return pNewRes;
@@ -271,6 +269,31 @@ bool CResourceHolder::OpenResourceFind( CScript &s, lpctstr pszFilename, bool fC
 	return s.Open( sPathName, OF_READ );
 }
 
+bool CResourceHolder::FindResourcePath( CSString &sPath, lpctstr pszFilename ) const
+{
+	ADDTOCALLSTACK("CResourceHolder::FindResourcePath");
+	// Like OpenResourceFind, but without opening (and reading) the file.
+
+	// search the local dir or full path first.
+	sPath = pszFilename;
+	if ( CSFile::FileExists(sPath) )
+		return true;
+
+	// next, check the script file path
+	sPath = CSFile::GetMergedFileName( m_sSCPBaseDir, pszFilename );
+	if ( CSFile::FileExists(sPath) )
+		return true;
+
+	// finally, strip the directory and re-check script file path
+	lpctstr pszTitle = CSFile::GetFilesTitle(pszFilename);
+	sPath = CSFile::GetMergedFileName( m_sSCPBaseDir, pszTitle );
+	if ( CSFile::FileExists(sPath) )
+		return true;
+
+	g_Log.Event(LOGL_WARN, "'%s' not found...\n", sPath.GetBuffer());
+	return false;
+}
+
 bool CResourceHolder::LoadResourceSection( CScript * pScript )
 {
 	ADDTOCALLSTACK("CResourceHolder::LoadResourceSection");
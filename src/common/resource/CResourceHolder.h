@@ -34,6 +34,7 @@ protected:
 protected:
 	CResourceScript * AddResourceFile( lpctstr pszName );
 	void AddResourceDir( lpctstr pszDirName );
+	bool FindResourcePath( CSString &sPath, lpctstr pszFilename ) const;
 
 public:
 	void LoadResourcesOpen( CScript * pScript );
@@ -50,7 +50,7 @@ public:
     int GetLinkOffset() const;
     void SetLink( CResourceScript * pScript );
     void CopyTransfer( CResourceLink * pLink );
-    void ScanSection( RES_TYPE restype );
+    virtual void ScanSection( RES_TYPE restype );
     void ClearTriggers();
     void SetTrigger( int i );
     bool HasTrigger( int i ) const;
@@ -59,6 +59,29 @@ void CResourceScript::ReSync()
     Close();
 }
 
+bool CResourceScript::Preload()
+{
+    ADDTOCALLSTACK("CResourceScript::Preload");
+    // Each file is preloaded by a single thread, while the main thread waits for all of them.
+    _fPreloadChanged = false;
+
+    const bool fFirstCheck = IsFirstCheck();
+    const bool fHadCache = HasCache();
+    if ( !CheckForChange() && !fFirstCheck && fHadCache )
+        return false;
+
+    // The date may change without changing the content (files copied again, version control checkouts...):
+    //  the content is read anyway, but the resources are loaded again only if it's different.
+    const ullong uiPrevHash = GetContentHash();
+    _fCacheToBeUpdated = true;
+    if ( !CScript::Open(nullptr, OF_READ|OF_SHARE_DENY_WRITE) )
+        return false;
+    CScript::Close();
+
+    _fPreloadChanged = (fFirstCheck || !fHadCache || (GetContentHash() != uiPrevHash));
+    return _fPreloadChanged;
+}
+
 bool CResourceScript::Open( lpctstr pszFilename, uint wFlags )
 {
     ADDTOCALLSTACK("CResourceScript::Open");
@@ -22,11 +22,14 @@ private:
     dword m_dwSize;			// Compare to see if this has changed.
     CSTime m_dateChange;	// real world time/date of last change.
 
+    bool _fPreloadChanged;  // Preload found new content, which has to be loaded by the main thread.
+
 private:
     void _Init()
     {
         m_iOpenCount = 0;
         m_dwSize = UINT32_MAX;			// Compare to see if this has changed.
+        _fPreloadChanged = false;
     }
 
 public:
@@ -55,6 +58,14 @@ public:
         return (m_dwSize == UINT32_MAX && !m_dateChange.IsTimeValid());
     }
     void ReSync();
+
+    // Read (again) the file in the cache if its size or date changed. Called by the script loading threads.
+    // RETURN: true = the content is new or different, the resources have to be loaded from it.
+    bool Preload();
+    bool IsPreloadChanged() const noexcept
+    {
+        return _fPreloadChanged;
+    }
     virtual bool Open( lpctstr pszFilename = nullptr, uint wFlags = OF_READ ) override;
     virtual void Close() override;
     virtual void CloseForce() override;
@@ -1,6 +1,7 @@
 #include "../../../game/chars/CChar.h"
 #include "../../../game/clients/CClient.h"
 #include "../../../game/CObjBase.h"
+#include "../../../sphere/Metrics.h"
 #include "../../../sphere/threads.h"
 #include "../../CException.h"
 #include "../../CExpression.h"
@@ -42,6 +43,7 @@ enum GUMPCTL_TYPE // controls we can put in a gump.
     GUMPCTL_PICINPIC, // x y gump spritex spritey width height
     GUMPCTL_RADIO, // 6 = x,y,gump1,gump2,starting state,id
     GUMPCTL_RESIZEPIC, // 5 = x,y,gumpback,sx,sy // can come first if multi page. put up some background gump
+    GUMPCTL_STATICLAYOUT, // 0 = Not a control: the layout doesn't change, build it only the first time the dialog is opened.
     GUMPCTL_TEXT, // 4 = x,y,color?,startstringindex // put some text here.
     GUMPCTL_TEXTENTRY,
     GUMPCTL_TEXTENTRYLIMITED,
@@ -89,6 +91,7 @@ lpctstr const CDialogDef::sm_szLoadKeys[GUMPCTL_QTY+1] =
     "PICINPIC",
     "RADIO",
     "RESIZEPIC",
+    "STATICLAYOUT",
     "TEXT",
     "TEXTENTRY",
     "TEXTENTRYLIMITED",
@@ -454,6 +457,9 @@ bool CDialogDef::r_Verb( CScript & s, CTextConsole * pSrc )	// some command on t
         case GUMPCTL_NODISPOSE:
             m_fNoDispose = true;
             break;
+        case GUMPCTL_STATICLAYOUT:
+            m_fStaticLayout = true;
+            return true;
         case GUMPCTL_CROPPEDTEXT:
         case GUMPCTL_TEXT:
         case GUMPCTL_TEXTENTRY:
@@ -528,6 +534,15 @@ CDialogDef::CDialogDef( CResourceID rid ) :
     m_iOriginY = 0;
     m_wPage = 0;
     m_fNoDispose = false;
+    m_fStaticLayout = false;
+}
+
+void CDialogDef::ClearCompiledLayout()
+{
+    ADDTOCALLSTACK("CDialogDef::ClearCompiledLayout");
+    m_CompiledLayout.m_fValid = false;
+    m_CompiledLayout.m_vecControls.clear();
+    m_CompiledLayout.m_vecTexts.clear();
 }
 
 
@@ -562,6 +577,7 @@ bool CDialogDef::GumpSetup( int iPage, CClient * pClient, CObjBase * pObjSrc, lp
     m_iOriginY		= 0;
     m_wPage			= (word)(iPage);
     m_fNoDispose	= false;
+    m_fStaticLayout	= false;
 
     CScriptTriggerArgs	Args(iPage, 0, pObjSrc);
     //DEBUG_ERR(("Args.m_s1_buf_vec %s  Args.m_s1 %s  Arguments 0x%x\n",Args.m_s1_buf_vec, Args.m_s1, Arguments));
@@ -584,6 +600,27 @@ bool CDialogDef::GumpSetup( int iPage, CClient * pClient, CObjBase * pObjSrc, lp
         // no gump text?
     }
 
+    if ( m_CompiledLayout.m_fValid && (m_CompiledLayout.m_wPage == m_wPage) && (m_CompiledLayout.m_uiSectionTexts == m_uiTexts) )
+    {
+        // Static layout: don't run the main dialog, the controls are always the same.
+        m_x = m_CompiledLayout.m_x;
+        m_y = m_CompiledLayout.m_y;
+        m_fNoDispose = m_CompiledLayout.m_fNoDispose;
+        for ( const CSString& sControl : m_CompiledLayout.m_vecControls )
+        {
+            m_sControls[m_uiControls] = sControl;
+            ++m_uiControls;
+        }
+        for ( const CSString& sText : m_CompiledLayout.m_vecTexts )
+        {
+            m_sText[m_uiTexts] = sText;
+            ++m_uiTexts;
+        }
+        g_Metrics.Add(METRIC_GUMP_LAYOUT_HITS);
+        return true;
+    }
+    const uint uiSectionTexts = m_uiTexts;
+
     // read the main dialog
     if ( !ResourceLock( s ) )
         return false;
@@ -601,5 +638,18 @@ bool CDialogDef::GumpSetup( int iPage, CClient * pClient, CObjBase * pObjSrc, lp
 
     if ( OnTriggerRunVal( s, TRIGRUN_SECTION_TRUE, pClient->GetChar(), &Args ) == TRIGRET_RET_TRUE )
         return false;
+
+    if ( m_fStaticLayout )
+    {
+        m_CompiledLayout.m_fValid = true;
+        m_CompiledLayout.m_wPage = m_wPage;
+        m_CompiledLayout.m_x = m_x;
+        m_CompiledLayout.m_y = m_y;
+        m_CompiledLayout.m_fNoDispose = m_fNoDispose;
+        m_CompiledLayout.m_uiSectionTexts = uiSectionTexts;
+        m_CompiledLayout.m_vecControls.assign(m_sControls, m_sControls + m_uiControls);
+        m_CompiledLayout.m_vecTexts.assign(m_sText + uiSectionTexts, m_sText + m_uiTexts);
+        g_Metrics.Add(METRIC_GUMP_LAYOUT_MISSES);
+    }
     return true;
 }
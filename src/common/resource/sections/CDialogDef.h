@@ -8,10 +8,45 @@
 
 #include "../../sphere_library/CSString.h"
 #include "../CResourceLink.h"
+#include <vector>
 
 class CClient;
 
 
+// The dialogs are built again by their script each time they are opened, but most of them send the same layout
+//  (and often the same texts) every time: the compressed parts of the last gump sent are kept, to reuse them.
+struct CDialogCompressedPart
+{
+    std::vector<byte> m_vecSource;      // uncompressed data
+    std::vector<byte> m_vecCompressed;
+};
+
+struct CDialogPacketCache
+{
+    CDialogCompressedPart m_Layout;
+    CDialogCompressedPart m_Texts;
+};
+
+// Layout of a dialog containing the 'staticlayout' keyword, as built by its script the first time it was opened.
+//  The next times only the TEXT section is evaluated again, the controls and the texts added by the layout are copied from here.
+struct CDialogCompiledLayout
+{
+    bool        m_fValid;
+    word        m_wPage;            // page the layout was built for
+    int         m_x;
+    int         m_y;
+    bool        m_fNoDispose;
+    uint        m_uiSectionTexts;   // texts read from the TEXT section, before the ones added by the layout
+    std::vector<CSString> m_vecControls;
+    std::vector<CSString> m_vecTexts;   // texts added by the layout (dtext, dhtmlgump...)
+
+    CDialogCompiledLayout() :
+        m_fValid(false), m_wPage(0), m_x(0), m_y(0), m_fNoDispose(false), m_uiSectionTexts(0)
+    {
+    }
+};
+
+
 class CDialogDef : public CResourceLink
 {
     static lpctstr const sm_szLoadKeys[];
@@ -20,6 +55,7 @@ public:
     static const char *m_sClassName;
     bool GumpSetup( int iPage, CClient * pClientSrc, CObjBase * pObj, lpctstr Arguments = "" );
     uint GumpAddText( lpctstr pszText );		// add text to the text section, return insertion index
+    void ClearCompiledLayout();
     virtual bool r_Verb( CScript &s, CTextConsole * pSrc ) override;
     virtual bool r_LoadVal( CScript & s ) override;
     virtual bool r_WriteVal( lpctstr ptcKey, CSString &sVal, CTextConsole * pSrc = nullptr, bool fNoCallParent = false, bool fNoCallChildren = false) override;
@@ -47,6 +83,10 @@ public:
     word		m_wPage;		// page to open the dialog in
 
     bool		m_fNoDispose;	// contains 'nodispose' control
+    bool		m_fStaticLayout;	// contains 'staticlayout' keyword
+
+    CDialogCompiledLayout m_CompiledLayout;	// valid only for the dialogs with a static layout
+    CDialogPacketCache m_PacketCache;	// compressed parts of the last gump sent
 };
 
 #endif // _INC_CDIALOGDEF_H
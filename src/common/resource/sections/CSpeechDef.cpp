@@ -0,0 +1,230 @@
+#include "../../sphere_library/sstring.h"
+#include "../../CException.h"
+#include "../CResourceLock.h"
+#include "CSpeechDef.h"
+#include <queue>
+
+
+static inline tchar SpeechLower(tchar ch) noexcept
+{
+    // Same case folding done by Str_Match.
+    return static_cast<tchar>(tolower(ch));
+}
+
+static void SpeechGetLongestLiteral(lpctstr ptcPattern, CSString & sFragment)
+{
+    // Get the longest run of plain characters of a Str_Match pattern: if the pattern matches a text,
+    //  the text has to contain it.
+    size_t uiBestStart = 0, uiBestLen = 0;
+    size_t uiRunStart = 0;
+    size_t i = 0;
+    for (;;)
+    {
+        const tchar ch = ptcPattern[i];
+        if ((ch == '\0') || (ch == '*') || (ch == '?') || (ch == '['))
+        {
+            if (i - uiRunStart > uiBestLen)
+            {
+                uiBestStart = uiRunStart;
+                uiBestLen = i - uiRunStart;
+            }
+            if (ch == '\0')
+                break;
+            if (ch == '[')
+            {
+                // Skip the whole [..] construct.
+                ++i;
+                while ((ptcPattern[i] != '\0') && (ptcPattern[i] != ']'))
+                {
+                    if ((ptcPattern[i] == '\\') && (ptcPattern[i + 1] != '\0'))
+                        ++i;
+                    ++i;
+                }
+                if (ptcPattern[i] == '\0')
+                {
+                    // Malformed pattern: it will never match, but let Str_Match decide it.
+                    uiRunStart = i;
+                    continue;
+                }
+            }
+            uiRunStart = i + 1;
+        }
+        ++i;
+    }
+
+    sFragment.CopyLen(ptcPattern + uiBestStart, int(uiBestLen));
+}
+
+
+CSpeechDef::CSpeechDef(CResourceID rid) :
+    CResourceLink(rid), _fCompiled(false)
+{
+}
+
+void CSpeechDef::ScanSection(RES_TYPE restype)
+{
+    ADDTOCALLSTACK("CSpeechDef::ScanSection");
+    CResourceLink::ScanSection(restype);
+
+    // The section may have been changed (resync): compile it again when needed.
+    _fCompiled = false;
+    _vecPatterns.clear();
+    _vecBlocks.clear();
+    _vecAlwaysCheck.clear();
+    _vecNodes.clear();
+}
+
+uint CSpeechDef::_ACGoto(uint uiNode, tchar ch) const noexcept
+{
+    for (const std::pair<tchar, uint>& edge : _vecNodes[uiNode].vecEdges)
+    {
+        if (edge.first == ch)
+            return edge.second;
+    }
+    return UINT32_MAX;
+}
+
+void CSpeechDef::_ACAddFragment(lpctstr ptcFragment, uint uiPattern)
+{
+    uint uiNode = 0;
+    for (; *ptcFragment != '\0'; ++ptcFragment)
+    {
+        const tchar ch = SpeechLower(*ptcFragment);
+        uint uiNext = _ACGoto(uiNode, ch);
+        if (uiNext == UINT32_MAX)
+        {
+            uiNext = uint(_vecNodes.size());
+            _vecNodes[uiNode].vecEdges.emplace_back(ch, uiNext);
+            _vecNodes.emplace_back(ACNode{ {}, {}, 0, 0 });
+        }
+        uiNode = uiNext;
+    }
+    _vecNodes[uiNode].vecPatterns.emplace_back(uiPattern);
+}
+
+void CSpeechDef::_ACBuildLinks()
+{
+    // Breadth-first visit: the fail links of a node are always built before the ones of its children.
+    std::queue<uint> queNodes;
+    for (const std::pair<tchar, uint>& edge : _vecNodes[0].vecEdges)
+        queNodes.push(edge.second);
+
+    while (!queNodes.empty())
+    {
+        const uint uiNode = queNodes.front();
+        queNodes.pop();
+
+        for (const std::pair<tchar, uint>& edge : _vecNodes[uiNode].vecEdges)
+        {
+            uint uiFail = _vecNodes[uiNode].uiFail;
+            uint uiNext;
+            while (((uiNext = _ACGoto(uiFail, edge.first)) == UINT32_MAX) && (uiFail != 0))
+                uiFail = _vecNodes[uiFail].uiFail;
+
+            ACNode& child = _vecNodes[edge.second];
+            child.uiFail = (uiNext == UINT32_MAX) ? 0 : uiNext;
+            const ACNode& fail = _vecNodes[child.uiFail];
+            child.uiOutput = fail.vecPatterns.empty() ? fail.uiOutput : child.uiFail;
+            queNodes.push(edge.second);
+        }
+    }
+}
+
+void CSpeechDef::Compile(CResourceLock & s)
+{
+    ADDTOCALLSTACK("CSpeechDef::Compile");
+    // Replicate the ON= handling of CObjBase::OnHearTrigger: consecutive ON= lines share the code following them.
+
+    _vecPatterns.clear();
+    _vecBlocks.clear();
+    _vecAlwaysCheck.clear();
+    _vecNodes.clear();
+    _vecNodes.emplace_back(ACNode{ {}, {}, 0, 0 });
+
+    size_t uiBlockPatternsStart = 0;
+    bool fPendingBlock = false;
+    for (;;)
+    {
+        const CScriptLineContext ctxLine = s.GetContext();
+        if (!s.ReadKeyParse())
+            break;
+
+        if (s.IsKeyHead("ON", 2))
+        {
+            if (!fPendingBlock)
+            {
+                fPendingBlock = true;
+                uiBlockPatternsStart = _vecPatterns.size();
+            }
+            _vecPatterns.push_back(SpeechPattern{ CSString(s.GetArgStr()), uint(_vecBlocks.size()) });
+            continue;
+        }
+
+        if (fPendingBlock)
+        {
+            // First line of code after the ON= lines.
+            fPendingBlock = false;
+            _vecBlocks.push_back(SpeechBlock{ ctxLine });
+        }
+    }
+
+    if (fPendingBlock)
+    {
+        // ON= lines at the end of the section, without code: they can't do anything.
+        _vecPatterns.resize(uiBlockPatternsStart);
+    }
+
+    CSString sFragment;
+    for (uint i = 0; i < uint(_vecPatterns.size()); ++i)
+    {
+        SpeechGetLongestLiteral(_vecPatterns[i].sPattern.GetBuffer(), sFragment);
+        if (sFragment.IsEmpty())
+            _vecAlwaysCheck.emplace_back(i);
+        else
+            _ACAddFragment(sFragment.GetBuffer(), i);
+    }
+    _ACBuildLinks();
+
+    _fCompiled = true;
+}
+
+bool CSpeechDef::GetFirstMatchingBlock(lpctstr ptcText, CScriptLineContext & ctxBody) const
+{
+    ADDTOCALLSTACK("CSpeechDef::GetFirstMatchingBlock");
+    ASSERT(_fCompiled);
+    if (_vecBlocks.empty())
+        return false;
+
+    // Step 1: run the automaton on the text, to find the patterns whose literal fragment is in the text.
+    std::vector<bool> vecCandidates(_vecPatterns.size(), false);
+    for (uint uiPattern : _vecAlwaysCheck)
+        vecCandidates[uiPattern] = true;
+
+    uint uiNode = 0;
+    for (lpctstr ptc = ptcText; *ptc != '\0'; ++ptc)
+    {
+        const tchar ch = SpeechLower(*ptc);
+        uint uiNext;
+        while (((uiNext = _ACGoto(uiNode, ch)) == UINT32_MAX) && (uiNode != 0))
+            uiNode = _vecNodes[uiNode].uiFail;
+        uiNode = (uiNext == UINT32_MAX) ? 0 : uiNext;
+
+        for (uint uiOut = _vecNodes[uiNode].vecPatterns.empty() ? _vecNodes[uiNode].uiOutput : uiNode; uiOut != 0; uiOut = _vecNodes[uiOut].uiOutput)
+        {
+            for (uint uiPattern : _vecNodes[uiOut].vecPatterns)
+                vecCandidates[uiPattern] = true;
+        }
+    }
+
+    // Step 2: check the candidates with the full pattern, in script order.
+    for (uint i = 0; i < uint(_vecPatterns.size()); ++i)
+    {
+        const SpeechPattern& pattern = _vecPatterns[i];
+        if (vecCandidates[i] && (Str_Match(pattern.sPattern.GetBuffer(), ptcText) == MATCH_VALID))
+        {
+            ctxBody = _vecBlocks[pattern.uiBlock].ctxBody;
+            return true;
+        }
+    }
+    return false;
+}
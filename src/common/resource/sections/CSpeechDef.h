@@ -0,0 +1,87 @@
+/**
+* @file CSpeechDef.h
+*
+*/
+
+#ifndef _INC_CSPEECHDEF_H
+#define _INC_CSPEECHDEF_H
+
+#include "../../sphere_library/CSString.h"
+#include "../CResourceLink.h"
+#include <vector>
+
+
+/**
+* @class   CSpeechDef
+*
+* @brief   RES_SPEECH. A speech block with ON=*blah* in it.
+*          On first use the ON= patterns are compiled in an Aho-Corasick automaton built on the longest literal
+*          fragment of each pattern, so that a single pass over the heard text tells which ON= blocks may match.
+*          Only those are then checked with Str_Match, and the script is read only if at least one of them matches.
+*/
+class CSpeechDef : public CResourceLink
+{
+    struct SpeechPattern
+    {
+        CSString sPattern;      // The ON= argument, as written in the script.
+        uint uiBlock;           // Index of the block this pattern belongs to.
+    };
+
+    struct SpeechBlock
+    {
+        CScriptLineContext ctxBody; // Where the code executed for the ON= lines of this block starts.
+    };
+
+    struct ACNode
+    {
+        std::vector<std::pair<tchar, uint>> vecEdges;
+        std::vector<uint> vecPatterns;  // Patterns whose literal fragment ends in this node.
+        uint uiFail;                    // Node of the longest proper suffix of this node's string.
+        uint uiOutput;                  // Nearest node in the fail chain having some patterns, or 0.
+    };
+
+    bool _fCompiled;
+    std::vector<SpeechPattern> _vecPatterns;
+    std::vector<SpeechBlock> _vecBlocks;
+    std::vector<uint> _vecAlwaysCheck;  // Patterns without literal fragments, which have to be always checked.
+    std::vector<ACNode> _vecNodes;      // Node 0 is the root.
+
+private:
+    uint _ACGoto(uint uiNode, tchar ch) const noexcept;
+    void _ACAddFragment(lpctstr ptcFragment, uint uiPattern);
+    void _ACBuildLinks();
+
+public:
+    static const char *m_sClassName;
+    explicit CSpeechDef(CResourceID rid);
+    virtual ~CSpeechDef() = default;
+
+private:
+    CSpeechDef(const CSpeechDef& copy);
+    CSpeechDef& operator=(const CSpeechDef& other);
+
+public:
+    virtual void ScanSection(RES_TYPE restype) override;
+
+    inline bool IsCompiled() const noexcept
+    {
+        return _fCompiled;
+    }
+
+    /**
+    * @brief   Build the matcher reading the ON= lines from the (already locked) section.
+    * @param   s   The locked script, positioned at the start of the section.
+    */
+    void Compile(CResourceLock & s);
+
+    /**
+    * @brief   Get where the code of the first block having an ON= pattern matching the text starts.
+    *          If its code returns 0, the rest of the section is checked line by line from where it stopped, as it always was.
+    * @param   ptcText     The heard text.
+    * @param   ctxBody     The context of the matching block.
+    * @return  false if no block matches.
+    */
+    bool GetFirstMatchingBlock(lpctstr ptcText, CScriptLineContext & ctxBody) const;
+};
+
+#endif // _INC_CSPEECHDEF_H
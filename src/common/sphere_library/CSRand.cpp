@@ -6,10 +6,20 @@
 #include <random>
 #include "CSRand.h"
 
+static bool sm_fSeeded = false;
+static std::mt19937_64 sm_SeededEngine;
+
+void CSRand::setSeed(uint64 seed)
+{
+	sm_SeededEngine.seed(seed);
+	sm_fSeeded = true;
+}
 
 int32 CSRand::genRandInt32(int32 min, int32 max)
 {
 	std::uniform_int_distribution<int32> distr(min, max);
+	if (sm_fSeeded)
+		return distr(sm_SeededEngine);
 	std::random_device rd;				// Use random_device to get a random seed (we can use also system time).
 	std::mt19937 rand_engine(rd());
 	return distr(rand_engine);
@@ -18,6 +28,8 @@ int32 CSRand::genRandInt32(int32 min, int32 max)
 int64 CSRand::genRandInt64(int64 min, int64 max)
 {
 	std::uniform_int_distribution<int64> distr(min, max);
+	if (sm_fSeeded)
+		return distr(sm_SeededEngine);
 	std::random_device rd;
 	std::mt19937_64 rand_engine(rd());
 	return distr(rand_engine);
@@ -34,6 +46,8 @@ int64 CSRand::genRandInt64(int64 min, int64 max)
 realtype CSRand::genRandReal64(realtype min, realtype max)
 {
 	std::uniform_real_distribution<realtype> distr(min, max);
+	if (sm_fSeeded)
+		return distr(sm_SeededEngine);
 	std::random_device rd;
 	std::mt19937_64 rand_engine(rd());
 	return distr(rand_engine);
@@ -16,6 +16,10 @@ public:
 	static	int64 genRandInt64(int64 min, int64 max);
 	//static	float genRandReal32(float min, float max);		// floating point number
 	static	realtype genRandReal64(realtype min, realtype max);
+
+	// Use a single engine with this seed from now on, so that the same sequence is generated run to run (benchmark mode).
+	// Not thread safe: only the main thread should generate numbers then.
+	static	void setSeed(uint64 seed);
 };
 
 #endif // !_INC_CSRAND_H
\ No newline at end of file
@@ -24,6 +24,364 @@
 #endif
 
 
+// String utilities: SIMD helpers
+
+// Vectorized scanning kernels used by the hot string functions below (Str_CmpHeadI, FindStrWord, Str_Match,
+//  Str_Parse, Str_TrimWhitespace). Each kernel has an SSE2, an AVX2 and a scalar variant: the best one is picked at runtime.
+// Case folding is plain ASCII, like tolower/toupper with the "C" locale (we never call setlocale).
+// Vector loads may read past the string terminator, but never across a page boundary (checked by Str_Simd_CanLoad),
+//  so they can't fault; we only tell the address sanitizer to not complain about it.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define SSTRING_SIMD_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define SSTRING_TARGET_AVX2
+    #else
+        #define SSTRING_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+enum class StrSimdLevel : int
+{
+    None = 0,   // Must be 0: used by statically initialized code running before g_StrSimdLevel is set.
+    SSE2,
+    AVX2
+};
+
+static StrSimdLevel Str_Simd_DetectLevel() noexcept
+{
+#ifndef SSTRING_SIMD_X86
+    return StrSimdLevel::None;
+#elif defined(_MSC_VER)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] >= 7)
+    {
+        __cpuid(cpuInfo, 1);
+        const bool fOSXSave = (cpuInfo[2] & (1 << 27)) != 0;
+        const bool fAVX     = (cpuInfo[2] & (1 << 28)) != 0;
+        if (fOSXSave && fAVX && ((_xgetbv(0) & 0x6) == 0x6))
+        {
+            __cpuidex(cpuInfo, 7, 0);
+            if (cpuInfo[1] & (1 << 5))
+                return StrSimdLevel::AVX2;
+        }
+    }
+    return StrSimdLevel::SSE2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return StrSimdLevel::AVX2;
+    return StrSimdLevel::SSE2;
+#endif
+}
+
+static const StrSimdLevel g_StrSimdLevel = Str_Simd_DetectLevel();
+
+static inline tchar Str_Simd_AsciiLower(tchar ch) noexcept
+{
+    return ((ch >= 'A') && (ch <= 'Z')) ? tchar(ch + ('a' - 'A')) : ch;
+}
+
+static inline bool Str_Simd_IsLeadWhitespace(tchar ch) noexcept
+{
+    // Same as IsWhitespace(ch) with the "C" locale.
+    const uchar uch = static_cast<uchar>(ch);
+    return (uch == ' ') || (uch == 0xA0) || ((uch >= '\t') && (uch <= '\r'));
+}
+
+#ifdef SSTRING_SIMD_X86
+
+static inline bool Str_Simd_CanLoad(const void* ptr, size_t uiWidth) noexcept
+{
+    // Can we read uiWidth bytes starting from ptr without crossing a (4 kB, the smallest possible) memory page boundary?
+    return ((reinterpret_cast<uintptr_t>(ptr) & 4095) <= (4096 - uiWidth));
+}
+
+static inline uint Str_Simd_FirstBit(uint uiMask) noexcept
+{
+#ifdef _MSC_VER
+    unsigned long ulIndex;
+    _BitScanForward(&ulIndex, uiMask);
+    return uint(ulIndex);
+#else
+    return uint(__builtin_ctz(uiMask));
+#endif
+}
+
+// -- SSE2 kernels
+
+static inline __m128i Str_Simd_ToLower_SSE2(__m128i vec) noexcept
+{
+    // (ch - 'A') < 26, as an unsigned comparison done with signed instructions.
+    const __m128i vShifted = _mm_sub_epi8(vec, _mm_set1_epi8(char('A' + 128)));
+    const __m128i vIsUpper = _mm_cmplt_epi8(vShifted, _mm_set1_epi8(char(-128 + 26)));
+    return _mm_add_epi8(vec, _mm_and_si128(vIsUpper, _mm_set1_epi8(0x20)));
+}
+
+static inline __m128i Str_Simd_IsWhitespace_SSE2(__m128i vec) noexcept
+{
+    const __m128i vShifted = _mm_sub_epi8(vec, _mm_set1_epi8(char('\t' + 128)));
+    const __m128i vIsCtrl  = _mm_cmplt_epi8(vShifted, _mm_set1_epi8(char(-128 + ('\r' - '\t' + 1))));
+    const __m128i vIsSpace = _mm_or_si128(_mm_cmpeq_epi8(vec, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(vec, _mm_set1_epi8(char(0xA0))));
+    return _mm_or_si128(vIsCtrl, vIsSpace);
+}
+
+NO_SANITIZE_ADDRESS
+static size_t Str_Simd_CmpPrefixI_SSE2(lpctstr ptcA, lpctstr ptcB) noexcept
+{
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcA + i, 16) && Str_Simd_CanLoad(ptcB + i, 16))
+        {
+            const __m128i vA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptcA + i));
+            const __m128i vB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptcB + i));
+            const __m128i vEq = _mm_cmpeq_epi8(Str_Simd_ToLower_SSE2(vA), Str_Simd_ToLower_SSE2(vB));
+            const __m128i vBZero = _mm_cmpeq_epi8(vB, _mm_setzero_si128());
+            const uint uiMask = uint(_mm_movemask_epi8(_mm_andnot_si128(vBZero, vEq))) ^ 0xFFFF;
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 16;
+        }
+        else
+        {
+            if ((ptcB[i] == '\0') || (Str_Simd_AsciiLower(ptcA[i]) != Str_Simd_AsciiLower(ptcB[i])))
+                return i;
+            ++i;
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS
+static size_t Str_Simd_FindCharI_SSE2(lpctstr ptcStr, tchar chLower) noexcept
+{
+    const __m128i vCh = _mm_set1_epi8(chLower);
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcStr + i, 16))
+        {
+            const __m128i vStr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptcStr + i));
+            const __m128i vHit = _mm_or_si128(_mm_cmpeq_epi8(Str_Simd_ToLower_SSE2(vStr), vCh), _mm_cmpeq_epi8(vStr, _mm_setzero_si128()));
+            const uint uiMask = uint(_mm_movemask_epi8(vHit));
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 16;
+        }
+        else
+        {
+            if ((ptcStr[i] == '\0') || (Str_Simd_AsciiLower(ptcStr[i]) == chLower))
+                return i;
+            ++i;
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS
+static size_t Str_Simd_FindFirstOf_SSE2(lpctstr ptcStr, lpctstr ptcSet, size_t uiSetLen) noexcept
+{
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcStr + i, 16))
+        {
+            const __m128i vStr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptcStr + i));
+            __m128i vHit = _mm_cmpeq_epi8(vStr, _mm_setzero_si128());
+            for (size_t j = 0; j < uiSetLen; ++j)
+                vHit = _mm_or_si128(vHit, _mm_cmpeq_epi8(vStr, _mm_set1_epi8(ptcSet[j])));
+            const uint uiMask = uint(_mm_movemask_epi8(vHit));
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 16;
+        }
+        else
+        {
+            if ((ptcStr[i] == '\0') || memchr(ptcSet, ptcStr[i], uiSetLen))
+                return i;
+            ++i;
+        }
+    }
+}
+
+NO_SANITIZE_ADDRESS
+static size_t Str_Simd_SkipWhitespace_SSE2(lpctstr ptcStr) noexcept
+{
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcStr + i, 16))
+        {
+            const __m128i vStr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptcStr + i));
+            const uint uiMask = uint(_mm_movemask_epi8(Str_Simd_IsWhitespace_SSE2(vStr))) ^ 0xFFFF;
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 16;
+        }
+        else
+        {
+            if (!Str_Simd_IsLeadWhitespace(ptcStr[i]))
+                return i;
+            ++i;
+        }
+    }
+}
+
+// -- AVX2 kernels
+
+SSTRING_TARGET_AVX2
+static inline __m256i Str_Simd_ToLower_AVX2(__m256i vec) noexcept
+{
+    const __m256i vShifted = _mm256_sub_epi8(vec, _mm256_set1_epi8(char('A' + 128)));
+    const __m256i vIsUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(-128 + 26)), vShifted);
+    return _mm256_add_epi8(vec, _mm256_and_si256(vIsUpper, _mm256_set1_epi8(0x20)));
+}
+
+SSTRING_TARGET_AVX2 NO_SANITIZE_ADDRESS
+static size_t Str_Simd_CmpPrefixI_AVX2(lpctstr ptcA, lpctstr ptcB) noexcept
+{
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcA + i, 32) && Str_Simd_CanLoad(ptcB + i, 32))
+        {
+            const __m256i vA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptcA + i));
+            const __m256i vB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptcB + i));
+            const __m256i vEq = _mm256_cmpeq_epi8(Str_Simd_ToLower_AVX2(vA), Str_Simd_ToLower_AVX2(vB));
+            const __m256i vBZero = _mm256_cmpeq_epi8(vB, _mm256_setzero_si256());
+            const uint uiMask = ~uint(_mm256_movemask_epi8(_mm256_andnot_si256(vBZero, vEq)));
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 32;
+        }
+        else
+        {
+            if ((ptcB[i] == '\0') || (Str_Simd_AsciiLower(ptcA[i]) != Str_Simd_AsciiLower(ptcB[i])))
+                return i;
+            ++i;
+        }
+    }
+}
+
+SSTRING_TARGET_AVX2 NO_SANITIZE_ADDRESS
+static size_t Str_Simd_FindCharI_AVX2(lpctstr ptcStr, tchar chLower) noexcept
+{
+    const __m256i vCh = _mm256_set1_epi8(chLower);
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcStr + i, 32))
+        {
+            const __m256i vStr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptcStr + i));
+            const __m256i vHit = _mm256_or_si256(_mm256_cmpeq_epi8(Str_Simd_ToLower_AVX2(vStr), vCh), _mm256_cmpeq_epi8(vStr, _mm256_setzero_si256()));
+            const uint uiMask = uint(_mm256_movemask_epi8(vHit));
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 32;
+        }
+        else
+        {
+            if ((ptcStr[i] == '\0') || (Str_Simd_AsciiLower(ptcStr[i]) == chLower))
+                return i;
+            ++i;
+        }
+    }
+}
+
+SSTRING_TARGET_AVX2 NO_SANITIZE_ADDRESS
+static size_t Str_Simd_FindFirstOf_AVX2(lpctstr ptcStr, lpctstr ptcSet, size_t uiSetLen) noexcept
+{
+    size_t i = 0;
+    for (;;)
+    {
+        if (Str_Simd_CanLoad(ptcStr + i, 32))
+        {
+            const __m256i vStr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptcStr + i));
+            __m256i vHit = _mm256_cmpeq_epi8(vStr, _mm256_setzero_si256());
+            for (size_t j = 0; j < uiSetLen; ++j)
+                vHit = _mm256_or_si256(vHit, _mm256_cmpeq_epi8(vStr, _mm256_set1_epi8(ptcSet[j])));
+            const uint uiMask = uint(_mm256_movemask_epi8(vHit));
+            if (uiMask)
+                return i + Str_Simd_FirstBit(uiMask);
+            i += 32;
+        }
+        else
+        {
+            if ((ptcStr[i] == '\0') || memchr(ptcSet, ptcStr[i], uiSetLen))
+                return i;
+            ++i;
+        }
+    }
+}
+
+#endif // SSTRING_SIMD_X86
+
+// -- Dispatchers
+
+// Index of the first character where the two strings differ (case insensitive), or where ptcB ends.
+static inline size_t Str_Simd_CmpPrefixI(lpctstr ptcA, lpctstr ptcB) noexcept
+{
+#ifdef SSTRING_SIMD_X86
+    if (g_StrSimdLevel == StrSimdLevel::AVX2)
+        return Str_Simd_CmpPrefixI_AVX2(ptcA, ptcB);
+    if (g_StrSimdLevel == StrSimdLevel::SSE2)
+        return Str_Simd_CmpPrefixI_SSE2(ptcA, ptcB);
+#endif
+    size_t i = 0;
+    while ((ptcB[i] != '\0') && (Str_Simd_AsciiLower(ptcA[i]) == Str_Simd_AsciiLower(ptcB[i])))
+        ++i;
+    return i;
+}
+
+// Index of the first character equal (case insensitive) to chLower (which has to be already lowercase), or of the string terminator.
+static inline size_t Str_Simd_FindCharI(lpctstr ptcStr, tchar chLower) noexcept
+{
+#ifdef SSTRING_SIMD_X86
+    if (g_StrSimdLevel == StrSimdLevel::AVX2)
+        return Str_Simd_FindCharI_AVX2(ptcStr, chLower);
+    if (g_StrSimdLevel == StrSimdLevel::SSE2)
+        return Str_Simd_FindCharI_SSE2(ptcStr, chLower);
+#endif
+    size_t i = 0;
+    while ((ptcStr[i] != '\0') && (Str_Simd_AsciiLower(ptcStr[i]) != chLower))
+        ++i;
+    return i;
+}
+
+// Index of the first character contained in ptcSet (whose length is uiSetLen), or of the string terminator.
+static inline size_t Str_Simd_FindFirstOf(lpctstr ptcStr, lpctstr ptcSet, size_t uiSetLen) noexcept
+{
+#ifdef SSTRING_SIMD_X86
+    if (g_StrSimdLevel == StrSimdLevel::AVX2)
+        return Str_Simd_FindFirstOf_AVX2(ptcStr, ptcSet, uiSetLen);
+    if (g_StrSimdLevel == StrSimdLevel::SSE2)
+        return Str_Simd_FindFirstOf_SSE2(ptcStr, ptcSet, uiSetLen);
+#endif
+    size_t i = 0;
+    while ((ptcStr[i] != '\0') && !memchr(ptcSet, ptcStr[i], uiSetLen))
+        ++i;
+    return i;
+}
+
+// Index of the first non-whitespace character (see IsWhitespace).
+static inline size_t Str_Simd_SkipWhitespace(lpctstr ptcStr) noexcept
+{
+    // Usually there are only few leading whitespaces: check the first char before going wide.
+    if (!Str_Simd_IsLeadWhitespace(ptcStr[0]))
+        return 0;
+#ifdef SSTRING_SIMD_X86
+    if (g_StrSimdLevel != StrSimdLevel::None)
+        return Str_Simd_SkipWhitespace_SSE2(ptcStr);
+#endif
+    size_t i = 1;
+    while (Str_Simd_IsLeadWhitespace(ptcStr[i]))
+        ++i;
+    return i;
+}
+
+
 // String utilities: Converters
 
 #ifndef _WIN32
@@ -268,6 +626,11 @@ size_t FindStrWord( lpctstr pTextSearch, lpctstr pszKeyWord )
     size_t j = 0;
     for ( size_t i = 0; ; ++i )
     {
+        if ( j == 0 && pszKeyWord[0] != '\0' && pszKeyWord[0] != ',' )
+        {
+            // Jump straight to the next char that can start a match (or to the end of the text).
+            i += Str_Simd_FindCharI(pTextSearch + i, Str_Simd_AsciiLower(pszKeyWord[0]));
+        }
         if ( pszKeyWord[j] == '\0' || pszKeyWord[j] == ',')
         {
             if ( pTextSearch[i]== '\0' || IsWhitespace(pTextSearch[i]))
@@ -300,7 +663,8 @@ size_t FindStrWord( lpctstr pTextSearch, lpctstr pszKeyWord )
 
 int Str_CmpHeadI(lpctstr ptcFind, lpctstr ptcHere)
 {
-    for (uint i = 0; ; ++i)
+    // Skip the common (case insensitive) prefix, then do the real check on the first differing char.
+    for (size_t i = Str_Simd_CmpPrefixI(ptcFind, ptcHere); ; ++i)
     {
 		//	we should always use same case as in other places. since strcmpi lowers,
         //	we should lower here as well. if strcmpi changes, we have to change it here as well
@@ -319,7 +683,7 @@ int Str_CmpHeadI(lpctstr ptcFind, lpctstr ptcHere)
 
 static inline int Str_CmpHeadI_Table(lpctstr ptcFind, lpctstr ptcTable) noexcept
 {
-    for (uint i = 0; ; ++i)
+    for (size_t i = Str_Simd_CmpPrefixI(ptcFind, ptcTable); ; ++i)
     {
         const tchar ch1 = static_cast<tchar>(toupper(ptcFind[i]));
         const tchar ch2 = ptcTable[i];
@@ -647,7 +1011,7 @@ int Str_TrimEndWhitespace(tchar * pStr, int len) noexcept
 tchar * Str_TrimWhitespace(tchar * pStr) noexcept
 {
     // TODO: WARNING! Possible Memory Leak here!
-    GETNONWHITESPACE(pStr);
+    pStr += Str_Simd_SkipWhitespace(pStr);
     Str_TrimEndWhitespace(pStr, (int)strlen(pStr));
     return pStr;
 }
@@ -935,6 +1299,11 @@ static MATCH_TYPE Str_Match_After_Star(lpctstr pPattern, lpctstr pText)
         // in the pattern match the next character in the text or that
         // the next pattern char is the beginning of a range.  Increment
         // text pointer as we go here
+        if (nextp != '[')
+        {
+            // Characters not matching nextp can't start a match: skip them all at once.
+            pText += Str_Simd_FindCharI(pText, nextp);
+        }
         if (nextp == tolower(*pText) || nextp == '[')
         {
             match = Str_Match(pPattern, pText);
@@ -1109,7 +1478,7 @@ bool Str_Parse(tchar * pLine, tchar ** ppArg, lpctstr pszSep)
         pszSep = "=, \t";
 
     // skip leading white space.
-    GETNONWHITESPACE(pLine);
+    pLine += Str_Simd_SkipWhitespace(pLine);
 
     tchar ch;
     // variables used to track opened/closed quotes and brackets
@@ -1133,8 +1502,19 @@ bool Str_Parse(tchar * pLine, tchar ** ppArg, lpctstr pszSep)
             fSepHasAngle = true;
     }
 
+    // Characters which need the slow path below: quotes, brackets and separators (the terminator is implicit).
+    tchar ptcStopChars[64] = "\"{}[]()<>";
+    const size_t uiSepLen = strlen(pszSep);
+    const bool fFastSkip = (uiSepLen < sizeof(ptcStopChars) - 9);
+    if (fFastSkip)
+        memcpy(ptcStopChars + 9, pszSep, uiSepLen);
+
     for (; ; ++pLine)
     {
+        // Quickly skip the characters which aren't interesting for us.
+        if (fFastSkip)
+            pLine += Str_Simd_FindFirstOf(pLine, ptcStopChars, 9 + uiSepLen);
+
         ch = *pLine;
         if (ch == '"')	// quoted argument
         {
@@ -0,0 +1,3 @@
+#define __GITHASH__ "N/A"
+#define __GITREVISION__ 0
+#define __GITBRANCH__ ""
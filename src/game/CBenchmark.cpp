@@ -0,0 +1,392 @@
+#include "../common/sphere_library/CSFile.h"
+#include "../common/sphere_library/CSFileList.h"
+#include "../common/sphere_library/CSFileText.h"
+#include "../common/sphere_library/CSRand.h"
+#include "../network/CNetState.h"
+#include "../network/CNetworkManager.h"
+#include "../sphere/ProfileTask.h"
+#include "../sphere/threads.h"
+#include "CBenchmark.h"
+#include "CServer.h"
+#include "CServerConfig.h"
+#include "CWorld.h"
+#include "spheresvr.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+CBenchmark g_Benchmark;
+
+
+CBenchmark::CBenchmark() :
+	_iTicks(0), _iStep(BENCHMARK_STEP_DEFAULT)
+{
+}
+
+CBenchmark::~CBenchmark()
+{
+	CloseReplays();
+}
+
+int64 CBenchmark::GetTimeUsecs() noexcept // static
+{
+	const auto timeNow = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(timeNow).count();
+}
+
+void CBenchmark::SetArgs(lpctstr ptcArgs)
+{
+	ADDTOCALLSTACK("CBenchmark::SetArgs");
+	_iTicks = atoi(ptcArgs);
+	lpctstr ptcPath = strchr(ptcArgs, ',');
+	if (ptcPath != nullptr)
+		_sReplayPath = ptcPath + 1;
+	if (_iTicks <= 0)
+		g_Log.Event(LOGM_INIT|LOGL_ERROR, "Benchmark: invalid number of ticks '%s'.\n", ptcArgs);
+}
+
+void CBenchmark::SetRecordPath(lpctstr ptcPath)
+{
+	ADDTOCALLSTACK("CBenchmark::SetRecordPath");
+	_sRecordPath = ptcPath;
+	if (!_sRecordPath.IsEmpty())
+		g_Log.Event(LOGM_INIT, "Recording the input of the clients in '%s'.\n", _sRecordPath.GetBuffer());
+}
+
+CSString CBenchmark::GetRecordFileName(int iStateId, int64 iTimeStart) const
+{
+	CSString sName;
+	sName.Format("%" PRId64 "_%d.rec", iTimeStart, iStateId);
+	return CSFile::GetMergedFileName(_sRecordPath, sName);
+}
+
+void CBenchmark::Setup()
+{
+	ADDTOCALLSTACK("CBenchmark::Setup");
+	// Everything runs in the main thread, a world tick for each cycle of the main loop, with a fixed clock.
+	_iStep = (g_Cfg._iWorldTickPeriod > 0) ? g_Cfg._iWorldTickPeriod : BENCHMARK_STEP_DEFAULT;
+	g_Cfg._iWorldTickPeriod = 0;
+	g_Cfg._uiNetworkThreads = 0;
+	g_Cfg.m_fUseAsyncNetwork = 0;
+	g_Cfg._iAuthThreads = 0;
+
+	g_World._GameClock.SetFixedStep(_iStep);
+	CSRand::setSeed(BENCHMARK_SEED);
+}
+
+int CBenchmark::Run()
+{
+	ADDTOCALLSTACK("CBenchmark::Run");
+	if (!OpenReplays())
+		return -1;
+
+	g_Log.Event(LOGM_INIT, "Benchmark: running %d world ticks of %" PRId64 "ms, replaying %" PRIuSIZE_T " clients.\n",
+		_iTicks, _iStep, _vStreams.size());
+
+	// Start counting from here, the loading isn't measured.
+	ProfileData& profile = CurrentProfileData;
+	const int iWindow = profile.GetActiveWindow();
+	profile.SetActive((iWindow > 0) ? iWindow : 10);
+
+	std::vector<uint> vDurations;
+	vDurations.reserve((size_t)_iTicks);
+	const int64 iStart = GetTimeUsecs();
+	for (int i = 0; (i < _iTicks) && !g_Serv.GetExitFlag(); ++i)
+	{
+		FeedReplays(i * _iStep);
+
+		const int64 iTickStart = GetTimeUsecs();
+		Sphere_OnTick();
+		const int64 iDuration = GetTimeUsecs() - iTickStart;
+		vDurations.push_back(uint(minimum(iDuration, int64(UINT32_MAX))));
+
+		ReadReplays();
+	}
+
+	Report(vDurations, GetTimeUsecs() - iStart);
+	CloseReplays();
+	return BENCHMARK_EXIT_FLAG;
+}
+
+bool CBenchmark::OpenReplays()
+{
+	ADDTOCALLSTACK("CBenchmark::OpenReplays");
+	if (_sReplayPath.IsEmpty())
+		return true;
+
+	CSFileList filelist;
+	if (filelist.ReadDir(_sReplayPath, true) < 0)
+		return false;
+
+	// Sorted by name, to connect the clients in the same order on each run.
+	std::vector<CSString> vFiles;
+	for (const CSStringListRec* psFile = filelist.GetHead(); psFile != nullptr; psFile = psFile->GetNext())
+	{
+		lpctstr ptcExt = strrchr(*psFile, '.');
+		if ((ptcExt != nullptr) && !strcmpi(ptcExt, ".rec"))
+			vFiles.emplace_back(CSFile::GetMergedFileName(_sReplayPath, *psFile));
+	}
+	std::sort(vFiles.begin(), vFiles.end(),
+		[](const CSString& a, const CSString& b) { return (strcmp(a.GetBuffer(), b.GetBuffer()) < 0); });
+
+	int64 iTimeFirst = INT64_MAX;
+	for (const CSString& sFile : vFiles)
+	{
+		CSFile file;
+		if (!file.Open(sFile, OF_READ|OF_BINARY))
+		{
+			g_Log.Event(LOGM_INIT|LOGL_ERROR, "Benchmark: can't open the recorded input '%s'.\n", sFile.GetBuffer());
+			continue;
+		}
+
+		const int iLength = file.GetLength();
+		ReplayStream* pStream = new ReplayStream();
+		pStream->sFile = sFile;
+		pStream->vData.resize((size_t)maximum(iLength, 0));
+		const int iRead = pStream->vData.empty() ? 0 : file.Read(pStream->vData.data(), (int)pStream->vData.size());
+		file.Close();
+
+		dword dwMagic = 0;
+		const size_t uiHeaderSize = sizeof(dwMagic) + sizeof(pStream->iTimeStart);
+		if ((iRead != (int)pStream->vData.size()) || (pStream->vData.size() < uiHeaderSize))
+		{
+			g_Log.Event(LOGM_INIT|LOGL_ERROR, "Benchmark: can't read the recorded input '%s'.\n", sFile.GetBuffer());
+			delete pStream;
+			continue;
+		}
+		memcpy(&dwMagic, pStream->vData.data(), sizeof(dwMagic));
+		memcpy(&pStream->iTimeStart, pStream->vData.data() + sizeof(dwMagic), sizeof(pStream->iTimeStart));
+		if (dwMagic != BENCHMARK_RECORD_MAGIC)
+		{
+			g_Log.Event(LOGM_INIT|LOGL_ERROR, "Benchmark: '%s' isn't a recorded input file.\n", sFile.GetBuffer());
+			delete pStream;
+			continue;
+		}
+
+		// The chunk times are relative to the opening of the connection, they will be moved to the benchmark start later.
+		size_t uiOffset = uiHeaderSize;
+		while (uiOffset < pStream->vData.size())
+		{
+			ReplayChunk chunk;
+			int32 iChunkLength = 0;
+			if (uiOffset + sizeof(chunk.iTime) + sizeof(iChunkLength) > pStream->vData.size())
+				break;
+			memcpy(&chunk.iTime, pStream->vData.data() + uiOffset, sizeof(chunk.iTime));
+			memcpy(&iChunkLength, pStream->vData.data() + uiOffset + sizeof(chunk.iTime), sizeof(iChunkLength));
+			uiOffset += sizeof(chunk.iTime) + sizeof(iChunkLength);
+			if ((iChunkLength <= 0) || (uiOffset + (size_t)iChunkLength > pStream->vData.size()))
+				break;
+
+			chunk.uiOffset = uiOffset;
+			chunk.uiLength = (uint)iChunkLength;
+			pStream->vChunks.push_back(chunk);
+			uiOffset += (size_t)iChunkLength;
+		}
+		if (uiOffset != pStream->vData.size())
+			g_Log.Event(LOGM_INIT|LOGL_WARN, "Benchmark: the recorded input '%s' is truncated.\n", sFile.GetBuffer());
+
+		pStream->uiChunkNext = 0;
+		pStream->uiChunkSent = 0;
+		pStream->pState = nullptr;
+		pStream->uiBytesFed = pStream->uiBytesRead = 0;
+		pStream->uiOutPackets = pStream->uiOutSendCalls = 0;
+		pStream->fClosed = false;
+		_vStreams.push_back(pStream);
+
+		if (pStream->iTimeStart < iTimeFirst)
+			iTimeFirst = pStream->iTimeStart;
+	}
+
+	// Keep the delay between the connections: the first one is opened on the first tick.
+	for (ReplayStream* pStream : _vStreams)
+	{
+		pStream->iTimeStart -= iTimeFirst;
+		for (ReplayChunk& chunk : pStream->vChunks)
+			chunk.iTime += pStream->iTimeStart;
+	}
+	return true;
+}
+
+bool CBenchmark::OpenReplay(ReplayStream* pStream)
+{
+	ADDTOCALLSTACK("CBenchmark::OpenReplay");
+	// A loopback connection: the server side is given to the network manager like an accepted connection.
+	CSocket listener;
+	if (!listener.Create())
+		return false;
+
+	sockaddr_in addrLocal = CSocketAddress(SOCKET_LOCAL_ADDRESS, 0).GetAddrPort();
+	if ((listener.Bind(&addrLocal) != 0) || (listener.Listen(1) != 0))
+		return false;
+	if (!pStream->socket.Create() || (pStream->socket.Connect(listener.GetSockName()) != 0))
+		return false;
+
+	CSocketAddress addrPeer;
+	const SOCKET hSocket = listener.Accept(addrPeer);
+	listener.Close();
+	if (hSocket == INVALID_SOCKET)
+		return false;
+
+	pStream->socket.SetNonBlocking();
+	pStream->pState = g_NetworkManager.attachConnection(hSocket, addrPeer);
+	if (pStream->pState == nullptr)
+	{
+		CLOSESOCKET(hSocket);
+		return false;
+	}
+	return true;
+}
+
+void CBenchmark::FeedReplays(int64 iTime)
+{
+	ADDTOCALLSTACK("CBenchmark::FeedReplays");
+	// Send the chunks due by this time, before the tick reads them.
+	for (ReplayStream* pStream : _vStreams)
+	{
+		if (pStream->fClosed)
+			continue;
+		if (pStream->pState == nullptr)
+		{
+			if (pStream->iTimeStart > iTime)
+				continue;
+			if (!OpenReplay(pStream))
+			{
+				g_Log.Event(LOGL_ERROR, "Benchmark: can't connect the recorded input '%s'.\n", pStream->sFile.GetBuffer());
+				pStream->fClosed = true;
+				continue;
+			}
+		}
+
+		while (pStream->uiChunkNext < pStream->vChunks.size())
+		{
+			const ReplayChunk& chunk = pStream->vChunks[pStream->uiChunkNext];
+			if (chunk.iTime > iTime)
+				break;
+
+			const int iSent = pStream->socket.Send(pStream->vData.data() + chunk.uiOffset + pStream->uiChunkSent, (int)(chunk.uiLength - pStream->uiChunkSent));
+			if (iSent <= 0)
+				break;	// the socket buffer is full (or the server closed the connection), try again on the next tick
+			pStream->uiBytesFed += (uint)iSent;
+			pStream->uiChunkSent += (uint)iSent;
+			if (pStream->uiChunkSent < chunk.uiLength)
+				break;
+
+			++pStream->uiChunkNext;
+			pStream->uiChunkSent = 0;
+		}
+	}
+}
+
+void CBenchmark::ReadReplays()
+{
+	ADDTOCALLSTACK("CBenchmark::ReadReplays");
+	// Read (and count) what the tick sent to the clients, or their socket buffers will fill up.
+	byte buffer[0x4000];
+	for (ReplayStream* pStream : _vStreams)
+	{
+		if (pStream->fClosed || (pStream->pState == nullptr))
+			continue;
+
+		for (;;)
+		{
+			const int iRead = pStream->socket.Receive(buffer, (int)sizeof(buffer));
+			if (iRead > 0)
+			{
+				pStream->uiBytesRead += (uint)iRead;
+				continue;
+			}
+			if (iRead == 0)
+			{
+				// Closed by the server (ie. disconnected after the login): its network state may be given to another client now.
+				pStream->socket.Close();
+				pStream->fClosed = true;
+			}
+			break;
+		}
+
+		if (!pStream->fClosed && pStream->pState->isInUse())
+		{
+			pStream->uiOutPackets = pStream->pState->getOutPackets();
+			pStream->uiOutSendCalls = pStream->pState->getOutSendCalls();
+		}
+	}
+}
+
+void CBenchmark::CloseReplays()
+{
+	for (ReplayStream* pStream : _vStreams)
+	{
+		if (pStream->socket.IsOpen())
+			pStream->socket.Close();
+		delete pStream;
+	}
+	_vStreams.clear();
+}
+
+void CBenchmark::Report(const std::vector<uint>& vDurations, int64 iTotalUsecs) const
+{
+	ADDTOCALLSTACK("CBenchmark::Report");
+	// Written in the log and in benchmark.txt, to be compared with the other runs.
+	CSString sReport, sLine;
+
+	std::vector<uint> vSorted(vDurations);
+	std::sort(vSorted.begin(), vSorted.end());
+	ullong uiSum = 0;
+	for (uint uiDuration : vSorted)
+		uiSum += uiDuration;
+	const size_t uiCount = vSorted.size();
+	auto getPercentile = [&vSorted, uiCount](size_t uiPercent) -> double
+	{
+		if (uiCount == 0)
+			return 0;
+		const size_t uiIndex = minimum(uiCount - 1, (uiCount * uiPercent) / 100);
+		return vSorted[uiIndex] / 1000.0;
+	};
+
+	sLine.Format("Benchmark: %" PRIuSIZE_T " world ticks of %" PRId64 "ms in %.3fs (chars=%" PRIuSIZE_T ", items=%" PRIuSIZE_T ", replayed clients=%" PRIuSIZE_T ").\n",
+		uiCount, _iStep, iTotalUsecs / 1000000.0, g_Serv.StatGet(SERV_STAT_CHARS), g_Serv.StatGet(SERV_STAT_ITEMS), _vStreams.size());
+	sReport += sLine;
+	sLine.Format("Tick duration: avg %.3fms, p50 %.3fms, p95 %.3fms, p99 %.3fms, max %.3fms.\n",
+		(uiCount > 0) ? (uiSum / 1000.0) / uiCount : 0.0, getPercentile(50), getPercentile(95), getPercentile(99), getPercentile(100));
+	sReport += sLine;
+
+	// The profiler has a msecs precision, but it's still meaningful over many ticks.
+	ProfileData& profile = CurrentProfileData;
+	llong llTimeTotal = 0;
+	for (int i = 0; i < PROFILE_TIME_QTY; ++i)
+		llTimeTotal += profile.GetTotalTime(PROFILE_TYPE(i));
+	for (int i = PROFILE_OVERHEAD; i < PROFILE_TIME_QTY; ++i)
+	{
+		const PROFILE_TYPE id = PROFILE_TYPE(i);
+		if (!profile.IsEnabled(id))
+			continue;
+		const llong llTime = profile.GetTotalTime(id);
+		sLine.Format("%-14s %9.3fs %5.1f%%  [samples: %lld]\n", profile.GetName(id), llTime / 1000.0,
+			(llTimeTotal > 0) ? (llTime * 100.0) / llTimeTotal : 0.0, profile.GetTotalCount(id));
+		sReport += sLine;
+	}
+	sLine.Format("Network: received %lld bytes in %lld reads, sent %lld bytes in %lld send calls.\n",
+		profile.GetTotalTime(PROFILE_DATA_RX), profile.GetTotalCount(PROFILE_DATA_RX),
+		profile.GetTotalTime(PROFILE_DATA_TX), profile.GetTotalCount(PROFILE_DATA_TX));
+	sReport += sLine;
+
+	for (const ReplayStream* pStream : _vStreams)
+	{
+		ullong uiBytesTotal = 0;
+		for (const ReplayChunk& chunk : pStream->vChunks)
+			uiBytesTotal += chunk.uiLength;
+		sLine.Format("Client '%s': fed %" PRIu64 "/%" PRIu64 " bytes, read %" PRIu64 " bytes, %" PRIu64 " packets in %" PRIu64 " send calls%s.\n",
+			pStream->sFile.GetBuffer(), pStream->uiBytesFed, uiBytesTotal, pStream->uiBytesRead,
+			pStream->uiOutPackets, pStream->uiOutSendCalls, pStream->fClosed ? " (disconnected)" : "");
+		sReport += sLine;
+	}
+
+	g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "%s", sReport.GetBuffer());
+
+	CSFileText file;
+	if (file.Open("benchmark.txt", OF_WRITE|OF_TEXT))
+	{
+		file.WriteString(sReport.GetBuffer());
+		file.Close();
+	}
+}
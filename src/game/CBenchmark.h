@@ -0,0 +1,98 @@
+/**
+* @file CBenchmark.h
+* @brief Headless run of a fixed number of world ticks, replaying recorded client input, to compare the server performance run to run.
+*/
+
+#ifndef _INC_CBENCHMARK_H
+#define _INC_CBENCHMARK_H
+
+#include "../common/sphere_library/CSString.h"
+#include "../network/CSocket.h"
+#include <vector>
+
+class CNetState;
+
+
+#define BENCHMARK_STEP_DEFAULT	10			// msecs of game time for each world tick, when WorldTickPeriod is 0
+#define BENCHMARK_SEED			0x5EED		// seed of the random numbers, so that each run takes the same decisions
+#define BENCHMARK_RECORD_MAGIC	0x43455253	// "SREC": first dword of the recorded input files
+#define BENCHMARK_EXIT_FLAG		7			// exit flag of a finished benchmark: only for the shutdown reason, the process exits with 0
+
+
+// Recorded input file (-R command line switch): the magic, the system time (msecs) when the connection was opened,
+//  then a chunk for each read from the socket: the msecs passed since the connection was opened, the length and the data.
+// The data is recorded as received, before the decryption, so it must be replayed on the same world and accounts.
+//
+// Benchmark mode (-B command line switch): after loading the world, the server doesn't listen for connections and runs
+//  the requested number of world ticks one after the other, as fast as it can. The world clock advances by a fixed step
+//  at each tick and the random numbers are seeded, the network and the password checks are done in the main thread.
+// The recorded clients are connected through loopback sockets: each chunk is sent when the game time since the start
+//  reaches its time (keeping the delay between the connections), and the data sent to them is read and counted.
+// At the end the durations of the ticks, the time spent in each subsystem (from the profiler of the main thread)
+//  and the network traffic are reported, then the server quits without saving.
+class CBenchmark
+{
+	struct ReplayChunk
+	{
+		int64 iTime;		// msecs since the start of the benchmark
+		size_t uiOffset;	// in vData
+		uint uiLength;
+	};
+
+	struct ReplayStream
+	{
+		CSString sFile;
+		std::vector<byte> vData;			// whole content of the file
+		std::vector<ReplayChunk> vChunks;
+		size_t uiChunkNext;					// next chunk to send
+		uint uiChunkSent;					// bytes of the next chunk already sent
+		CSocket socket;						// our side of the connection
+		CNetState* pState;					// server side of the connection
+		int64 iTimeStart;					// recorded opening time (system msecs)
+		ullong uiBytesFed;					// bytes sent to the server
+		ullong uiBytesRead;					// bytes read from the server
+		ullong uiOutPackets, uiOutSendCalls;	// last stats of the server side, before it's closed
+		bool fClosed;
+	};
+
+	int _iTicks;					// world ticks to run (0 = benchmark mode off)
+	int64 _iStep;					// msecs of game time for each tick
+	CSString _sReplayPath;			// recorded input to replay
+	CSString _sRecordPath;			// where to record the input of the clients (empty = off)
+	std::vector<ReplayStream*> _vStreams;
+
+public:
+	static const char* m_sClassName;
+	CBenchmark();
+	~CBenchmark();
+
+private:
+	CBenchmark(const CBenchmark& copy);
+	CBenchmark& operator=(const CBenchmark& other);
+
+public:
+	bool IsActive() const noexcept { return (_iTicks > 0); }
+	void SetArgs(lpctstr ptcArgs);			// -B#[,path/]: number of ticks and path of the recorded input
+	void SetRecordPath(lpctstr ptcPath);	// -Rpath/
+
+	// Recording of the input (called by the network threads).
+	bool IsRecording() const noexcept { return !_sRecordPath.IsEmpty(); }
+	CSString GetRecordFileName(int iStateId, int64 iTimeStart) const;
+
+	void Setup();		// adjust the settings, after the command line is read
+	int Run();			// run the ticks and report (return the exit flag)
+
+private:
+	bool OpenReplays();
+	bool OpenReplay(ReplayStream* pStream);
+	void FeedReplays(int64 iTime);
+	void ReadReplays();
+	void CloseReplays();
+	void Report(const std::vector<uint>& vDurations, int64 iTotalUsecs) const;
+
+	static int64 GetTimeUsecs() noexcept;
+};
+
+extern CBenchmark g_Benchmark;
+
+#endif // _INC_CBENCHMARK_H
@@ -151,6 +151,9 @@ void CContainer::ContentAddPrivate( CItem *pItem )
 	CSObjCont::InsertContentTail( pItem );
 	//pItem->RemoveUIDFlags(UID_O_DISCONNECT);
 
+	pItem->_ContentIndexRecord();
+	ContentIndexAddItem(pItem, 1);
+
 	if ( !pItem->IsType(IT_EQ_TRADE_WINDOW) )  //Don't apply trade window layer item weight on character weight.
 		OnWeightChange(pItem->GetWeight());
 
@@ -200,6 +203,99 @@ void CContainer::OnRemoveObj( CSObjContRec *pObRec )	// Override this = called w
 	pItem->SetUIDContainerFlags(UID_O_DISCONNECT);		// It is no place for the moment.
 	if ( !pItem->IsType(IT_EQ_TRADE_WINDOW) ) //Don't apply trade window layer item weight on character weight.
 		OnWeightChange(-pItem->GetWeight());
+
+	ContentIndexAddItem(pItem, -1);
+}
+
+void CContainer::_ContentIndexApply( ContentIndexMap& mapIndex, dword dwKey, llong iAmount, int iCount ) // static
+{
+	ContentIndexRec& rec = mapIndex[dwKey];
+	rec.iAmount += iAmount;
+	rec.iCount += iCount;
+	if (rec.iCount <= 0)
+		mapIndex.erase(dwKey);
+}
+
+void CContainer::ContentIndexPropagate( dword dwKey, llong iAmount, int iCount, bool fAll, bool fSearchable )
+{
+	// Walk up the containers holding this one, until the char or the item on the ground/in a sector.
+	CContainer *pCont = this;
+	while ( pCont && (fAll || fSearchable) )
+	{
+		if ( fAll )
+			_ContentIndexApply(pCont->_mapIndexAll, dwKey, iAmount, iCount);
+		if ( fSearchable )
+			_ContentIndexApply(pCont->_mapIndexSearchable, dwKey, iAmount, iCount);
+
+		const CItem *pContItem = dynamic_cast<const CItem *>(pCont);
+		if ( !pContItem )
+			break;
+		// Use the searchability recorded when the container was indexed, not the current one: CItem::UpdateContentIndex may be fixing it.
+		if ( !pContItem->_fIndexedSearchable )
+			fSearchable = false;
+		pCont = dynamic_cast<CContainer *>(pContItem->GetParent());
+	}
+}
+
+void CContainer::ContentIndexAddContents( const CContainer *pCont, int iSign, bool fAll, bool fSearchable )
+{
+	ASSERT(pCont != this);
+	if ( fAll )
+	{
+		for ( const auto& [dwKey, rec] : pCont->_mapIndexAll )
+			ContentIndexPropagate(dwKey, iSign * rec.iAmount, iSign * rec.iCount, true, false);
+	}
+	if ( fSearchable )
+	{
+		for ( const auto& [dwKey, rec] : pCont->_mapIndexSearchable )
+			ContentIndexPropagate(dwKey, iSign * rec.iAmount, iSign * rec.iCount, false, true);
+	}
+}
+
+void CContainer::ContentIndexAddItem( const CItem *pItem, int iSign )
+{
+	// The item itself is always searchable from here, what's inside it only if it is.
+	ContentIndexPropagate(CONTENTINDEX_KEY_ITEMS, 0, iSign, true, false);
+	ContentIndexPropagate(pItem->_dwIndexedBaseKey, iSign * llong(pItem->_wIndexedAmount), iSign, true, true);
+	ContentIndexPropagate(pItem->_dwIndexedTypeKey, iSign * llong(pItem->_wIndexedAmount), iSign, true, true);
+
+	const CContainer *pItemCont = dynamic_cast<const CContainer *>(pItem);
+	if ( pItemCont )
+		ContentIndexAddContents(pItemCont, iSign, true, pItem->_fIndexedSearchable);
+}
+
+bool CContainer::ContentIndexGet( const CResourceID& rid, bool fSearchable, llong& iAmount, int& iCount ) const
+{
+	// Get the total amount and number of the items matching this resource (see CItem::IsResourceMatch) inside this container.
+	// RETURN:
+	//  false = the index can't tell, the contents have to be scanned.
+	const RES_TYPE restype = rid.GetResType();
+	if ( ((restype != RES_ITEMDEF) && (restype != RES_TYPEDEF)) || (rid.GetResPage() != 0) )
+		return false;
+
+	const ContentIndexMap& mapIndex = fSearchable ? _mapIndexSearchable : _mapIndexAll;
+	iAmount = 0;
+	iCount = 0;
+	auto addKey = [&mapIndex, &iAmount, &iCount](dword dwKey)
+	{
+		const auto itRec = mapIndex.find(dwKey);
+		if ( itRec == mapIndex.end() )
+			return;
+		iAmount += itRec->second.iAmount;
+		iCount += itRec->second.iCount;
+	};
+
+	const uint uiIndex = rid.GetResIndex();
+	addKey(GetContentIndexKey(restype, uiIndex));
+	if ( (restype == RES_ITEMDEF) && !IsSetEF(EF_Item_Strict_Comparison) )
+	{
+		// Same special cases as in CItem::IsResourceMatch.
+		if ( uiIndex == ITEMID_LOG_1 )
+			addKey(GetContentIndexKey(RES_ITEMDEF, ITEMID_BOARD1));
+		else if ( uiIndex == ITEMID_HIDES )
+			addKey(GetContentIndexKey(RES_ITEMDEF, ITEMID_LEATHER_1));
+	}
+	return true;
 }
 
 void CContainer::r_WriteContent( CScript &s ) const
@@ -224,6 +320,11 @@ CItem *CContainer::ContentFind( CResourceID rid, dword dwArg, int iDecendLevels
 	if ( rid.GetResIndex() == 0 )
 		return nullptr;
 
+	llong iIndexedAmount;
+	int iIndexedCount;
+	if ( ContentIndexGet(rid, true, iIndexedAmount, iIndexedCount) && (iIndexedCount == 0) )
+		return nullptr;		// nothing like this in here or in the sub-containers (and each one of them will check its own index)
+
 	for (CSObjContRec* pObjRec : *this)
 	{
 		CItem* pItem = static_cast<CItem*>(pObjRec);
@@ -384,6 +485,19 @@ int CContainer::ContentConsumeTest( const CResourceID& rid, int amount, dword dw
     if ( rid.GetResIndex() == 0 )
         return amount;	// from skills menus.
 
+    // Gold is searched also in the non-searchable sub-containers (except the locked ones), so we can only check for its presence.
+    // Maps and keys need to check also dwArg, which isn't indexed.
+    const bool fGold = (rid == CResourceID(RES_TYPEDEF, IT_GOLD));
+    llong iIndexedAmount;
+    int iIndexedCount;
+    if ( ContentIndexGet(rid, !fGold, iIndexedAmount, iIndexedCount) )
+    {
+        if ( iIndexedCount == 0 )
+            return amount;
+        if ( !fGold && (dwArg == 0) )
+            return amount - (int)minimum(iIndexedAmount, (llong)amount);
+    }
+
 	for (const CSObjContRec* pObjRec : *this)
 	{
 		const CItem* pItem = static_cast<const CItem*>(pObjRec);
@@ -429,6 +543,12 @@ int CContainer::ContentConsume( const CResourceID& rid, int amount, dword dwArg
 	if ( rid.GetResIndex() == 0 )
 		return amount;	// from skills menus.
 
+	const bool fGold = (rid == CResourceID(RES_TYPEDEF, IT_GOLD));
+	llong iIndexedAmount;
+	int iIndexedCount;
+	if ( ContentIndexGet(rid, !fGold, iIndexedAmount, iIndexedCount) && (iIndexedCount == 0) )
+		return amount;		// nothing to consume in here
+
 	for (size_t i = 0; i < GetContentCount();)
 	{
 		CItem* pItem = static_cast<CItem*>(GetContentIndex(i));
@@ -636,19 +756,8 @@ size_t CContainer::ContentCountAll() const
 	ADDTOCALLSTACK("CContainer::ContentCountAll");
 	// RETURN:
 	//  A count of all the items in this container and sub contianers.
-	size_t iTotal = 0;
-	for (const CSObjContRec* pObjRec : *this)
-	{
-		++ iTotal;
-		const CItem* pItem = static_cast<const CItem*>(pObjRec);
-		const CItemContainer *pCont = dynamic_cast<const CItemContainer *>(pItem);
-		if ( !pCont )
-			continue;
-		//if ( !pCont->IsSearchable() )
-		//	continue;	// found a sub
-		iTotal += pCont->ContentCountAll();
-	}
-	return iTotal;
+	const auto itRec = _mapIndexAll.find(CONTENTINDEX_KEY_ITEMS);
+	return (itRec == _mapIndexAll.end()) ? 0 : (size_t)itRec->second.iCount;
 }
 
 bool CContainer::r_GetRefContainer( lpctstr &ptcKey, CScriptObj *&pRef )
@@ -6,15 +6,20 @@
 #ifndef _INC_CCONTAINER_H
 #define _INC_CCONTAINER_H
 
+#include "../../lib/parallel_hashmap/phmap.h"
 #include "../common/sphere_library/CSObjCont.h"
 #include "../common/resource/CResourceHolder.h"
 #include "../common/CUID.h"
 #include "../common/CRect.h"
 
 
+class CItem;
 class CItemContainer;
 class CObjBase;
 
+// Key of the content index counting the items (instead of their amounts).
+#define CONTENTINDEX_KEY_ITEMS	0
+
 class CContainer : public CSObjCont	// This class contains a list of items but may or may not be an item itself.
 {
 public:
@@ -29,6 +34,22 @@ private:
 public:
     int	m_totalweight;      // weight of all the items it has. (1/WEIGHT_UNITS pound)
 
+private:
+    // Total amounts of the items inside this container and all its sub-containers, by base id and by type (see GetContentIndexKey),
+    //  kept updated when items are added/removed or their id, type or amount change, so that we don't need to scan all the contents
+    //  to count or find the resources.
+    struct ContentIndexRec
+    {
+        llong iAmount;  // sum of the amounts
+        int iCount;     // number of items
+    };
+    using ContentIndexMap = phmap::flat_hash_map<dword, ContentIndexRec>;
+    ContentIndexMap _mapIndexAll;           // all the items inside, plus the number of items (CONTENTINDEX_KEY_ITEMS)
+    ContentIndexMap _mapIndexSearchable;    // only the items not inside non-searchable sub-containers (bank and vendor boxes, locked containers...)
+
+    static void _ContentIndexApply(ContentIndexMap& mapIndex, dword dwKey, llong iAmount, int iCount);
+    bool ContentIndexGet(const CResourceID& rid, bool fSearchable, llong& iAmount, int& iCount) const;
+
 protected:
     friend class CObjBase;
     // Not virtuals!
@@ -52,6 +73,40 @@ public:
      */
     void ContentAddPrivate(CItem* pItem);
 
+    static dword GetContentIndexKey(RES_TYPE restype, uint uiIndex) noexcept
+    {
+        return ((dword(restype) & RES_TYPE_MASK) << RES_TYPE_SHIFT) | (uiIndex & RES_INDEX_MASK);
+    }
+
+    /**
+     * @fn  void CContainer::ContentIndexPropagate( dword dwKey, llong iAmount, int iCount, bool fAll, bool fSearchable );
+     * @brief   Change an entry in the content index of this container and of the containers holding it.
+     * @param   dwKey       The key (GetContentIndexKey).
+     * @param   iAmount     The change of the amount.
+     * @param   iCount      The change of the number of items.
+     * @param   fAll        Change the index of all the items.
+     * @param   fSearchable Change the index of the searchable items (stops at the first non-searchable container).
+     */
+    void ContentIndexPropagate(dword dwKey, llong iAmount, int iCount, bool fAll, bool fSearchable);
+
+    /**
+     * @fn  void CContainer::ContentIndexAddContents( const CContainer * pCont, int iSign, bool fAll, bool fSearchable );
+     * @brief   Add to (or remove from) the content index of this container and of the containers holding it the whole index of another one.
+     * @param   pCont       The container inside this one.
+     * @param   iSign       1 to add, -1 to remove.
+     * @param   fAll        Its index of all the items.
+     * @param   fSearchable Its index of the searchable items.
+     */
+    void ContentIndexAddContents(const CContainer* pCont, int iSign, bool fAll, bool fSearchable);
+
+    /**
+     * @fn  void CContainer::ContentIndexAddItem( const CItem * pItem, int iSign );
+     * @brief   Add to (or remove from) the content index an item directly inside this container, with its own contents.
+     * @param   pItem   The item.
+     * @param   iSign   1 to add, -1 to remove.
+     */
+    void ContentIndexAddItem(const CItem* pItem, int iSign);
+
     void r_WriteContent(CScript& s) const;
 
     bool r_WriteValContainer(lpctstr ptcKey, CSString& sVal, CTextConsole* pSrc);
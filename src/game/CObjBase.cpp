@@ -1,4 +1,5 @@
 
+#include "../common/resource/sections/CSpeechDef.h"
 #include "../common/resource/CResourceLock.h"
 #include "../common/CException.h"
 #include "../common/sphereversion.h"
@@ -491,7 +492,7 @@ void CObjBase::Effect(EFFECT_TYPE motion, ITEMID_TYPE id, const CObjBase * pSour
         return;
     }
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if ( ! pClient->CanSee( this ) )
@@ -527,7 +528,7 @@ void CObjBase::EffectLocation(EFFECT_TYPE motion, ITEMID_TYPE id, const CPointMa
     }
 
     // show for everyone nearby
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if (!pClient->CanSee(this))
@@ -722,7 +723,7 @@ void CObjBase::UpdateObjMessage( lpctstr pTextThem, lpctstr pTextYou, CClient *
 	ADDTOCALLSTACK("CObjBase::UpdateObjMessage");
 	// Show everyone a msg coming from this object.
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if ( pClient == pClientExclude )
@@ -745,7 +746,7 @@ void CObjBase::UpdateCanSee(PacketSend *packet, CClient *exclude) const
 	// Send this update message to everyone who can see this.
 	// NOTE: Need not be a top level object. CanSee() will calc that.
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if (( pClient == exclude ) || !pClient->CanSee(this) )
@@ -756,7 +757,7 @@ void CObjBase::UpdateCanSee(PacketSend *packet, CClient *exclude) const
 	delete packet;
 }
 
-TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLock & s, lpctstr pszCmd, CChar * pSrc, TALKMODE_TYPE & mode, HUE_TYPE wHue)
+TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLock & s, lpctstr pszCmd, CChar * pSrc, TALKMODE_TYPE & mode, HUE_TYPE wHue, CScriptTriggerArgs * pArgs)
 {
 	ADDTOCALLSTACK("CObjBase::OnHearTrigger");
 	// Check all the keys in this script section.
@@ -764,7 +765,8 @@ TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLock & s, lpctstr pszCmd, CChar *
 	// RETURN:
 	//  TRIGRET_ENDIF = no match.
 	//  TRIGRET_DEFAULT = found match but it had no RETURN
-    std::unique_ptr<CScriptTriggerArgs> Args;
+    std::unique_ptr<CScriptTriggerArgs> pArgsOwned;
+    CScriptTriggerArgs* Args = pArgs;	// given when continuing after a block already run by the compiled matcher
 	bool fMatch = false;
 
 	while ( s.ReadKeyParse())
@@ -785,11 +787,12 @@ TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLock & s, lpctstr pszCmd, CChar *
         if (!Args)
         {
             // Allocate when needed
-            Args = std::make_unique<CScriptTriggerArgs>(pszCmd);
+            pArgsOwned = std::make_unique<CScriptTriggerArgs>(pszCmd);
+            Args = pArgsOwned.get();
             Args->m_iN1 = mode;
             Args->m_iN2 = wHue;
         }
-		TRIGRET_TYPE iRet = CObjBase::OnTriggerRunVal( s, TRIGRUN_SECTION_EXEC, pSrc, Args.get() );
+		TRIGRET_TYPE iRet = CObjBase::OnTriggerRunVal( s, TRIGRUN_SECTION_EXEC, pSrc, Args );
 		if ( iRet != TRIGRET_RET_FALSE )
 			return iRet;
 
@@ -801,6 +804,53 @@ TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLock & s, lpctstr pszCmd, CChar *
 	return TRIGRET_ENDIF;	// continue looking.
 }
 
+TRIGRET_TYPE CObjBase::OnHearTrigger( CResourceLink * pLink, lpctstr pszCmd, CChar * pSrc, TALKMODE_TYPE & mode, HUE_TYPE wHue)
+{
+	ADDTOCALLSTACK("CObjBase::OnHearTrigger(link)");
+	ASSERT(pLink);
+
+	CResourceLock s;
+	CSpeechDef * pSpeechDef = dynamic_cast<CSpeechDef *>(pLink);
+	if ( pSpeechDef == nullptr )
+	{
+		// Not a [SPEECH] section: check it line by line.
+		if ( !pLink->ResourceLock(s) )
+			return TRIGRET_ENDIF;
+		return OnHearTrigger(s, pszCmd, pSrc, mode, wHue);
+	}
+
+	bool fLocked = false;
+	if ( !pSpeechDef->IsCompiled() )
+	{
+		if ( !pSpeechDef->ResourceLock(s) )
+			return TRIGRET_ENDIF;
+		fLocked = true;
+		pSpeechDef->Compile(s);
+	}
+
+	// Copy the context: the script executed may even trigger a resync, invalidating the compiled data.
+	CScriptLineContext ctxBody;
+	if ( !pSpeechDef->GetFirstMatchingBlock(pszCmd, ctxBody) )
+		return TRIGRET_ENDIF;	// no match, and we didn't even need to read the script.
+
+	if ( !fLocked && !pSpeechDef->ResourceLock(s) )
+		return TRIGRET_ENDIF;
+
+	// Read the first line of code following the matching ON= lines, then run from there, as the line by line version does.
+	if ( !s.SeekContext(ctxBody) || !s.ReadKeyParse() )
+		return TRIGRET_ENDIF;
+	std::unique_ptr<CScriptTriggerArgs> Args = std::make_unique<CScriptTriggerArgs>(pszCmd);
+	Args->m_iN1 = mode;
+	Args->m_iN2 = wHue;
+	TRIGRET_TYPE iRet = CObjBase::OnTriggerRunVal( s, TRIGRUN_SECTION_EXEC, pSrc, Args.get() );
+	if ( iRet != TRIGRET_RET_FALSE )
+		return iRet;
+
+	// RETURN 0: go on line by line from where the block stopped, exactly as the line by line version
+	//  (it doesn't check the ON= line which ended the block, if it was read by the block).
+	return OnHearTrigger(s, pszCmd, pSrc, mode, wHue, Args.get());
+}
+
 enum OBR_TYPE
 {
 	OBR_ROOM,
@@ -2982,7 +3032,7 @@ void CObjBase::RemoveFromView( CClient * pClientExclude, bool fHardcoded )
 	CItem * pItem = fHardcoded ? (dynamic_cast<CItem*>(this)) : (nullptr);
 	CChar * pChar = nullptr;
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if ( pClientExclude == pClient )
@@ -3020,7 +3070,7 @@ void CObjBase::ResendOnEquip( bool fAllClients )
 	CItem * pItem = dynamic_cast<CItem*>(this);
 	CChar * pChar = nullptr;
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if ( fAllClients == false && !pClient->GetNetState()->isClientEnhanced() )
@@ -3116,7 +3166,10 @@ void CObjBase::OnTickStatusUpdate()
 
 	if (m_fStatusUpdate & SU_UPDATE_TOOLTIP)
 	{
-		ResendTooltip();
+		// Sent to all nearby clients at the end of the tick, together with the other status updates.
+		//  The flag is cleared when the tooltip is sent at least once, like in ResendTooltip.
+		if (!g_Serv.IsLoading() && IsAosFlagEnabled(FEATURE_AOS_UPDATE_B) && !IsDisconnected())
+			CWorldTickingList::AddObjStatusBroadcast(this, SU_UPDATE_TOOLTIP);
 	}
 
 	if (IsItem())
@@ -3214,7 +3267,7 @@ void CObjBase::ResendTooltip(bool fSendFull, bool fUseCache)
 		FreePropertyList();
 
     bool fSentLeastOnce = false;
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient *pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
         CChar *pChar = pClient->GetChar();
@@ -821,10 +821,27 @@ public:
      * @param [in,out]  pSrc    If non-null, source for the.
      * @param [in,out]  mode    The mode.
      * @param   wHue            The hue.
+     * @param [in,out]  pArgs   If non-null, the args of a block already run (then the ON= lines are checked from the current line).
      *
      * @return  A TRIGRET_TYPE.
      */
-	TRIGRET_TYPE OnHearTrigger(CResourceLock &s, lpctstr pCmd, CChar *pSrc, TALKMODE_TYPE &mode, HUE_TYPE wHue = HUE_DEFAULT);
+	TRIGRET_TYPE OnHearTrigger(CResourceLock &s, lpctstr pCmd, CChar *pSrc, TALKMODE_TYPE &mode, HUE_TYPE wHue = HUE_DEFAULT, CScriptTriggerArgs *pArgs = nullptr);
+
+    /**
+     * @fn  TRIGRET_TYPE CObjBase::OnHearTrigger(CResourceLink *pLink, lpctstr pCmd, CChar *pSrc, TALKMODE_TYPE &mode, HUE_TYPE wHue = HUE_DEFAULT);
+     *
+     * @brief   Executes the hear trigger action. For [SPEECH] sections, uses the compiled ON= matcher (see CSpeechDef),
+     *          so the script is locked and read only when some ON= pattern matches.
+     *
+     * @param [in,out]  pLink   The speech resource.
+     * @param   pCmd            The command.
+     * @param [in,out]  pSrc    If non-null, source for the.
+     * @param [in,out]  mode    The mode.
+     * @param   wHue            The hue.
+     *
+     * @return  A TRIGRET_TYPE. TRIGRET_ENDIF also if the resource couldn't be locked.
+     */
+	TRIGRET_TYPE OnHearTrigger(CResourceLink *pLink, lpctstr pCmd, CChar *pSrc, TALKMODE_TYPE &mode, HUE_TYPE wHue = HUE_DEFAULT);
 
     /**
      * @fn  bool CObjBase::IsContainer() const;
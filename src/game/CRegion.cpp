@@ -74,19 +74,20 @@ bool CRegion::RealizeRegion()
 	if ( !m_pt.IsValidPoint() )
 		m_pt = GetRegionCorner( DIR_QTY );	// center
 
-	// Attach to all sectors that i overlap.
+	// Attach to all sectors that i overlap (only the ones under the union rectangle can).
 	ASSERT( m_iLinkedSectors == 0 );
-	const CSectorList* pSectors = CSectorList::Get();
-	for ( int i = 0, iMax = pSectors->GetSectorQty(m_pt.m_map); i < iMax; ++i )
+	for ( int i = 0; ; ++i )
 	{
-		CSector *pSector = pSectors->GetSector(m_pt.m_map, i);
+		CSector *pSector = GetSector(i);
+		if ( pSector == nullptr )
+			break;
 
-		if ( pSector && IsOverlapped(pSector->GetRect()) )
+		if ( IsOverlapped(pSector->GetRect()) )
 		{
 			//	Yes, this sector overlapped, so add it to the sector list
 			if ( !pSector->LinkRegion(this) )
 			{
-				g_Log.EventError("Linking sector #%d for map %d for region %s failed (fatal for this region).\n", i, m_pt.m_map, GetName());
+				g_Log.EventError("Linking sector #%d for map %d for region %s failed (fatal for this region).\n", pSector->GetIndex(), m_pt.m_map, GetName());
 				return false;
 			}
 			++m_iLinkedSectors;
@@ -95,6 +96,57 @@ bool CRegion::RealizeRegion()
 	return true;
 }
 
+bool CRegion::RelinkRegion( const CRectMap & rect )
+{
+	ADDTOCALLSTACK("CRegion::RelinkRegion");
+	// Replace the rectangles of the region with this one and link it again to the world.
+	// Moving a realized region only touches the sectors it overlaps before or after the move: it's unlinked from the
+	//  sectors it leaves and linked to the ones it enters. In the sectors it still overlaps it's linked again, since its place
+	//  among their regions (smaller first) may have changed.
+	if ( !m_iLinkedSectors )
+	{
+		SetRegionRect(rect);
+		return RealizeRegion();
+	}
+	if ( !rect.IsValid() || rect.IsRectEmpty() )
+	{
+		UnRealizeRegion();
+		EmptyRegion();
+		return false;
+	}
+
+	const CRectMap rectOld = m_rectUnion;
+	for ( int i = 0; ; ++i )
+	{
+		CSector * pSector = rectOld.GetSector(i);
+		if ( pSector == nullptr )
+			break;
+		if ( !IsOverlapped(pSector->GetRect()) || ((rect.m_map == rectOld.m_map) && rect.IsOverlapped(pSector->GetRect())) )
+			continue;
+		if ( pSector->UnLinkRegion(this) )
+			--m_iLinkedSectors;
+	}
+
+	SetRegionRect(rect);
+	for ( int i = 0; ; ++i )
+	{
+		CSector * pSector = GetSector(i);
+		if ( pSector == nullptr )
+			break;
+		if ( !IsOverlapped(pSector->GetRect()) )
+			continue;
+		if ( pSector->UnLinkRegion(this) )
+			--m_iLinkedSectors;
+		if ( !pSector->LinkRegion(this) )
+		{
+			g_Log.EventError("Linking sector #%d for map %d for region %s failed (fatal for this region).\n", pSector->GetIndex(), m_pt.m_map, GetName());
+			return false;
+		}
+		++m_iLinkedSectors;
+	}
+	return true;
+}
+
 bool CRegion::AddRegionRect( const CRectMap & rect )
 {
 	ADDTOCALLSTACK("CRegion::AddRegionRect");
@@ -114,6 +114,7 @@ private:
 public:
 	virtual bool RealizeRegion();
 	void UnRealizeRegion();
+	bool RelinkRegion( const CRectMap & rect );	// move the (realized or not) region to this rectangle
 #define REGMOD_FLAGS	0x0001
 #define REGMOD_EVENTS	0x0002
 #define REGMOD_TAGS		0x0004
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include "../common/CException.h"
 #include "../common/CLog.h"
 #include "../sphere/ProfileTask.h"
@@ -11,6 +12,7 @@
 #include "items/CItem.h"
 #include "CWorld.h"
 #include "CWorldGameTime.h"
+#include "CWorldMap.h"
 #include "CServer.h"
 #include "triggers.h"
 #include "CSector.h"
@@ -18,9 +20,15 @@
 //////////////////////////////////////////////////////////////////
 // -CSector
 
+CSector* CSector::sm_pSectorWaking = nullptr;
+ullong CSector::sm_uiPerceptionLooks = 0;
+ullong CSector::sm_uiPerceptionSnapshots = 0;
+
 CSector::CSector() : CTimedObject(PROFILE_SECTORS)
 {
 	m_ListenItems = 0;
+	_iClientsNearby = 0;
+	_iTimeLastClientNearby = 0;
 
 	m_RainChance = 0;		// 0 to 100%
 	m_ColdChance = 0;		// Will be snow if rain chance success.
@@ -39,6 +47,7 @@ void CSector::Init(int index, uchar map, short x, short y)
 {
 	CSectorBase::Init(index, map, x, y);
 	SetDefaultWeatherChance();
+	m_Chars_Active.SetSector(this);
 }
 
 enum SC_TYPE
@@ -55,6 +64,7 @@ enum SC_TYPE
 	SC_LIGHT,
 	SC_LOCALTIME,
 	SC_LOCALTOD,
+	SC_NEARBYCLIENTS,
 	SC_NUMBER,
 	SC_RAINCHANCE,
 	SC_SEASON,
@@ -76,6 +86,7 @@ lpctstr const CSector::sm_szLoadKeys[SC_QTY+1] =
 	"LIGHT",
 	"LOCALTIME",
 	"LOCALTOD",
+	"NEARBYCLIENTS",
 	"NUMBER",
 	"RAINCHANCE",
 	"SEASON",
@@ -135,6 +146,9 @@ bool CSector::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc,
 		case SC_LOCALTOD:
 			sVal.FormatVal( GetLocalTime());
 			return true;
+		case SC_NEARBYCLIENTS:
+			sVal.FormatVal(_iClientsNearby);
+			return true;
 		case SC_NUMBER:
 			sVal.FormatVal(m_index);
 			return true;
@@ -177,6 +191,10 @@ void CSector::_GoSleep()
     const ProfileTask charactersTask(PROFILE_TIMERS);
     CTimedObject::_GoSleep();
 
+	// Nobody will look around from here for a while.
+	_PerceptionChars.Release();
+	_PerceptionItems.Release();
+
 	for (CSObjContRec* pObjRec : m_Chars_Active)
 	{
 		CChar* pChar = static_cast<CChar*>(pObjRec);
@@ -248,10 +266,9 @@ void CSector::_GoAwake()
     * of NPCs being stop until you enter the sector, or all the spawns
     * generating NPCs at once.
     */
-    static CSector *pCentral = nullptr;   // do this only for the awaken sector
-    if (!pCentral)
+    if (!sm_pSectorWaking)    // do this only for the awaken sector
     {
-        pCentral = this;
+        sm_pSectorWaking = this;
         for (int i = 0; i < (int)DIR_QTY; ++i)
         {
             CSector *pSector = _GetAdjacentSector((DIR_TYPE)i);
@@ -260,7 +277,7 @@ void CSector::_GoAwake()
                 pSector->GoAwake();
             }
         }
-        pCentral = nullptr;
+        sm_pSectorWaking = nullptr;
     }
 
     _OnTick();   // Unknown time passed, make the sector tick now to reflect any possible environ changes.
@@ -1039,6 +1056,9 @@ bool CSector::_CanSleep(bool fCheckAdjacents) const
 
     if (fCheckAdjacents)
     {
+        if (_iClientsNearby > 0)
+            return false;   // at least one client in the adjacent sectors.
+
         for (int i = 0; i < (int)DIR_QTY; ++i)// Check for adjacent's sectors sleeping allowance.
         {
             const CSector *pAdjacent = _GetAdjacentSector((DIR_TYPE)i);    // set this as the last sector to avoid this code in the adjacent one and return if it can sleep or not instead of searching its adjacents.
@@ -1073,6 +1093,83 @@ void CSector::SetSectorWakeStatus()
     }
 }
 
+int CSector::GetClientsNearby() const noexcept
+{
+	return _iClientsNearby;
+}
+
+void CSector::OnClientsNumberChange(int iDelta)
+{
+	ADDTOCALLSTACK("CSector::OnClientsNumberChange");
+	// A client entered or left this sector: update the clients proximity heatmap.
+	_AddClientsNearby(iDelta);
+	for (int i = 0; i < (int)DIR_QTY; ++i)
+	{
+		CSector *pAdjacent = _GetAdjacentSector((DIR_TYPE)i);
+		if (pAdjacent)
+			pAdjacent->_AddClientsNearby(iDelta);
+	}
+}
+
+void CSector::_AddClientsNearby(int iDelta)
+{
+	const bool fWasCold = (_iClientsNearby <= 0);
+	ASSERT(_iClientsNearby + iDelta >= 0);	// every client added to a sector must be removed from it just once
+	_iClientsNearby += iDelta;
+	if (_iClientsNearby <= 0)
+	{
+		if (!fWasCold)
+			_iTimeLastClientNearby = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+	}
+	else if (fWasCold && !_IsSleeping() && (_GetTimerAdjusted() > SECTOR_TICKING_PERIOD))
+	{
+		// Leaving the cold wheel: a client will be able to see this sector soon, go back to the usual ticking period.
+		_SetTimeout(SECTOR_TICKING_PERIOD);
+	}
+}
+
+void CSector::WakeAhead(const CSector* pSectorFrom)
+{
+	ADDTOCALLSTACK("CSector::WakeAhead");
+	// A client moved from pSectorFrom to this sector. The adjacent sectors are already awake, so wake also the next ones
+	//  in the direction of movement, before the client gets there: walking or sailing players won't find frozen NPCs at the edge of the screen.
+	if (!pSectorFrom || (pSectorFrom == this) || (pSectorFrom->m_map != m_map))
+		return;
+
+	static constexpr DIR_TYPE sm_MoveDirs[3][3] =	// [dy+1][dx+1]
+	{
+		{ DIR_NW, DIR_N,   DIR_NE },
+		{ DIR_W,  DIR_QTY, DIR_E  },
+		{ DIR_SW, DIR_S,   DIR_SE }
+	};
+	const int dx = (_x > pSectorFrom->_x) - (_x < pSectorFrom->_x);
+	const int dy = (_y > pSectorFrom->_y) - (_y < pSectorFrom->_y);
+	const DIR_TYPE dir = sm_MoveDirs[dy + 1][dx + 1];
+	if (dir == DIR_QTY)
+		return;
+
+	const CSector *pAdjacent = _GetAdjacentSector(dir);
+	CSector *pAhead = pAdjacent ? pAdjacent->_GetAdjacentSector(dir) : nullptr;
+	if (!pAhead)
+		return;
+
+	CSector *ppWake[3] =
+	{
+		pAhead,
+		pAhead->_GetAdjacentSector(GetDirTurn(dir, 2)),
+		pAhead->_GetAdjacentSector(GetDirTurn(dir, -2))
+	};
+
+	CSector *pPrevWaking = sm_pSectorWaking;
+	sm_pSectorWaking = this;	// don't wake their adjacents too
+	for (CSector *pSector : ppWake)
+	{
+		if (pSector && pSector->IsSleeping())
+			pSector->GoAwake();
+	}
+	sm_pSectorWaking = pPrevWaking;
+}
+
 void CSector::Close()
 {
 	ADDTOCALLSTACK("CSector::Close");
@@ -1143,7 +1240,7 @@ void CSector::Restock()
         CCSpawn* pSpawn = pItem->GetSpawn();
         if (pSpawn)
         {
-            pSpawn->OnTickComponent();
+            pSpawn->SpawnTick();
         }
     }
 }
@@ -1174,7 +1271,7 @@ bool CSector::_OnTick()
 
 	EXC_TRY("Tick");
 
-	const ProfileTask sectorsTask(PROFILE_SECTORS);
+	const ProfileTask sectorsTask((_iClientsNearby > 0) ? PROFILE_SECTORS : PROFILE_SECTORS_COLD);
 
     EXC_SET_BLOCK("light change");
 	// Check for light change before putting the sector to sleep, since in other case the
@@ -1313,7 +1410,23 @@ bool CSector::_OnTick()
 
 	EXC_CATCH;
 
-    _SetTimeout(SECTOR_TICKING_PERIOD);  // Sector is Awake, make it tick after 30 seconds.
+    if (_iClientsNearby > 0)
+    {
+        _SetTimeout(SECTOR_TICKING_PERIOD);  // Sector is Awake, make it tick after 30 seconds.
+    }
+    else
+    {
+        // No clients nearby: nobody can see the environ changes, we only need to check if it can go to sleep.
+        //  Tick it less often (but not after the sleep delay expires), on coarse time slots shared with the other cold sectors.
+        const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+        const int64 iTimeLastClient = GetLastClientTime();
+        const int64 iSleepTimeLeft = maximum(_iTimeLastClientNearby, iTimeLastClient) + g_Cfg._iSectorSleepDelay - iCurTime;
+        int64 iDelay = SECTOR_TICKING_PERIOD_COLD;
+        if ((g_Cfg._iSectorSleepDelay > 0) && !IsFlagSet(SECF_NoSleep) && (iSleepTimeLeft > 0))
+            iDelay = std::clamp<int64>(iSleepTimeLeft + 1, SECTOR_TICKING_PERIOD, SECTOR_TICKING_PERIOD_COLD);
+        const int64 iTimeNext = iCurTime + iDelay;
+        _SetTimeout(iDelay + (SECTOR_TICKING_SLOT_COLD - (iTimeNext % (SECTOR_TICKING_SLOT_COLD))));
+    }
 
 	EXC_DEBUG_START;
 	const CPointMap pt = GetBasePoint();
@@ -1454,3 +1567,125 @@ int64 CSector::GetLastClientTime() const
 	return m_Chars_Active.GetTimeLastClient() ;
 }
 
+
+const CSectorPerception& CSector::GetPerception(bool fItems)
+{
+	ADDTOCALLSTACK("CSector::GetPerception");
+	// The first NPC looking around from here in this tick takes the snapshot, the others reuse it.
+	CSectorPerception& perception = fItems ? _PerceptionItems : _PerceptionChars;
+	const int64 iTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+	++sm_uiPerceptionLooks;
+	if (!perception.IsCurrent(iTime))
+	{
+		perception.Take(this, fItems, iTime);
+		++sm_uiPerceptionSnapshots;
+	}
+	return perception;
+}
+
+bool CSector::WritePerceptionStatsVal(lpctstr ptcKey, CSString& sVal) // static
+{
+	ADDTOCALLSTACK("CSector::WritePerceptionStatsVal");
+	// PERCEPTION.LOOKS: NPC looks around served by the snapshots of the sectors.
+	// PERCEPTION.SNAPSHOTS: snapshots taken for them.
+	// PERCEPTION.SAVED: looks which reused the snapshot of another NPC, instead of searching the world.
+	if (!strcmpi(ptcKey, "LOOKS"))
+		sVal.FormatULLVal(sm_uiPerceptionLooks);
+	else if (!strcmpi(ptcKey, "SNAPSHOTS"))
+		sVal.FormatULLVal(sm_uiPerceptionSnapshots);
+	else if (!strcmpi(ptcKey, "SAVED"))
+		sVal.FormatULLVal(sm_uiPerceptionLooks - sm_uiPerceptionSnapshots);
+	else
+		return false;
+	return true;
+}
+
+
+//////////////////////////////////////////////////////////////////
+// -CSectorPerception
+
+CSectorPerception::CSectorPerception() noexcept :
+	_iTime(-1), _x(0), _y(0), _iCols(0)
+{
+}
+
+void CSectorPerception::Take(const CSector* pSector, bool fItems, int64 iTime)
+{
+	ADDTOCALLSTACK("CSectorPerception::Take");
+	// Cover the sector and UO_MAP_VIEW_RADAR around it: the farthest an NPC inside it can look.
+	const CRectMap rect = pSector->GetRect();
+	const int iSize = rect.m_right - rect.m_left;
+	_x = short(rect.m_left - UO_MAP_VIEW_RADAR);
+	_y = short(rect.m_top - UO_MAP_VIEW_RADAR);
+	_iCols = (iSize + (2 * UO_MAP_VIEW_RADAR) + SECTOR_PERCEPTION_CELL - 1) / SECTOR_PERCEPTION_CELL;
+	_iTime = iTime;
+	_vEntries.clear();
+
+	const CPointMap ptCenter(short(rect.m_left + (iSize / 2)), short(rect.m_top + (iSize / 2)), 0, uchar(pSector->GetMap()));
+	CWorldSearch Area(ptCenter, (iSize / 2) + UO_MAP_VIEW_RADAR);
+	Area.SetSearchSquare(true);
+	for (;;)
+	{
+		const CObjBase* pObj = fItems ? static_cast<const CObjBase*>(Area.GetItem()) : static_cast<const CObjBase*>(Area.GetChar());
+		if (!pObj)
+			break;
+
+		const CPointMap& ptObj = pObj->GetTopPoint();
+		if ((ptObj.m_x < _x) || (ptObj.m_y < _y))
+			continue;
+		const int iCol = (ptObj.m_x - _x) / SECTOR_PERCEPTION_CELL;
+		const int iRow = (ptObj.m_y - _y) / SECTOR_PERCEPTION_CELL;
+		if ((iCol >= _iCols) || (iRow >= _iCols))
+			continue;
+		const dword dwUID = pObj->GetUID().GetPrivateUID();
+		_vEntries.push_back({ dwUID, g_World.GetUIDGeneration(dwUID & UID_O_INDEX_MASK), ptObj.m_x, ptObj.m_y, uint((iRow * _iCols) + iCol) });
+	}
+
+	// Keep the order of the search inside each cell.
+	std::stable_sort(_vEntries.begin(), _vEntries.end(),
+		[](const Entry& a, const Entry& b) noexcept { return (a.uiCell < b.uiCell); });
+
+	_vCellStart.assign(size_t(_iCols * _iCols) + 1, 0);
+	for (const Entry& entry : _vEntries)
+		++_vCellStart[entry.uiCell + 1];
+	for (size_t i = 1; i < _vCellStart.size(); ++i)
+		_vCellStart[i] += _vCellStart[i - 1];
+}
+
+void CSectorPerception::Release() noexcept
+{
+	_iTime = -1;
+	_iCols = 0;
+	std::vector<Entry>().swap(_vEntries);
+	std::vector<uint>().swap(_vCellStart);
+}
+
+void CSectorPerception::Find(const CPointMap& pt, int iRange, std::vector<dword>& vUIDs) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CSectorPerception::Find");
+	if (_iCols <= 0)
+		return;
+
+	const int iColMin = maximum(0, (pt.m_x - iRange - _x) / SECTOR_PERCEPTION_CELL);
+	const int iColMax = minimum(_iCols - 1, (pt.m_x + iRange - _x) / SECTOR_PERCEPTION_CELL);
+	const int iRowMin = maximum(0, (pt.m_y - iRange - _y) / SECTOR_PERCEPTION_CELL);
+	const int iRowMax = minimum(_iCols - 1, (pt.m_y + iRange - _y) / SECTOR_PERCEPTION_CELL);
+	for (int iRow = iRowMin; iRow <= iRowMax; ++iRow)
+	{
+		for (int iCol = iColMin; iCol <= iColMax; ++iCol)
+		{
+			const size_t uiCell = size_t((iRow * _iCols) + iCol);
+			for (uint i = _vCellStart[uiCell]; i < _vCellStart[uiCell + 1]; ++i)
+			{
+				const Entry& entry = _vEntries[i];
+				if ((SphereAbs(entry.x - pt.m_x) > iRange) || (SphereAbs(entry.y - pt.m_y) > iRange))
+					continue;
+				const dword dwIndex = entry.dwUID & UID_O_INDEX_MASK;
+				if (g_World.GetUIDGeneration(dwIndex) != entry.dwGeneration)
+					continue;	// deleted since the snapshot (maybe the UID is already used by another object)
+				g_World.PrefetchUID(dwIndex);	// the caller is going to look it up
+				vUIDs.push_back(entry.dwUID);
+			}
+		}
+	}
+}
@@ -11,12 +11,48 @@
 #include "CSectorTemplate.h"
 #include "CTimedObject.h"
 
-#define SECTOR_TICKING_PERIOD	30 * 1000	// Every 30 seconds.
+#define SECTOR_TICKING_PERIOD		30 * 1000	// Every 30 seconds.
+#define SECTOR_TICKING_PERIOD_COLD	3 * 60 * 1000	// Every 3 minutes, for the awake sectors without clients nearby.
+#define SECTOR_TICKING_SLOT_COLD	10 * 1000	// Ticks of the cold sectors are aligned to 10 seconds slots, to share the same ticking list entries.
+#define SECTOR_PERCEPTION_CELL		8			// Side (in tiles) of the cells grouping the objects of the NPC perception snapshots.
 
 
 class CChar;
 class CItemStone;
 class CItemMulti;
+class CSector;
+
+
+// Chars or items around a sector, as seen by the NPCs looking around from it (NPC_LookAround).
+// Taken by the first NPC looking in a tick and shared by the others, instead of each one searching the nearby sectors.
+// The objects are grouped in cells, so a look only checks the cells in its range.
+class CSectorPerception
+{
+	struct Entry
+	{
+		dword dwUID;
+		dword dwGeneration;		// of the UID when the snapshot was taken
+		short x, y;
+		uint uiCell;
+	};
+
+	int64 _iTime;					// Tick of the snapshot (-1 = never taken).
+	short _x, _y;					// Upper left corner of the covered area.
+	int _iCols;						// Cells in each row (and column) of the covered area.
+	std::vector<Entry> _vEntries;	// Ordered by cell.
+	std::vector<uint> _vCellStart;	// Index of the first entry of each cell, followed by the end of the entries.
+
+public:
+	CSectorPerception() noexcept;
+
+	bool IsCurrent(int64 iTime) const noexcept { return (_iTime == iTime); }
+	void Take(const CSector* pSector, bool fItems, int64 iTime);
+	void Release() noexcept;
+
+	// UIDs of the objects within iRange (UO sight distance) of pt, which must be in the sector (skipping the UIDs freed since the snapshot).
+	void Find(const CPointMap& pt, int iRange, std::vector<dword>& vUIDs) const;
+};
+
 
 class CSector : public CScriptObj, public CSectorBase, public CTimedObject	// square region of the world.
 {
@@ -34,6 +70,15 @@ private:
 	byte m_ColdChance;		// Will be snow if rain chance success.
 	byte m_ListenItems;		// Items on the ground that listen ?
 
+	int   _iClientsNearby;			// Clients in this sector and in the adjacent ones (this sector's cell in the clients proximity heatmap).
+	int64 _iTimeLastClientNearby;	// Last time the sector had clients nearby.
+	static CSector* sm_pSectorWaking;	// Sector being awaken: its adjacents are awaken together with it, but they don't wake their own adjacents.
+
+	CSectorPerception _PerceptionChars;	// What the NPCs in this sector can see in the current tick.
+	CSectorPerception _PerceptionItems;
+	static ullong sm_uiPerceptionLooks;		// NPC looks served by the snapshots...
+	static ullong sm_uiPerceptionSnapshots;	// ...and snapshots taken for them.
+
 private:
 	WEATHER_TYPE GetWeatherCalc() const;
 	byte GetLightCalc( bool fQuickSet ) const;
@@ -106,9 +151,23 @@ public:		virtual bool IsDeleted() const override;
 	int64 GetLastClientTime() const;
 	bool MoveCharToSector(CChar* pChar);
 
+	// NPC perception.
+	const CSectorPerception& GetPerception(bool fItems);
+	static ullong GetPerceptionLooks() noexcept { return sm_uiPerceptionLooks; }
+	static ullong GetPerceptionSnapshots() noexcept { return sm_uiPerceptionSnapshots; }
+	static bool WritePerceptionStatsVal(lpctstr ptcKey, CSString& sVal);
+
 	bool _CanSleep(bool fCheckAdjacents) const;
 	void SetSectorWakeStatus();	// Ships may enter a sector before it's riders !
 
+	// Clients proximity.
+	int GetClientsNearby() const noexcept;
+	void OnClientsNumberChange(int iDelta);
+	void WakeAhead(const CSector* pSectorFrom);
+private:
+	void _AddClientsNearby(int iDelta);
+public:
+
 	// CTimedObject
 private:
     virtual void _GoSleep() override;
@@ -28,6 +28,7 @@ CCharsActiveList::CCharsActiveList()
 {
 	m_iTimeLastClient = 0;
 	m_iClients = 0;
+	_pSector = nullptr;
 }
 
 void CCharsActiveList::OnRemoveObj(CSObjContRec* pObjRec )
@@ -39,6 +40,7 @@ void CCharsActiveList::OnRemoveObj(CSObjContRec* pObjRec )
 	CSObjCont::OnRemoveObj(pObjRec);
 
 	CChar* pChar = static_cast<CChar*>(pObjRec);
+	RemoveClientChar(pChar);
 	if (pChar->IsClientType())
 	{
 		--m_iClients;
@@ -59,6 +61,7 @@ void CCharsActiveList::AddCharActive( CChar * pChar )
 		CSObjCont::InsertContentTail(pChar); // this also removes the Char from the old sector
 		if (pChar->IsClientActive())
 		{
+			AddClientChar(pChar);
 			++m_iClients;
 		}
 	}
@@ -68,6 +71,32 @@ void CCharsActiveList::AddCharActive( CChar * pChar )
     pChar->RemoveUIDFlags(UID_O_DISCONNECT);
 }
 
+void CCharsActiveList::AddClientChar(CChar* pChar)
+{
+	ADDTOCALLSTACK("CCharsActiveList::AddClientChar");
+	// Usually there are only a few clients in a sector, a plain vector is faster than any other container.
+	if (std::find(_vClientChars.begin(), _vClientChars.end(), pChar) != _vClientChars.end())
+		return;
+	_vClientChars.emplace_back(pChar);
+	// Update the heatmap here and in RemoveClientChar, so that attaching/detaching a client to a char in the world is counted too.
+	if (_pSector)
+		_pSector->OnClientsNumberChange(1);
+}
+
+void CCharsActiveList::RemoveClientChar(const CChar* pChar)
+{
+	ADDTOCALLSTACK("CCharsActiveList::RemoveClientChar");
+	const auto it = std::find(_vClientChars.begin(), _vClientChars.end(), pChar);
+	if (it != _vClientChars.end())
+	{
+		// The order doesn't matter.
+		*it = _vClientChars.back();
+		_vClientChars.pop_back();
+		if (_pSector)
+			_pSector->OnClientsNumberChange(-1);
+	}
+}
+
 //////////////////////////////////////////////////////////////
 // -CItemList
 
@@ -10,6 +10,7 @@
 #include "../common/sphere_library/CSObjSortArray.h"
 #include "../common/CRect.h"
 #include "CTeleport.h"
+#include <vector>
 
 
 class CItem;
@@ -30,6 +31,8 @@ struct CCharsActiveList : public CSObjCont
 private:
 	int m_iClients;				// How many clients in this sector now?
 	int64 m_iTimeLastClient;	// age the sector based on last client here.
+	CSector* _pSector;			// sector owning this list, to be notified when the clients number changes.
+	std::vector<CChar*> _vClientChars;	// chars in this sector with a client attached, to find quickly the clients near a point.
     
 protected:
 	void OnRemoveObj(CSObjContRec* pObjRec);	// Override this = called when removed from list.
@@ -49,6 +52,15 @@ public:
 	void SetTimeLastClient(int64 iTime) noexcept {
 		m_iTimeLastClient = iTime;
 	}
+	void SetSector(CSector* pSector) noexcept {
+		_pSector = pSector;
+	}
+
+	void AddClientChar(CChar* pChar);
+	void RemoveClientChar(const CChar* pChar);
+	const std::vector<CChar*>& GetClientChars() const noexcept {
+		return _vClientChars;
+	}
 };
 
 struct CItemsList : public CSObjCont
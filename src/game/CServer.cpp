@@ -19,6 +19,9 @@
 #include "../network/CClientIterator.h"
 #include "../network/CIPHistoryManager.h"
 #include "../network/CNetworkManager.h"
+#include "../network/CPacketPool.h"
+#include "../sphere/asyncauth.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ProfileTask.h"
 #include "../sphere/ntwindow.h"
 #include "chars/CChar.h"
@@ -26,8 +29,12 @@
 #include "clients/CChatChannel.h"
 #include "clients/CClient.h"
 #include "items/CItemShip.h"
+#include "CBenchmark.h"
 #include "CScriptProfiler.h"
+#include "CSector.h"
 #include "CServer.h"
+#include "CTickScheduler.h"
+#include "uo_files/CUOMapList.h"
 #include "CWorld.h"
 #include "CWorldComm.h"
 #include "CWorldGameTime.h"
@@ -1105,6 +1112,128 @@ void CServer::ProfileDump( CTextConsole * pSrc, bool bDump )
 		}
 	}
 
+	// Sectors activity: the awake sectors with clients nearby tick as SECTORS, the other awake ones as SECTORS_COLD.
+	{
+		int iSectorsHot = 0, iSectorsCold = 0, iSectorsSleeping = 0;
+		const CSectorList* pSectors = CSectorList::Get();
+		for (int iMap = 0; iMap < MAP_SUPPORTED_QTY; ++iMap)
+		{
+			const int iQty = pSectors->GetSectorQty(iMap);
+			for (int iSector = 0; iSector < iQty; ++iSector)
+			{
+				const CSector* pSector = pSectors->GetSector(iMap, iSector);
+				if (pSector->IsSleeping())
+					++iSectorsSleeping;
+				else if (pSector->GetClientsNearby() > 0)
+					++iSectorsHot;
+				else
+					++iSectorsCold;
+			}
+		}
+
+		if (pSrc != this)
+		{
+			pSrc->SysMessagef("Sectors: %d awake (%d with clients nearby, %d cold), %d sleeping\n", iSectorsHot + iSectorsCold, iSectorsHot, iSectorsCold, iSectorsSleeping);
+		}
+		else
+		{
+			g_Log.Event(LOGL_EVENT, "Sectors: %d awake (%d with clients nearby, %d cold), %d sleeping\n", iSectorsHot + iSectorsCold, iSectorsHot, iSectorsCold, iSectorsSleeping);
+		}
+		if (ftDump != nullptr)
+		{
+			ftDump->Printf("Sectors: %d awake (%d with clients nearby, %d cold), %d sleeping\n", iSectorsHot + iSectorsCold, iSectorsHot, iSectorsCold, iSectorsSleeping);
+		}
+	}
+
+	// Map blocks cache.
+	{
+		const CWorldCache& cache = g_World._Cache;
+		CSString sLine, sMap;
+		sLine.Format("Map cache: %" PRIuSIZE_T " KB\n", cache.GetMapBlocksSize() / 1024);
+		for (int iMap = 0; iMap < MAP_SUPPORTED_QTY; ++iMap)
+		{
+			if (!g_MapList.IsInitialized(iMap))
+				continue;
+			sMap.Format("  map%d: %" PRIuSIZE_T " blocks, %llu hits, %llu misses, %llu evictions\n", iMap,
+				cache.GetMapBlocksCount(iMap), cache.GetMapBlocksHits(iMap), cache.GetMapBlocksMisses(iMap), cache.GetMapBlocksEvictions(iMap));
+			sLine += sMap.GetBuffer();
+		}
+
+		if (pSrc != this)
+		{
+			pSrc->SysMessage(sLine.GetBuffer());
+		}
+		else
+		{
+			g_Log.Event(LOGL_EVENT, "%s", sLine.GetBuffer());
+		}
+		if (ftDump != nullptr)
+		{
+			ftDump->Printf("%s", sLine.GetBuffer());
+		}
+	}
+
+	// Async password verification.
+	if (g_asyncAuth.isEnabled())
+	{
+		CSString sLine;
+		sLine.Format("Auth threads: %" PRIuSIZE_T " pending, %llu verified, avg %lld ms, max %lld ms latency\n",
+			g_asyncAuth.getPending(), g_asyncAuth.getProcessed(), g_asyncAuth.getLatencyAvg(), g_asyncAuth.getLatencyMax());
+
+		if (pSrc != this)
+		{
+			pSrc->SysMessage(sLine.GetBuffer());
+		}
+		else
+		{
+			g_Log.Event(LOGL_EVENT, "%s", sLine.GetBuffer());
+		}
+		if (ftDump != nullptr)
+		{
+			ftDump->Printf("%s", sLine.GetBuffer());
+		}
+	}
+
+	// Log writer thread.
+	if (g_Log.IsQueueActive())
+	{
+		CSString sLine;
+		sLine.Format("Log queue: %" PRIuSIZE_T " lines waiting, %llu logged, %llu waited for room, %llu dropped\n",
+			g_Log.GetQueueUsed(), g_Log.GetQueuedLines(), g_Log.GetWaitedLines(), g_Log.GetDroppedLines());
+
+		if (pSrc != this)
+		{
+			pSrc->SysMessage(sLine.GetBuffer());
+		}
+		else
+		{
+			g_Log.Event(LOGL_EVENT, "%s", sLine.GetBuffer());
+		}
+		if (ftDump != nullptr)
+		{
+			ftDump->Printf("%s", sLine.GetBuffer());
+		}
+	}
+
+	// Packets memory pool, and packets built by id.
+	{
+		CSString sLine;
+		PacketPool::dump(sLine);
+
+		if (pSrc != this)
+		{
+			pSrc->SysMessage(sLine.GetBuffer());
+		}
+		else
+		{
+			g_Log.Event(LOGL_EVENT, "%s", sLine.GetBuffer());
+		}
+		if (ftDump != nullptr)
+		{
+			ftDump->Printf("%s", sLine.GetBuffer());
+		}
+	}
+
 	if ( IsSetEF(EF_Script_Profiler) )
 	{
         if (g_profiler.initstate != 0xf1)
@@ -1657,15 +1786,19 @@ bool CServer::r_Verb( CScript &s, CTextConsole * pSrc )
 
 		case SV_INFORMATION:
             {
+                CSString sTickStats;
+                g_TickScheduler.WriteStats(sTickStats);
                 if (pSrc != this)
                 {
                     pSrc->SysMessage(GetStatusString(0x22));
                     pSrc->SysMessage(GetStatusString(0x24));
+                    pSrc->SysMessage(sTickStats.GetBuffer());
                 }
                 else
                 {
                     g_Log.Event(LOGL_EVENT, "%s", GetStatusString(0x22));
                     g_Log.Event(LOGL_EVENT, "%s", GetStatusString(0x24));
+                    g_Log.Event(LOGL_EVENT, "%s", sTickStats.GetBuffer());
                 }
             }
 			break;
@@ -1910,6 +2043,7 @@ bool CServer::CommandLine( int argc, tchar * argv[] )
 			case '?':
 				PrintStr( SPHERE_TITLE " \n"
 					"Command Line Switches:\n"
+					"-B#[,path/] Benchmark: run # world ticks (replaying the input recorded in path/), report and quit.\n"
 #ifdef _WIN32
 					"-Cclassname Setup custom window class name for sphere (default: " SPHERE_TITLE ").\n"
 #else
@@ -1928,6 +2062,7 @@ bool CServer::CommandLine( int argc, tchar * argv[] )
 					"-P# Set the port number.\n"
 					"-Ofilename Output console to this file name\n"
 					"-Q Quit when finished.\n"
+					"-Rpath/ Record the input of the clients in path/.\n"
 					);
 				return false;
 #ifdef _WIN32
@@ -1943,6 +2078,9 @@ bool CServer::CommandLine( int argc, tchar * argv[] )
 				g_UnixTerminal.setColorEnabled(false);
 				continue;
 #endif
+			case 'B':
+				g_Benchmark.SetArgs(pArg + 1);
+				continue;
 			case 'P':
 				m_ip.SetPort((word)(atoi(pArg + 1)));
 				continue;
@@ -2004,6 +2142,9 @@ bool CServer::CommandLine( int argc, tchar * argv[] )
 				continue;
 			case 'Q':
 				return false;
+			case 'R':
+				g_Benchmark.SetRecordPath(pArg + 1);
+				continue;
 			default:
 				g_Log.Event(LOGM_INIT|LOGL_CRIT, "Can't recognize command line data '%s'\n", static_cast<lpctstr>(argv[argn]));
 				break;
@@ -2211,9 +2352,41 @@ void CServer::_OnTick()
 	EXC_SET_BLOCK("generic");
 	g_Cfg._OnTick(false);
 	_hDb._OnTick();
+
+	EXC_SET_BLOCK("metrics");
+	if ( g_Metrics.IsSampleDue(CSTime::GetPreciseSysTimeMilli()) )
+		SampleMetrics();
 	EXC_CATCH;
 }
 
+void CServer::SampleMetrics()
+{
+	ADDTOCALLSTACK("CServer::SampleMetrics");
+	// Gauges and counters kept elsewhere, copied in the metrics so that they can be exported from any thread.
+	g_Metrics.Set(METRIC_CLIENTS, (llong)StatGet(SERV_STAT_CLIENTS));
+	g_Metrics.Set(METRIC_CHARS, (llong)StatGet(SERV_STAT_CHARS));
+	g_Metrics.Set(METRIC_ITEMS, (llong)StatGet(SERV_STAT_ITEMS));
+
+	const CWorldCache& cache = g_World._Cache;
+	ullong uiHits = 0, uiMisses = 0, uiEvictions = 0;
+	for (int iMap = 0; iMap < MAP_SUPPORTED_QTY; ++iMap)
+	{
+		uiHits += cache.GetMapBlocksHits(iMap);
+		uiMisses += cache.GetMapBlocksMisses(iMap);
+		uiEvictions += cache.GetMapBlocksEvictions(iMap);
+	}
+	g_Metrics.Set(METRIC_MAPCACHE_HITS, (llong)uiHits);
+	g_Metrics.Set(METRIC_MAPCACHE_MISSES, (llong)uiMisses);
+	g_Metrics.Set(METRIC_MAPCACHE_EVICTIONS, (llong)uiEvictions);
+	g_Metrics.Set(METRIC_MAPCACHE_BYTES, (llong)cache.GetMapBlocksSize());
+
+	g_Metrics.Set(METRIC_LOG_LINES, (llong)g_Log.GetQueuedLines());
+	g_Metrics.Set(METRIC_LOG_DROPPED_LINES, (llong)g_Log.GetDroppedLines());
+
+	g_Metrics.Set(METRIC_NPC_LOOKS, (llong)CSector::GetPerceptionLooks());
+	g_Metrics.Set(METRIC_NPC_PERCEPTION_SNAPSHOTS, (llong)CSector::GetPerceptionSnapshots());
+}
+
 bool CServer::Load()
 {
 	EXC_TRY("Load");
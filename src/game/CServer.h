@@ -70,6 +70,7 @@ public:
 
 private:
 	void ProfileDump( CTextConsole * pSrc, bool bDump = false );
+	void SampleMetrics();
 
 public:
 	CServer();
@@ -4,6 +4,7 @@
 #include "../common/resource/sections/CRandGroupDef.h"
 #include "../common/resource/sections/CRegionResourceDef.h"
 #include "../common/resource/sections/CResourceNamedDef.h"
+#include "../common/resource/sections/CSpeechDef.h"
 #include "../common/sphere_library/CSFileList.h"
 #include "../common/CException.h"
 #include "../common/CUOInstall.h"
@@ -11,6 +12,7 @@
 #include "../network/CClientIterator.h"
 #include "../network/CNetworkManager.h"
 #include "../network/CSocket.h"
+#include "../sphere/asyncscript.h"
 #include "../sphere/ProfileTask.h"
 #include "../sphere/ntwindow.h"
 #include "clients/CAccount.h"
@@ -41,6 +43,7 @@ CServerConfig::CServerConfig()
 	m_fUseNTService		= false;
 	m_fUseHTTP			= 2;
 	m_fUseAuthID		= true;
+	_uiMapCacheSize		= 256;
 	_iMapCacheTime		= 2  * 60 * MSECS_PER_SEC;
 	_iSectorSleepDelay  = 10 * 60 * MSECS_PER_SEC;
 	m_fUseMapDiffs		= false;
@@ -48,8 +51,12 @@ CServerConfig::CServerConfig()
 	m_iDebugFlags			= 0;	//DEBUGF_NPC_EMOTE
 	m_fSecure				= true;
 	m_iFreezeRestartTime	= 60;
+	_iWorldTickPeriod		= 10;
+	_iScriptLoadThreads		= 4;
+	_iLogQueueLength		= 4096;
 	m_bAgree				= false;
 	m_fMd5Passwords			= false;
+	_iAuthThreads			= 2;
 
 	//Magic
 	m_fManaLossAbort		= false;
@@ -79,6 +86,8 @@ CServerConfig::CServerConfig()
 	m_iDecay_Item			= 30*60 * MSECS_PER_SEC;
 	m_iDecay_CorpsePlayer	= 7*60 * MSECS_PER_SEC;
 	m_iDecay_CorpseNPC		= 7*60 * MSECS_PER_SEC;
+	_iDecayBucketTime		= 60 * MSECS_PER_SEC;
+	_uiSpawnsPerTick		= 100;
 
 	// Accounts
 	m_iClientsMax		= FD_SETSIZE-1;
@@ -299,6 +308,7 @@ CServerConfig::CServerConfig()
 	_uiNetworkThreadPriority= IThread::Disabled;
 	m_fUseAsyncNetwork		= 0;
 	m_iNetMaxPings			= 15;
+	_iNetMaxPingsSubnet		= 0;
 	m_iNetHistoryTTL		= 300;
 	_uiNetMaxPacketsPerTick = 50;
 	_uiNetMaxLengthPerTick	= 18'000;
@@ -307,6 +317,7 @@ CServerConfig::CServerConfig()
 	_iMaxSizeClientIn		= 10'000;
 	m_fUsePacketPriorities	= false;
 	m_fUseExtraBuffer		= true;
+	_uiStatusUpdateBudget	= 1'500;
 
 	m_iTooltipCache			= 30 * MSECS_PER_SEC;
 	m_iTooltipMode			= TOOLTIPMODE_SENDVERSION;
@@ -445,6 +456,7 @@ enum RC_TYPE
 	RC_ARRIVEDEPARTMSG,
 	RC_ATTACKERTIMEOUT,			// m_iAttackerTimeout
 	RC_ATTACKINGISACRIME,		// m_fAttackingIsACrime
+	RC_AUTHTHREADS,				// _iAuthThreads
     RC_AUTOHOUSEKEYS,           // _fAutoHouseKeys
 	RC_AUTONEWBIEKEYS,			// m_fAutoNewbieKeys
 	RC_AUTOPRIVFLAGS,			// m_iAutoPrivFlags
@@ -501,6 +513,7 @@ enum RC_TYPE
 	RC_DEADCANNOTSEELIVING,
 	RC_DEADSOCKETTIME,
 	RC_DEBUGFLAGS,
+	RC_DECAYBUCKETTIME,			// _iDecayBucketTime
 	RC_DECAYTIMER,
 	RC_DEFAULTCOMMANDLEVEL,		//m_iDefaultCommandLevel
 	RC_DISPLAYPERCENTAR,	    //m_fDisplayPercentAr
@@ -561,6 +574,7 @@ enum RC_TYPE
 	RC_LOCALIPADMIN,			// m_fLocalIPAdmin
 	RC_LOG,
 	RC_LOGMASK,					// GetLogMask
+	RC_LOGQUEUELENGTH,			// _iLogQueueLength
 	RC_LOOTINGISACRIME,			// m_fLootingIsACrime
 	RC_LOSTNPCTELEPORT,			// m_fLostNPCTeleport
 	RC_MAGICFLAGS,
@@ -568,6 +582,7 @@ enum RC_TYPE
 	RC_MANALOSSABORT,			// m_fManaLossAbort
     RC_MANALOSSFAIL,			// m_fManaLossFail
 	RC_MANALOSSPERCENT,			// m_fManaLossPercent
+	RC_MAPCACHESIZE,
 	RC_MAPCACHETIME,
 	RC_MAXBASESKILL,			// m_iMaxBaseSkill
 	RC_MAXCHARSPERACCOUNT,		//
@@ -581,6 +596,7 @@ enum RC_TYPE
 	RC_MAXLOOPTIMES,			// m_iMaxLoopTimes
 	RC_MAXPACKETSPERTICK,		// _uiNetMaxPacketsPerTick
 	RC_MAXPINGS,				// m_iNetMaxPings
+	RC_MAXPINGSSUBNET,			// _iNetMaxPingsSubnet
 	RC_MAXPOLYSTATS,			// m_iMaxPolyStats
 	RC_MAXQUEUESIZE,			// m_iNetMaxQueueSize
 	RC_MAXSECTORCOMPLEXITY,		// m_iMaxSectorComplexity
@@ -594,6 +610,7 @@ enum RC_TYPE
 	RC_MD5PASSWORDS,			// m_fMd5Passwords
 	RC_MEDITATIONMOVEMENTABORT,  // _fMeditationMovementAbort
 	RC_MEDIUMCANHEARGHOSTS,		// m_iMediumCanHearGhosts
+	RC_METRICSPAGE,				// _sMetricsPage
 	RC_MINCHARDELETETIME,
 	RC_MINKARMA,				// m_iMinKarma
 	RC_MONSTERFEAR,				// m_fMonsterFear
@@ -648,10 +665,12 @@ enum RC_TYPE
 	RC_SAVESECTORSPERTICK,		// m_iSaveSectorsPerTick
     RC_SAVESTEPMAXCOMPLEXITY,	// m_iSaveStepMaxComplexity
 	RC_SCPFILES,
+	RC_SCRIPTLOADTHREADS,		// _iScriptLoadThreads
 	RC_SECTORSLEEP,				// _iSectorSleepDelay
 	RC_SECURE,
 	RC_SKILLPRACTICEMAX,		// m_iSkillPracticeMax
 	RC_SNOOPCRIMINAL,
+	RC_SPAWNSPERTICK,			// _uiSpawnsPerTick
 	RC_SPEECHOTHER,
 	RC_SPEECHPET,
 	RC_SPEECHSELF,
@@ -660,6 +679,7 @@ enum RC_TYPE
 	RC_STAMINALOSSATWEIGHT,		// m_iStaminaLossAtWeight
 	RC_STAMINALOSSOVERWEIGHT,	// m_iStaminaLossOverweight
 	RC_STATSFLAGS,				// _uiStatFlag
+	RC_STATUSUPDATEBUDGET,		// _uiStatusUpdateBudget
 	RC_STRIPPATH,				// for TNG
 	RC_SUPPRESSCAPITALS,
 	RC_TELEPORTEFFECTNPC,		// m_iSpell_Teleport_Effect_NPC
@@ -697,6 +717,7 @@ enum RC_TYPE
 	RC_WOPPLAYER,
 	RC_WOPSTAFF,
 	RC_WORLDSAVE,
+	RC_WORLDTICKPERIOD,			// _iWorldTickPeriod
 	RC_ZEROPOINT,				// m_sZeroPoint
 	RC_QTY
 };
@@ -716,6 +737,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "ARRIVEDEPARTMSG",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iArriveDepartMsg)		}},
 	{ "ATTACKERTIMEOUT",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iAttackerTimeout)		}},
 	{ "ATTACKINGISACRIME",		{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fAttackingIsACrime)	}},
+	{ "AUTHTHREADS",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iAuthThreads)			}},
     { "AUTOHOUSEKEYS",          { ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,_fAutoHouseKeys)			}},
 	{ "AUTONEWBIEKEYS",			{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fAutoNewbieKeys)		}},
 	{ "AUTOPRIVFLAGS",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iAutoPrivFlags)		}},
@@ -772,6 +794,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "DEADCANNOTSEELIVING",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_fDeadCannotSeeLiving)	}},
 	{ "DEADSOCKETTIME",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iDeadSocketTime)		}},
 	{ "DEBUGFLAGS",				{ ELEM_MASK_INT,static_cast<uint>OFFSETOF(CServerConfig,m_iDebugFlags)			}},
+	{ "DECAYBUCKETTIME",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iDecayBucketTime)		}},
 	{ "DECAYTIMER",				{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iDecay_Item)			}},
 	{ "DEFAULTCOMMANDLEVEL",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iDefaultCommandLevel)	}},
 	{ "DISPLAYARMORASPERCENT",  { ELEM_BOOL,    static_cast<uint>OFFSETOF(CServerConfig,m_fDisplayPercentAr)		}},
@@ -832,6 +855,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "LOCALIPADMIN",			{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fLocalIPAdmin),		}}, // The local ip is assumed to be the admin.
 	{ "LOG",					{ ELEM_VOID,	0												}},
 	{ "LOGMASK",				{ ELEM_VOID,	0												}}, // GetLogMask
+	{ "LOGQUEUELENGTH",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iLogQueueLength)		}},
 	{ "LOOTINGISACRIME",		{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fLootingIsACrime)		}},
 	{ "LOSTNPCTELEPORT",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iLostNPCTeleport)		}},
 	{ "MAGICFLAGS",				{ ELEM_MASK_INT,static_cast<uint>OFFSETOF(CServerConfig,m_iMagicFlags)			}},
@@ -839,6 +863,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "MANALOSSABORT",		    { ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fManaLossAbort)		}},
     { "MANALOSSFAIL",		    { ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fManaLossFail)			}},
 	{ "MANALOSSPERCENT",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_fManaLossPercent)		}},
+	{ "MAPCACHESIZE",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_uiMapCacheSize)		}},
 	{ "MAPCACHETIME",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iMapCacheTime)			}},
 	{ "MAXBASESKILL",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMaxBaseSkill)			}},
 	{ "MAXCHARSPERACCOUNT",		{ ELEM_BYTE,	static_cast<uint>OFFSETOF(CServerConfig,m_iMaxCharsPerAccount)	}},
@@ -852,6 +877,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "MAXLOOPTIMES",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMaxLoopTimes)			}},
 	{ "MAXPACKETSPERTICK",		{ ELEM_MASK_INT,static_cast<uint>OFFSETOF(CServerConfig,_uiNetMaxPacketsPerTick)	}},
 	{ "MAXPINGS",				{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iNetMaxPings)			}},
+	{ "MAXPINGSSUBNET",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iNetMaxPingsSubnet)		}},
 	{ "MAXPOLYSTATS",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMaxPolyStats)			}},
 	{ "MAXQUEUESIZE",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iNetMaxQueueSize)		}},
 	{ "MAXSECTORCOMPLEXITY",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMaxSectorComplexity)	}},
@@ -865,6 +891,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "MD5PASSWORDS",			{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fMd5Passwords) 		}},
 	{ "MEDITATIONMOVEMENTABORT",{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,_fMeditationMovementAbort)	}},
 	{ "MEDIUMCANHEARGHOSTS",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMediumCanHearGhosts)	}},
+	{ "METRICSPAGE",			{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,_sMetricsPage)			}},
 	{ "MINCHARDELETETIME",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMinCharDeleteTime)	}},
 	{ "MINKARMA",				{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iMinKarma)				}},
 	{ "MONSTERFEAR",			{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fMonsterFear)			}},
@@ -919,10 +946,12 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "SAVESECTORSPERTICK",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iSaveSectorsPerTick)	}},
 	{ "SAVESTEPMAXCOMPLEXITY",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iSaveStepMaxComplexity)}},
 	{ "SCPFILES",				{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sSCPBaseDir)			}},
+	{ "SCRIPTLOADTHREADS",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iScriptLoadThreads)	}},
 	{ "SECTORSLEEP",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iSectorSleepDelay)		}},
 	{ "SECURE",					{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fSecure)				}},
 	{ "SKILLPRACTICEMAX",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iSkillPracticeMax)		}},
 	{ "SNOOPCRIMINAL",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iSnoopCriminal)		}},
+	{ "SPAWNSPERTICK",			{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_uiSpawnsPerTick)		}},
 	{ "SPEECHOTHER",			{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sSpeechOther)			}},
 	{ "SPEECHPET",				{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sSpeechPet)			}},
 	{ "SPEECHSELF",				{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sSpeechSelf)			}},
@@ -931,6 +960,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "STAMINALOSSATWEIGHT",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iStaminaLossAtWeight)	}},
 	{ "STAMINALOSSOVERWEIGHT",	{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iStaminaLossOverweight)	}},
 	{ "STATSFLAGS",				{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_uiStatFlag)				}},
+	{ "STATUSUPDATEBUDGET",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_uiStatusUpdateBudget)	}},
 	{ "STRIPPATH",				{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_sStripPath)			}},
 	{ "SUPPRESSCAPITALS",		{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fSuppressCapitals)		}},
 	{ "TELEPORTEFFECTNPC",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,m_iSpell_Teleport_Effect_NPC)	}},
@@ -968,6 +998,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1]
 	{ "WOPPLAYER",				{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fWordsOfPowerPlayer)	}},
 	{ "WOPSTAFF",				{ ELEM_BOOL,	static_cast<uint>OFFSETOF(CServerConfig,m_fWordsOfPowerStaff)	}},
 	{ "WORLDSAVE",				{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sWorldBaseDir)			}},
+	{ "WORLDTICKPERIOD",		{ ELEM_INT,		static_cast<uint>OFFSETOF(CServerConfig,_iWorldTickPeriod)		}},
 	{ "ZEROPOINT",				{ ELEM_CSTRING,	static_cast<uint>OFFSETOF(CServerConfig,m_sZeroPoint)			}},
 	{ nullptr,					{ ELEM_VOID,	0,												}}
 };
@@ -1196,6 +1227,12 @@ bool CServerConfig::r_LoadVal( CScript &s )
 		case RC_DEADSOCKETTIME:
 			m_iDeadSocketTime = s.GetArgLLVal()*60*MSECS_PER_SEC;
 			break;
+		case RC_DECAYBUCKETTIME:
+		{
+			const llong iVal = s.GetArgLLVal();
+			_iDecayBucketTime = maximum(iVal, 0) * MSECS_PER_SEC;
+			break;
+		}
 		case RC_DECAYTIMER:
 			m_iDecay_Item = s.GetArgLLVal() * 60 * MSECS_PER_SEC;
 			break;
@@ -1360,6 +1397,18 @@ bool CServerConfig::r_LoadVal( CScript &s )
             m_iSaveStepMaxComplexity = s.GetArgUVal();
             break;
 
+        case RC_SPAWNSPERTICK:
+        {
+            const int iVal = s.GetArgVal();
+            if (iVal < 0)
+            {
+                g_Log.EventWarn("SpawnsPerTick can't be negative (use 0 for no limit), keeping the value %u.\n", _uiSpawnsPerTick);
+                break;
+            }
+            _uiSpawnsPerTick = (uint)iVal;
+        }
+		break;
+
 		case RC_WORLDSAVE: // Put save files here.
 			m_sWorldBaseDir = CSFile::GetMergedFileName( s.GetArgStr(), "" );
 			break;
@@ -2010,6 +2059,9 @@ bool CServerConfig::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole *
 		case RC_DEADSOCKETTIME:
 			sVal.FormatLLVal( m_iDeadSocketTime / (60*MSECS_PER_SEC));
 			break;
+		case RC_DECAYBUCKETTIME:
+			sVal.FormatLLVal(_iDecayBucketTime / MSECS_PER_SEC);
+			break;
 		case RC_DECAYTIMER:
 			sVal.FormatLLVal( m_iDecay_Item / (60*MSECS_PER_SEC));
 			break;
@@ -3327,7 +3379,6 @@ bool CServerConfig::LoadResourceSection( CScript * pScript )
 	case RES_NAMES:
 	case RES_NEWBIE:
 	case RES_TIP:
-	case RES_SPEECH:
 	case RES_SCROLL:
 	case RES_SKILLMENU:
 		// Just index this for access later.
@@ -3347,13 +3398,33 @@ bool CServerConfig::LoadResourceSection( CScript * pScript )
 			m_ResHash.AddSortKey( rid, pNewLink );
 		}
 		break;
+	case RES_SPEECH:
+		// Just index this for access later. The ON= patterns are compiled when the speech is first heard.
+		pPrvDef = RegisteredResourceGetDef( rid );
+		if ( pPrvDef )
+		{
+			pNewLink = dynamic_cast <CSpeechDef*>(pPrvDef);
+			ASSERT(pNewLink);
+		}
+		else
+		{
+			pNewLink = new CSpeechDef( rid );
+			ASSERT(pNewLink);
+			CResourceScript* pLinkResScript = dynamic_cast<CResourceScript*>(pScript);
+			if (pLinkResScript != nullptr)
+				pNewLink->SetLink(pLinkResScript);	// So later i can retrieve m_iResourceFileIndex and m_iLineNum from the CResourceScript
+			m_ResHash.AddSortKey( rid, pNewLink );
+		}
+		break;
 	case RES_DIALOG:
 		// Just index this for access later.
 		pPrvDef = RegisteredResourceGetDef( rid );
 		if ( pPrvDef )
 		{
-			pNewLink = dynamic_cast <CDialogDef*>(pPrvDef);
-			ASSERT(pNewLink);
+			CDialogDef* pDialogDef = dynamic_cast <CDialogDef*>(pPrvDef);
+			ASSERT(pDialogDef);
+			pDialogDef->ClearCompiledLayout();	// the script may have changed
+			pNewLink = pDialogDef;
 		}
 		else
 		{
@@ -4607,6 +4678,13 @@ bool CServerConfig::Load( bool fResync )
 	g_Log.Printf("\n");
 	g_Log.Event(LOGM_INIT, "Indexing %" PRIuSIZE_T " script files...\n", count);
 
+	// First read the files (on resync, only the ones whose content changed) in parallel,
+	//  then load the resources from them in this thread: they reference each other, so it must be done in order.
+	const llong iTimeReadStart = CSTime::GetPreciseSysTimeMilli();
+	std::vector<CResourceScript*> vResFiles(m_ResourceFiles.begin(), m_ResourceFiles.end());
+	const size_t uiChanged = g_asyncScriptLoad.preloadFiles(vResFiles, _iScriptLoadThreads);
+	const llong iTimeLoadStart = CSTime::GetPreciseSysTimeMilli();
+
 	for ( size_t j = 0; ; ++j )
 	{
         if (g_Serv.GetExitFlag())
@@ -4619,13 +4697,27 @@ bool CServerConfig::Load( bool fResync )
 			break;
 
 		if ( !fResync )
+		{
 			LoadResources( pResFile );
-		else
+		}
+		else if ( j >= vResFiles.size() )
+		{
+			// Added by a [RESOURCES] section of a file loaded above, so it wasn't preloaded.
 			pResFile->ReSync();
+		}
+		else if ( pResFile->IsPreloadChanged() && pResFile->Open() )
+		{
+			LoadResourcesOpen( pResFile );
+			pResFile->Close();
+		}
 
 		g_Serv.PrintPercent( (size_t)(j + 1), count);
 	}
 
+	const llong iTimeLoadEnd = CSTime::GetPreciseSysTimeMilli();
+	g_Log.Event(LOGM_INIT, "Read %" PRIuSIZE_T " of %" PRIuSIZE_T " script files in %" PRId64 " ms (%d threads), loaded their resources in %" PRId64 " ms.\n",
+		uiChanged, count, (iTimeLoadStart - iTimeReadStart), _iScriptLoadThreads, (iTimeLoadEnd - iTimeLoadStart));
+
 	// Now that we have parsed every script, we can end the configuration of some resources...
 		// ROOMs have to inherit stuff from the parent AREADEF
 	for (CRegion* pCurRegion : m_RegionDefs)
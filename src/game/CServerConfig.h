@@ -234,7 +234,9 @@ public:
 	// Begin INI file options.
 	bool m_fUseNTService;       // Start this as a system service on Win2000, XP, NT
 	int	 m_fUseHTTP;            // Use the built in http server
+	CSString _sMetricsPage;     // Url of the metrics page (Prometheus format) on the http server, empty = disabled.
 	bool m_fUseAuthID;          // Use the OSI AuthID to avoid possible hijack to game server.
+	uint   _uiMapCacheSize;    // Max memory (MB) used by the cached map data, 0 = unlimited.
 	int64  _iMapCacheTime;     // Time in sec to keep unused map data..
 	int64  _iSectorSleepDelay;    // The mask for how long sectors will sleep.
 	bool m_fUseMapDiffs;        // Whether or not to use map diff files.
@@ -244,6 +246,9 @@ public:
 
 	bool m_fSecure;             // Secure mode. (will trap exceptions)
 	int64  m_iFreezeRestartTime;  // # seconds before restarting.
+	int  _iScriptLoadThreads;   // Threads reading the script files when loading or resyncing them, 0 = read them in the main thread.
+	int  _iLogQueueLength;      // Lines queued for the log writer thread, 0 = write the log file from the thread logging.
+	int  _iWorldTickPeriod;     // Msecs between the world ticks, the network is processed in the meanwhile. 0 = tick on every main loop cycle.
 #define DEBUGF_NPC_EMOTE		0x0001  // NPCs emote their actions.
 #define DEBUGF_ADVANCE_STATS	0x0002  // prints stat % skill changes (only for _DEBUG builds).
 #define DEBUGF_EXP				0x0200  // experience gain/loss.
@@ -259,6 +264,10 @@ public:
 	int64  m_iDecay_Item;         // Base decay time in minutes (but stored as milliseconds).
 	int64  m_iDecay_CorpsePlayer; // Time in minutes for a playercorpse to decay.
 	int64  m_iDecay_CorpseNPC;    // Time in minutes for a NPC corpse to decay.
+	int64  _iDecayBucketTime;     // Precision in seconds (but stored as milliseconds) of the decay of the items on the ground. 0 = exact.
+
+	// Spawn
+	uint _uiSpawnsPerTick;        // Max number of spawns generating a char/item in the same world tick, the others are postponed. 0 = no limit.
 
 	// Save
 	int  m_iSaveNPCSkills;			// Only save NPC skills above this
@@ -283,6 +292,7 @@ public:
 	byte m_iMaxCharsPerAccount; // Maximum characters allowed on an account.
 	bool m_fLocalIPAdmin;       // The local ip is the admin ?
 	bool m_fMd5Passwords;       // Should MD5 hashed passwords be used?
+	int  _iAuthThreads;         // Threads verifying the accounts passwords at login, 0 = verify them in the main thread.
     uint8 _iMaxHousesAccount;   // Max houses per account.
     uint8 _iMaxHousesPlayer;    // Max houses per player.
     uint8 _iMaxShipsAccount;    // Max ships per account.
@@ -555,6 +565,7 @@ public:
 	uint _uiNetworkThreadPriority;  // priority of network threads
 	int	 m_fUseAsyncNetwork;        // 0=normal send, 1=async send, 2=async send for 4.0.0+ only
 	int	 m_iNetMaxPings;            // max pings before blocking an ip
+	int	 _iNetMaxPingsSubnet;       // max pings from the same /24 subnet before rejecting its ips, 0 = no limit
 	int	 m_iNetHistoryTTL;          // time to remember an ip
 	int	 _uiNetMaxPacketsPerTick;   // max packets to send per tick (per queue)
 	uint _uiNetMaxLengthPerTick;    // max packet length to send per tick (per queue) (also max length of individual packets)
@@ -563,6 +574,7 @@ public:
 	int	 m_iNetMaxQueueSize;        // max packets to hold per queue (comment out for unlimited)
 	bool m_fUsePacketPriorities;    // true to prioritise sending packets
 	bool m_fUseExtraBuffer;         // true to queue packet data in an extra buffer
+	uint _uiStatusUpdateBudget;     // max bytes of batched status broadcasts (hits bars, tooltips) to send per tick to each client (0 = unlimited)
 
 	int64 m_iTooltipCache;          // time in seconds to cache tooltip for.
 	int	m_iTooltipMode;             // tooltip mode (TOOLTIP_TYPE)
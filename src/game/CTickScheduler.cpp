@@ -0,0 +1,114 @@
+#include "../common/sphere_library/CSString.h"
+#include "../sphere/threads.h"
+#include "../sphere/Metrics.h"
+#include "CServerConfig.h"
+#include "CTickScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+CTickScheduler g_TickScheduler;
+
+
+CTickScheduler::CTickScheduler()
+{
+	Reset();
+}
+
+int64 CTickScheduler::GetTimeUsecs() noexcept // static
+{
+	const auto timeNow = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(timeNow).count();
+}
+
+void CTickScheduler::Reset()
+{
+	_iNextStep = 0;
+	_iStepStart = 0;
+	_uiSteps = _uiOverruns = _uiMissedSteps = 0;
+	_uiBacklog = 0;
+	_uiSampleNext = _uiSampleCount = 0;
+}
+
+bool CTickScheduler::BeginStep()
+{
+	const int64 iNow = GetTimeUsecs();
+	const int64 iPeriod = int64(g_Cfg._iWorldTickPeriod) * 1000;
+	if (iPeriod <= 0)
+	{
+		// No fixed rate: step on every cycle of the main loop, like it was done before.
+		_iNextStep = iNow;
+	}
+	else if (_iNextStep == 0)
+	{
+		_iNextStep = iNow;
+	}
+	else if (iNow < _iNextStep)
+	{
+		return false;
+	}
+
+	const int64 iLate = iNow - _iNextStep;
+	_uiJitter[_uiSampleNext] = uint(minimum(iLate, int64(UINT32_MAX)));
+	g_Metrics.Observe(METRIC_WORLD_TICK_JITTER, iLate);
+	_iStepStart = iNow;
+
+	_uiBacklog = 0;
+	if (iPeriod > 0)
+	{
+		_iNextStep += iPeriod;
+		if (_iNextStep <= iNow)
+		{
+			// We are late by one or more whole periods: don't try to run them all at once, skip them.
+			_uiBacklog = uint((iNow - _iNextStep) / iPeriod) + 1;
+			_uiMissedSteps += _uiBacklog;
+			g_Metrics.Add(METRIC_WORLD_TICK_MISSED, _uiBacklog);
+			_iNextStep = iNow + iPeriod;
+		}
+	}
+	return true;
+}
+
+void CTickScheduler::EndStep()
+{
+	const int64 iDuration = GetTimeUsecs() - _iStepStart;
+	const int64 iPeriod = int64(g_Cfg._iWorldTickPeriod) * 1000;
+	if ((iPeriod > 0) && (iDuration > iPeriod))
+	{
+		++_uiOverruns;
+		g_Metrics.Add(METRIC_WORLD_TICK_OVERRUNS);
+	}
+
+	_uiDuration[_uiSampleNext] = uint(minimum(iDuration, int64(UINT32_MAX)));
+	_uiSampleNext = (_uiSampleNext + 1) % TICKSCHED_SAMPLES;
+	if (_uiSampleCount < TICKSCHED_SAMPLES)
+		++_uiSampleCount;
+	++_uiSteps;
+}
+
+uint CTickScheduler::GetPercentile(const uint* puiSamples, uint uiCount, uint uiPercent) // static
+{
+	if (uiCount == 0)
+		return 0;
+
+	uint uiSorted[TICKSCHED_SAMPLES];
+	std::copy(puiSamples, puiSamples + uiCount, uiSorted);
+	const uint uiIndex = minimum(uiCount - 1, (uiCount * uiPercent) / 100);
+	std::nth_element(uiSorted, uiSorted + uiIndex, uiSorted + uiCount);
+	return uiSorted[uiIndex];
+}
+
+void CTickScheduler::WriteStats(CSString& sVal) const
+{
+	ADDTOCALLSTACK("CTickScheduler::WriteStats");
+	// The samples aren't ordered by time, but it doesn't matter for the percentiles.
+	// Jitter and duration are shown in msecs, with usecs precision.
+	sVal.Format("World tick: Period=%dms, Steps=%" PRIu64 ", Overruns=%" PRIu64 ", Missed=%" PRIu64 ", Backlog=%u\n"
+		"World tick: Jitter p50/p95/p99=%.3f/%.3f/%.3fms, Duration p50/p95/p99=%.3f/%.3f/%.3fms\n",
+		g_Cfg._iWorldTickPeriod, _uiSteps, _uiOverruns, _uiMissedSteps, _uiBacklog,
+		GetPercentile(_uiJitter, _uiSampleCount, 50) / 1000.0,
+		GetPercentile(_uiJitter, _uiSampleCount, 95) / 1000.0,
+		GetPercentile(_uiJitter, _uiSampleCount, 99) / 1000.0,
+		GetPercentile(_uiDuration, _uiSampleCount, 50) / 1000.0,
+		GetPercentile(_uiDuration, _uiSampleCount, 95) / 1000.0,
+		GetPercentile(_uiDuration, _uiSampleCount, 99) / 1000.0);
+}
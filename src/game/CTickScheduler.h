@@ -0,0 +1,60 @@
+/**
+* @file CTickScheduler.h
+* @brief Runs the world simulation at a fixed rate, separately from the network input/output, and keeps its timing stats.
+*/
+
+#ifndef _INC_CTICKSCHEDULER_H
+#define _INC_CTICKSCHEDULER_H
+
+#include "../common/common.h"
+
+class CSString;
+
+
+#define TICKSCHED_SAMPLES	512		// number of steps kept to calculate the percentiles
+
+
+// The main loop processes the network input and flushes the output on every cycle, while the world is
+//  stepped only when its period has elapsed: a slow world step delays only the next step, not the packets.
+// A step can't be "replayed" (the world clock advances by the real time elapsed), so when we fall behind by more
+//  than a period the missed steps are counted as backlog and the schedule restarts from the current time.
+class CTickScheduler
+{
+	int64 _iNextStep;		// when the next step is due (usecs)
+	int64 _iStepStart;		// when the current step started (usecs)
+
+	ullong _uiSteps;		// world steps run
+	ullong _uiOverruns;		// steps which took longer than the period
+	ullong _uiMissedSteps;	// steps skipped because we were too late
+	uint _uiBacklog;		// steps we were behind on the last step
+
+	// Circular buffers of the latest steps: delay from the scheduled time and duration (usecs)
+	uint _uiJitter[TICKSCHED_SAMPLES];
+	uint _uiDuration[TICKSCHED_SAMPLES];
+	uint _uiSampleNext;
+	uint _uiSampleCount;
+
+public:
+	static const char* m_sClassName;
+	CTickScheduler();
+	~CTickScheduler() = default;
+
+private:
+	CTickScheduler(const CTickScheduler& copy);
+	CTickScheduler& operator=(const CTickScheduler& other);
+
+public:
+	bool BeginStep();		// is a world step due? if so start measuring it
+	void EndStep();
+	void Reset();
+
+	void WriteStats(CSString& sVal) const;
+
+private:
+	static int64 GetTimeUsecs() noexcept;
+	static uint GetPercentile(const uint* puiSamples, uint uiCount, uint uiPercent);
+};
+
+extern CTickScheduler g_TickScheduler;
+
+#endif // _INC_CTICKSCHEDULER_H
@@ -10,11 +10,18 @@
 
 CTimedFunction::CTimedFunction(const CUID& uidAttached, const char* pcCommand) :
 	CTimedObject(PROFILE_TIMEDFUNCTIONS),
-	_uidAttached(uidAttached)
+	_uidAttached(uidAttached), _pHandler(nullptr), _uiSequence(0)
 {
 	Str_CopyLimitNull(_ptcCommand, pcCommand, kuiCommandSize);
 }
 
+CTimedFunction::~CTimedFunction()
+{
+	// Deleted after its execution: remove it from the handler's indexes.
+	if (_pHandler != nullptr)
+		_pHandler->Remove(this);
+}
+
 
 bool CTimedFunction::_IsDeleted() const // virtual
 {
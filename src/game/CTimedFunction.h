@@ -23,10 +23,12 @@ private:
 
     CUID  _uidAttached;
     tchar _ptcCommand[kuiCommandSize];
+    CTimedFunctionHandler* _pHandler;   // the handler indexing it, nullptr if it was already removed from its indexes
+    ullong _uiSequence;                 // order of creation, key in the handler
 
 public:
     CTimedFunction(const CUID& uidAttached, const char * pcCommand);
-    ~CTimedFunction() = default; // Removal from ticking list is already managed by CTimedObject destructor
+    ~CTimedFunction(); // Removal from ticking list is already managed by CTimedObject destructor
 
     const CUID& GetUID() const {
         return _uidAttached;
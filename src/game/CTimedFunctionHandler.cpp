@@ -6,24 +6,52 @@
 #include "CServerTime.h"
 #include "CWorld.h"
 #include "CTimedFunctionHandler.h"
+#include <algorithm>
 
 
 #define TF_TICK_MAGIC_NUMBER		99
 
 
 CTimedFunctionHandler::CTimedFunctionHandler() :
+	_uiLastSequence(0),
 	_strLoadBufferCommand(CTimedFunction::kuiCommandSize, '\0'),
 	_strLoadBufferNumbers(CTimedFunction::kuiCommandSize, '\0')
 {
 }
 
+CTimedFunctionHandler::~CTimedFunctionHandler()
+{
+	Clear();
+}
+
+void CTimedFunctionHandler::Remove(CTimedFunction* tf)
+{
+	ADDTOCALLSTACK("CTimedFunctionHandler::Remove");
+	ASSERT(tf->_pHandler == this);
+	tf->_pHandler = nullptr;
+	_mapTimedFunctions.erase(tf->_uiSequence);
+
+	const auto itUID = _mapTimedFunctionsByUID.find(tf->GetUID().GetObjUID());
+	if (itUID == _mapTimedFunctionsByUID.end())
+		return;
+	std::vector<CTimedFunction*>& vecTimedFunctions = itUID->second;
+	const auto itTF = std::find(vecTimedFunctions.begin(), vecTimedFunctions.end(), tf);
+	if (itTF != vecTimedFunctions.end())
+		vecTimedFunctions.erase(itTF);	// keep the order of creation
+	if (vecTimedFunctions.empty())
+		_mapTimedFunctionsByUID.erase(itUID);
+}
+
 int64 CTimedFunctionHandler::IsTimer(const CUID& uid, lpctstr ptcCommand) const
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::IsTimer");
-	for (CSObjContRec* obj : _timedFunctions.GetIterationSafeCont())	// the end iterator changes at each stl container erase call
+	const auto itUID = _mapTimedFunctionsByUID.find(uid.GetObjUID());
+	if (itUID == _mapTimedFunctionsByUID.end())
+		return 0;
+
+	for (const CTimedFunction* tfObj : itUID->second)
 	{
-		auto tfObj = static_cast<CTimedFunction*>(obj);
-		if ((tfObj->GetUID() == uid) && (Str_Match(ptcCommand, tfObj->GetCommand()) == MATCH_VALID))
+		if (Str_Match(ptcCommand, tfObj->GetCommand()) == MATCH_VALID)
 		{
 			return tfObj->GetTimerAdjusted();
 		}
@@ -34,24 +62,33 @@ int64 CTimedFunctionHandler::IsTimer(const CUID& uid, lpctstr ptcCommand) const
 void CTimedFunctionHandler::ClearUID( const CUID& uid )
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::Erase");
-	for (CSObjContRec* obj : _timedFunctions.GetIterationSafeCont())	// the end iterator changes at each stl container erase call
+	const auto itUID = _mapTimedFunctionsByUID.find(uid.GetObjUID());
+	if (itUID == _mapTimedFunctionsByUID.end())
+		return;
+
+	// Removing the last one of this UID erases the vector from the map.
+	const std::vector<CTimedFunction*> vecTimedFunctions(std::move(itUID->second));
+	_mapTimedFunctionsByUID.erase(itUID);
+	for (CTimedFunction* tfObj : vecTimedFunctions)
 	{
-		auto tfObj = static_cast<CTimedFunction*>(obj);
-		if (tfObj->GetUID() == uid)
-		{
-			g_World.ScheduleObjDeletion(tfObj);
-		}
+		Remove(tfObj);
+		g_World.ScheduleObjDeletion(tfObj);
 	}
 }
 
 void CTimedFunctionHandler::Stop(const CUID& uid, lpctstr ptcCommand)
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::Stop");
-	for (CSObjContRec* obj : _timedFunctions.GetIterationSafeCont())
+	const auto itUID = _mapTimedFunctionsByUID.find(uid.GetObjUID());
+	if (itUID == _mapTimedFunctionsByUID.end())
+		return;
+
+	const std::vector<CTimedFunction*> vecTimedFunctions(itUID->second);	// Remove changes the vector (and may erase it)
+	for (CTimedFunction* tfObj : vecTimedFunctions)
 	{
-		auto tfObj = static_cast<CTimedFunction*>(obj);
-		if ((tfObj->GetUID() == uid) && (Str_Match(ptcCommand, tfObj->GetCommand()) == MATCH_VALID))
+		if (Str_Match(ptcCommand, tfObj->GetCommand()) == MATCH_VALID)
 		{
+			Remove(tfObj);
 			g_World.ScheduleObjDeletion(tfObj);
 		}
 	}
@@ -61,14 +98,26 @@ void CTimedFunctionHandler::Clear()
 {
     ADDTOCALLSTACK("CTimedFunctionHandler::Clear");
 
-    _timedFunctions.ClearContainer();
+    // Unlink them first, so that their destructor doesn't touch the containers while we are iterating them.
+    for (auto& pairTF : _mapTimedFunctions)
+        pairTF.second->_pHandler = nullptr;
+    for (auto& pairTF : _mapTimedFunctions)
+        delete pairTF.second;
+    _mapTimedFunctions.clear();
+    _mapTimedFunctionsByUID.clear();
 }
 
 TRIGRET_TYPE CTimedFunctionHandler::Loop(lpctstr ptcCommand, int iLoopsMade, CScriptLineContext StartContext,
     CScript &s, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * pResult)
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::Loop");
-	for (CSObjContRec* obj : _timedFunctions.GetIterationSafeCont())
+	// The scripts ran may add or stop timed functions: iterate a copy. The stopped ones are only scheduled for deletion.
+	std::vector<CTimedFunction*> vecTimedFunctions;
+	vecTimedFunctions.reserve(_mapTimedFunctions.size());
+	for (const auto& pairTF : _mapTimedFunctions)
+		vecTimedFunctions.emplace_back(pairTF.second);
+
+	for (CTimedFunction* tfObj : vecTimedFunctions)
 	{
 		++iLoopsMade;
 		if (g_Cfg.m_iMaxLoopTimes && (iLoopsMade >= g_Cfg.m_iMaxLoopTimes))
@@ -77,7 +126,6 @@ TRIGRET_TYPE CTimedFunctionHandler::Loop(lpctstr ptcCommand, int iLoopsMade, CSc
 			return TRIGRET_ENDIF;
 		}
 
-		auto tfObj = static_cast<CTimedFunction*>(obj);
 		if (!strcmpi(tfObj->GetCommand(), ptcCommand))
 		{
 			CObjBase* pObj = tfObj->GetUID().ObjFind();
@@ -109,7 +157,10 @@ void CTimedFunctionHandler::Add(const CUID& uid, int64 iTimeout, const char* pcC
 	ASSERT(strlen(pcCommand) < CTimedFunction::kuiCommandSize);
 
 	auto* tf = new CTimedFunction(uid, pcCommand);
-	_timedFunctions.InsertContentTail(tf);
+	tf->_pHandler = this;
+	tf->_uiSequence = ++_uiLastSequence;
+	_mapTimedFunctions.emplace_hint(_mapTimedFunctions.end(), tf->_uiSequence, tf);
+	_mapTimedFunctionsByUID[uid.GetObjUID()].emplace_back(tf);
 	tf->SetTimeout(iTimeout);
 }
 
@@ -199,9 +250,9 @@ int CTimedFunctionHandler::Load(lpctstr ptcKeyword, bool fQuoted, lpctstr ptcArg
 void CTimedFunctionHandler::r_Write( CScript & s )
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::r_Write");
-	for (CSObjContRec* obj : _timedFunctions.GetIterationSafeCont())
+	for (const auto& pairTF : _mapTimedFunctions)
 	{
-		auto tfObj = static_cast<CTimedFunction*>(obj);
+		const CTimedFunction* tfObj = pairTF.second;
 		const CUID& uid = tfObj->GetUID();
 		if (uid.IsValidUID())
 		{
@@ -6,9 +6,11 @@
 #ifndef _INC_CTIMEDFUNCTIONHANDLER_H
 #define _INC_CTIMEDFUNCTIONHANDLER_H
 
-#include "../common/sphere_library/CSObjCont.h"
+#include "../../lib/parallel_hashmap/phmap.h"
 #include "../common/CScriptContexts.h"
 #include "CTimedFunction.h"
+#include <map>
+#include <vector>
 
 
 class CScript;
@@ -16,8 +18,15 @@ class CUID;
 
 class CTimedFunctionHandler
 {
+    friend class CTimedFunction;
+
 private:
-    CSObjCont _timedFunctions;
+    // The timed functions are fired in order of timeout by the CWorldTicker (each is a CTimedObject). Here they are kept
+    //  by order of creation (for LOOP and the save) and by UID of the attached object, so that looking for the ones of an
+    //  object, stopping them or clearing them when it's deleted doesn't need to check all the pending timed functions.
+    std::map<ullong, CTimedFunction*> _mapTimedFunctions;
+    phmap::flat_hash_map<dword, std::vector<CTimedFunction*>> _mapTimedFunctionsByUID;
+    ullong _uiLastSequence;
 
     std::string _strLoadBufferCommand;
     std::string _strLoadBufferNumbers;
@@ -25,6 +34,7 @@ private:
 public:
     static const char *m_sClassName;
     CTimedFunctionHandler();
+    ~CTimedFunctionHandler();
 
 private:
     CTimedFunctionHandler(const CTimedFunctionHandler& copy);
@@ -41,5 +51,8 @@ public:
     TRIGRET_TYPE Loop(lpctstr ptcCommand, int iLoopsMade, CScriptLineContext StartContext,
         CScript &s, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * pResult);
     int64 IsTimer(const CUID& uid, lpctstr ptcCommand) const;
+
+private:
+    void Remove(CTimedFunction* tf);    // remove from the indexes, without deleting it
 };
 #endif // _INC_CTIMEDFUNCTIONHANDLER_H
@@ -26,6 +26,7 @@ private:
     int64 _iTimeout;
     PROFILE_TYPE _profileType;
     bool _fIsSleeping;
+    bool _fDecayBucket;     // the timer is kept in the decay buckets of the CWorldTicker, not in its precise list
 
     /**
     * @brief clears the timeout.
@@ -165,6 +166,7 @@ void CTimedObject::_SetTimeoutRaw(int64 iDelayInMsecs) noexcept
 void CTimedObject::_ClearTimeout() noexcept
 {
     _iTimeout = 0;
+    _fDecayBucket = false;
 }
 
 bool CTimedObject::_IsSleeping() const noexcept
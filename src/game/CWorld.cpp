@@ -3,12 +3,14 @@
 #include "../common/sphereversion.h"
 #include "../network/CClientIterator.h"
 #include "../network/CNetworkManager.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ProfileTask.h"
 #include "../common/CLog.h"
 #include "chars/CChar.h"
 #include "clients/CClient.h"
 #include "clients/CGMPage.h"
 #include "items/CItemMulti.h"
+#include "CBenchmark.h"
 #include "CServer.h"
 #include "CScriptProfiler.h"
 #include "CSector.h"
@@ -215,12 +217,9 @@ CWorldThread::CWorldThread()
 {
 	m_fSaveParity = false;		// has the sector been saved relative to the char entering it ?
 
-	_ppUIDObjArray = nullptr;
-	_uiUIDObjArraySize = 0;
-	_dwUIDIndexLast = 0;
-
-	_pdwFreeUIDs = nullptr;
-	_dwFreeUIDOffset = 0;
+	_ppUIDPages = nullptr;
+	_dwUIDPageCount = 0;
+	_dwUIDPageNextFree = 0;
 }
 
 CWorldThread::~CWorldThread()
@@ -230,12 +229,9 @@ CWorldThread::~CWorldThread()
 
 void CWorldThread::InitUIDs()
 {
-	_uiUIDObjArraySize = 8 * 1024;
-	_ppUIDObjArray = (CObjBase**)calloc(_uiUIDObjArraySize, sizeof(CObjBase*));
-	_dwUIDIndexLast = 1;
-
-	_dwFreeUIDOffset = FREE_UIDS_SIZE;
-	_pdwFreeUIDs = (dword*)calloc(_dwFreeUIDOffset, sizeof(dword));
+	// Only the directory: the pages are allocated when the first UID in them is.
+	if (_ppUIDPages == nullptr)
+		_ppUIDPages = (UIDPage**)calloc(UID_PAGE_QTY, sizeof(UIDPage*));
 }
 
 void CWorldThread::CloseAllUIDs()
@@ -245,21 +241,17 @@ void CWorldThread::CloseAllUIDs()
 	m_ObjSpecialDelete.ClearContainer();
 	m_ObjNew.ClearContainer();		// empty our list of objects to delete (and delete the objects in the list)
 
-	if (_ppUIDObjArray != nullptr)
+	if (_ppUIDPages != nullptr)
 	{
-		free(_ppUIDObjArray);
-		_ppUIDObjArray = nullptr;
-		_uiUIDObjArraySize = 0;
+		for (dword dwPage = 0; dwPage < _dwUIDPageCount; ++dwPage)
+			delete _ppUIDPages[dwPage];
+		free(_ppUIDPages);
+		_ppUIDPages = nullptr;
 	}
 
-	if ( _pdwFreeUIDs != nullptr )
-	{
-		free(_pdwFreeUIDs);
-		_pdwFreeUIDs = nullptr;
-	}
-
-	_dwFreeUIDOffset = 0;
-	_dwUIDIndexLast = 0;
+	_dwUIDPageCount = 0;
+	_dwUIDPageNextFree = 0;
+	std::deque<dword>().swap(_qFreeUIDs);
 }
 
 bool CWorldThread::IsSaving() const
@@ -267,110 +259,132 @@ bool CWorldThread::IsSaving() const
 	return (m_FileWorld.IsFileOpen() && m_FileWorld.IsWriteMode());
 }
 
-dword CWorldThread::GetUIDCount() const
+CWorldThread::UIDPage* CWorldThread::AllocUIDPage(dword dwPage)
 {
-	ASSERT(_uiUIDObjArraySize <= UINT32_MAX);
-	return (dword)_uiUIDObjArraySize;
+	ADDTOCALLSTACK("CWorldThread::AllocUIDPage");
+	ASSERT(dwPage < UID_PAGE_QTY);
+	if ( _ppUIDPages == nullptr )
+		InitUIDs();
+	UIDPage* pPage = _ppUIDPages[dwPage];
+	if ( pPage != nullptr )
+		return pPage;
+
+	pPage = new UIDPage();	// zero initialized
+	_ppUIDPages[dwPage] = pPage;
+	if ( dwPage >= _dwUIDPageCount )
+		_dwUIDPageCount = dwPage + 1;
+
+	// All the UIDs of the new page are free (UID 0 and UID_O_INDEX_MASK are never used).
+	const dword dwFirst = dwPage << UID_PAGE_SHIFT;
+	for ( dword d = (dwFirst ? 0 : 1); d < UID_PAGE_SIZE; ++d )
+	{
+		if ( (dwFirst + d) != UID_O_INDEX_MASK )
+			PushFreeUID(dwFirst + d);
+	}
+	return pPage;
 }
 
-CObjBase *CWorldThread::FindUID(dword dwIndex) const
+void CWorldThread::PushFreeUID(dword dwIndex) noexcept
 {
-	if ( !dwIndex || dwIndex >= GetUIDCount() )
-		return nullptr;
-	if ( _ppUIDObjArray[ dwIndex ] == UID_PLACE_HOLDER )	// unusable for now. (background save is going on)
-		return nullptr;
-	return _ppUIDObjArray[dwIndex];
+	dword& dwGeneration = _ppUIDPages[dwIndex >> UID_PAGE_SHIFT]->adwGeneration[dwIndex & (UID_PAGE_SIZE - 1)];
+	if ( dwGeneration & UID_GEN_LISTED )	// already there
+		return;
+	dwGeneration |= UID_GEN_LISTED;
+	_qFreeUIDs.push_back(dwIndex);
 }
 
 void CWorldThread::FreeUID(dword dwIndex)
 {
+	if ( !dwIndex || dwIndex >= GetUIDCount() )
+		return;
+	UIDPage* pPage = _ppUIDPages[dwIndex >> UID_PAGE_SHIFT];
+	if ( pPage == nullptr )
+		return;
+
+	const dword dwSlot = dwIndex & (UID_PAGE_SIZE - 1);
+	dword& dwGeneration = pPage->adwGeneration[dwSlot];
+	dwGeneration = ((dwGeneration + 1) & UID_GEN_MASK) | (dwGeneration & UID_GEN_LISTED);
+
 	// Can't free up the UID til after the save !
-	_ppUIDObjArray[dwIndex] = IsSaving() ? UID_PLACE_HOLDER : nullptr;
+	if ( IsSaving() )
+	{
+		pPage->apObj[dwSlot] = UID_PLACE_HOLDER;
+		return;
+	}
+	pPage->apObj[dwSlot] = nullptr;
+	PushFreeUID(dwIndex);
 }
 
 dword CWorldThread::AllocUID( dword dwIndex, CObjBase * pObj )
 {
 	ADDTOCALLSTACK("CWorldThread::AllocUID");
-	dword dwCountTotal = GetUIDCount();
+	UIDPage* pPage = nullptr;
 
 	if ( !dwIndex )					// auto-select tbe suitable hole
 	{
-		if ( !dwCountTotal )		// if the uids array is empty - increase it.
-		{
-			dwIndex = 1;
-			goto setcount;
-		}
-
-		if ( _dwFreeUIDOffset < FREE_UIDS_SIZE && _pdwFreeUIDs != nullptr )
+		// Take the oldest free UID, skipping the ones taken in the meantime by an explicit UID.
+		while ( !_qFreeUIDs.empty() )
 		{
-			//	We do have a free uid's array. Use it if possible to determine the first free element
-			for ( ; _dwFreeUIDOffset < FREE_UIDS_SIZE && _pdwFreeUIDs[_dwFreeUIDOffset] != 0; _dwFreeUIDOffset++ )
+			const dword dwFree = _qFreeUIDs.front();
+			_qFreeUIDs.pop_front();
+			pPage = _ppUIDPages[dwFree >> UID_PAGE_SHIFT];
+			pPage->adwGeneration[dwFree & (UID_PAGE_SIZE - 1)] &= ~UID_GEN_LISTED;
+			if ( pPage->apObj[dwFree & (UID_PAGE_SIZE - 1)] == nullptr )
 			{
-				//	yes, that's a free slot
-				if ( !_ppUIDObjArray[_pdwFreeUIDs[_dwFreeUIDOffset]] )
-				{
-					dwIndex = _pdwFreeUIDs[_dwFreeUIDOffset++];
-					goto successalloc;
-				}
+				dwIndex = dwFree;
+				break;
 			}
 		}
-		_dwFreeUIDOffset = FREE_UIDS_SIZE;	// mark array invalid, since it does not contain any empty slots
-										// use default allocation for a while, till the next garbage collection
-		dword dwCount = dwCountTotal - 1;
-		dwIndex = _dwUIDIndexLast;
-		while ( _ppUIDObjArray[dwIndex] != nullptr )
+
+		if ( !dwIndex )
 		{
-			if ( ! -- dwIndex )
-			{
-				dwIndex = dwCountTotal - 1;
-			}
-			if ( ! -- dwCount )
-			{
-				dwIndex = dwCountTotal;
-				goto setcount;
-			}
+			// We have run out of free UID's !!! Add the lowest page not allocated yet
+			//  (explicit UIDs, ie. from a save, may have allocated pages far above the others).
+			if ( _ppUIDPages == nullptr )
+				InitUIDs();
+			while ( (_dwUIDPageNextFree < UID_PAGE_QTY) && (_ppUIDPages[_dwUIDPageNextFree] != nullptr) )
+				++_dwUIDPageNextFree;
+			if ( _dwUIDPageNextFree >= UID_PAGE_QTY )
+				throw CSError(LOGL_FATAL, 0, "No more UIDs available!\n");
+			AllocUIDPage(_dwUIDPageNextFree);
+			return AllocUID(0, pObj);
 		}
 	}
-	else if ( dwIndex >= dwCountTotal )
+	else
 	{
-setcount:
-		// We have run out of free UID's !!! Grow the array
-		const size_t uiOldArraySize = _uiUIDObjArraySize;
-		_uiUIDObjArraySize = ((dwIndex + 0x1000) & ~0xFFF);
-
-		CObjBase** pNewBlock = (CObjBase**)realloc(_ppUIDObjArray, _uiUIDObjArraySize * sizeof(CObjBase*));
-		if (pNewBlock == nullptr)
-		{
-			throw CSError(LOGL_FATAL, 0, "Not enough memory to store new UIDs!.\n");
-		}
-
-		// zero initialize the expanded part of the memory, leave untouched the original one
-		memset(pNewBlock + uiOldArraySize, 0, (_uiUIDObjArraySize - uiOldArraySize) * sizeof(CObjBase*));
-
-		_ppUIDObjArray = (CObjBase**)pNewBlock;
+		ASSERT(dwIndex <= UID_O_INDEX_MASK);
+		pPage = AllocUIDPage(dwIndex >> UID_PAGE_SHIFT);
 	}
 
-successalloc:
-	_dwUIDIndexLast = dwIndex; // start from here next time so we have even distribution of allocation.
-	CObjBase *pObjPrv = _ppUIDObjArray[dwIndex];
-	if ( pObjPrv )
+	CObjBase *&pSlot = pPage->apObj[dwIndex & (UID_PAGE_SIZE - 1)];
+	CObjBase *pObjPrv = pSlot;
+	if ( pObjPrv && (pObjPrv != UID_PLACE_HOLDER) )
 	{
 		//NOTE: We cannot use Delete() in here because the UID will
 		//	still be assigned til the async cleanup time. Delete() will not work here!
 		DEBUG_ERR(("UID conflict delete 0%x, '%s'\n", dwIndex, pObjPrv->GetName()));
 		delete pObjPrv;
 	}
-	_ppUIDObjArray[dwIndex] = pObj;
+	pSlot = pObj;
 	return dwIndex;
 }
 
 void CWorldThread::SaveThreadClose()
 {
 	ADDTOCALLSTACK("CWorldThread::SaveThreadClose");
-	for ( size_t i = 1; i < GetUIDCount(); ++i )
+	// The UIDs freed during the save can be used again.
+	for ( dword dwPage = 0; dwPage < _dwUIDPageCount; ++dwPage )
 	{
-		if ( _ppUIDObjArray[i] == UID_PLACE_HOLDER )
-			_ppUIDObjArray[i] = nullptr;
+		UIDPage* pPage = _ppUIDPages[dwPage];
+		if ( pPage == nullptr )
+			continue;
+		for ( dword d = 0; d < UID_PAGE_SIZE; ++d )
+		{
+			if ( pPage->apObj[d] != UID_PLACE_HOLDER )
+				continue;
+			pPage->apObj[d] = nullptr;
+			PushFreeUID((dwPage << UID_PAGE_SHIFT) + d);
+		}
 	}
 
 	m_FileData.Close();
@@ -558,8 +572,8 @@ void CWorldThread::GarbageCollection_UIDs()
 	{
 		try
 		{
-			CObjBase * pObj = _ppUIDObjArray[i];
-			if ( !pObj || pObj == UID_PLACE_HOLDER )
+			CObjBase * pObj = FindUID(i);
+			if ( !pObj )
 				continue;
 
 			// Look for anomalies and fix them (that might mean delete it.)
@@ -605,23 +619,19 @@ void CWorldThread::GarbageCollection_UIDs()
 	else
 		g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "Garbage Collection: done. %" PRIu32 " Objects accounted for.\n", iCount);
 
-	if ( _pdwFreeUIDs != nullptr )	// new UID engine - search for empty holes and store it in a huge array
-	{							// the size of the array should be enough even for huge shards
-								// to survive till next garbage collection
-		memset(_pdwFreeUIDs, 0, FREE_UIDS_SIZE * sizeof(dword));
-		_dwFreeUIDOffset = 0;
-
-		for ( dword d = 1; d < GetUIDCount(); ++d )
+	// Build again the free list, in order of UID and without the UIDs taken in the meantime.
+	_qFreeUIDs.clear();
+	for ( dword dwPage = 0; dwPage < _dwUIDPageCount; ++dwPage )
+	{
+		UIDPage* pPage = _ppUIDPages[dwPage];
+		if ( pPage == nullptr )
+			continue;
+		for ( dword d = 0; d < UID_PAGE_SIZE; ++d )
 		{
-			CObjBase *pObj = _ppUIDObjArray[d];
-
-			if ( !pObj )
-			{
-				if ( _dwFreeUIDOffset >= ( FREE_UIDS_SIZE - 1 ))
-					break;
-
-				_pdwFreeUIDs[_dwFreeUIDOffset++] = d;
-			}
+			pPage->adwGeneration[d] &= ~UID_GEN_LISTED;
+			const dword dwIndex = (dwPage << UID_PAGE_SHIFT) + d;
+			if ( (pPage->apObj[d] == nullptr) && dwIndex && (dwIndex != UID_O_INDEX_MASK) )
+				PushFreeUID(dwIndex);
 		}
 	}
 }
@@ -732,6 +742,20 @@ bool CWorld::SaveStage() // Save world state in stages.
 
 	const int iSectorsQty = _Sectors.GetSectorAbsoluteQty();
 
+	METRIC_TYPE metricStage;
+	if ( _iSaveStage == -1 )
+		metricStage = METRIC_SAVE_GC;
+	else if ( _iSaveStage < iSectorsQty )
+		metricStage = METRIC_SAVE_SECTORS;
+	else if ( _iSaveStage == iSectorsQty )
+		metricStage = METRIC_SAVE_GLOBALS;
+	else if ( _iSaveStage == iSectorsQty + 2 )
+		metricStage = METRIC_SAVE_ACCOUNTS;
+	else
+		metricStage = METRIC_SAVE_FINISH;
+	// The empty stage (iSectorsQty + 1) does no work: don't let it count as finishing time.
+	const MetricTimer stageTimer(metricStage, (_iSaveStage != iSectorsQty + 1));
+
 	EXC_TRY("SaveStage");
 	bool fRc = true;
 
@@ -835,6 +859,7 @@ bool CWorld::SaveStage() // Save world state in stages.
 		m_FileMultis.WriteSection("EOF");
 
 		++m_iSaveCountID;	// Save only counts if we get to the end winout trapping.
+		g_Metrics.Add(METRIC_SAVES);
 		_iTimeLastWorldSave = _GameClock.GetCurrentTime().GetTimeRaw() + g_Cfg.m_iSavePeriod;	// next save time.
 
 		g_Log.Event(LOGM_SAVE, "World data saved   (%s).\n", m_FileWorld.GetFilePath());
@@ -1112,6 +1137,12 @@ bool CWorld::Save( bool fForceImmediate ) // Save world state
 {
 	ADDTOCALLSTACK("CWorld::Save");
 
+	if (g_Benchmark.IsActive())
+	{
+		g_Log.Event(LOGL_EVENT, "Save skipped: the world isn't saved in benchmark mode.\n");
+		return false;
+	}
+
 	bool fSaved = false;
 	try
 	{
@@ -1506,6 +1537,11 @@ bool CWorld::r_WriteVal( lpctstr ptcKey, CSString &sVal, CTextConsole * pSrc, bo
 	ADDTOCALLSTACK("CWorld::r_WriteVal");
 	EXC_TRY("WriteVal");
 
+	if ( !strnicmp(ptcKey, "MAPCACHE.", 9) )
+		return _Cache.WriteStatsVal(ptcKey + 9, sVal);
+	if ( !strnicmp(ptcKey, "PERCEPTION.", 11) )
+		return CSector::WritePerceptionStatsVal(ptcKey + 11, sVal);
+
 	switch ( FindTableSorted( ptcKey, sm_szLoadKeys, ARRAY_COUNT(sm_szLoadKeys)-1 ))
 	{
         case WC_CURTICK:
@@ -1748,6 +1784,8 @@ void CWorld::_OnTick()
 		// delete the static CServerMapBlock items that have not been used recently.
 		_Cache.CheckMapBlockCache(iCurTime, g_Cfg._iMapCacheTime);
 	}
+	EXC_SET_BLOCK("Prefetch map blocks");
+	_Cache.LoadPrefetchedBlocks();
 
 	// Global (ini) stuff.
 	// Respawn Dead NPCs
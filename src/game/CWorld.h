@@ -15,6 +15,7 @@
 #include "CWorldCache.h"
 #include "CWorldClock.h"
 #include "CWorldTicker.h"
+#include <deque>
 
 
 class CGMPage;
@@ -38,7 +39,11 @@ enum IMPFLAGS_TYPE	// IMPORT and EXPORT flags.
 	IMPFLAGS_ACCOUNT = 0x20		// 0x20 = recover just this account/char	(and all it is carrying)
 };
 
-#define FREE_UIDS_SIZE	500000	//	the list of free empty slots in the uids list should contain these elements
+#define UID_PAGE_SHIFT		12							// UIDs in each page of the UIDs table: 4096
+#define UID_PAGE_SIZE		(1 << UID_PAGE_SHIFT)
+#define UID_PAGE_QTY		((UID_O_INDEX_MASK + 1) >> UID_PAGE_SHIFT)	// pages covering the whole UID index space
+#define UID_GEN_LISTED		0x80000000					// flag in the generation of a slot: the UID is in the free list
+#define UID_GEN_MASK		0x7FFFFFFF
 
 
 class CWorldThread
@@ -47,12 +52,18 @@ class CWorldThread
 	// as well as those just created here. (but may not be here anymore)
 
 protected:
-	CObjBase**	_ppUIDObjArray;		// Array containing all the UID's in the World. CChar and CItem.
-	size_t		_uiUIDObjArraySize;
-	dword		_dwUIDIndexLast;	// remeber the last index allocated so we have more even usage.
-
-	dword*		_pdwFreeUIDs;		// list of free uids available
-	dword		_dwFreeUIDOffset;		// offset of the first free element
+	// Table of all the UID's in the World (CChar and CItem), in pages allocated only where there are objects:
+	//  a lookup is the directory of the pages, then the pointer in the page. The pages never move once allocated.
+	struct UIDPage
+	{
+		CObjBase* apObj[UID_PAGE_SIZE];		// kept apart from the generations, so the lookups read only these.
+		dword adwGeneration[UID_PAGE_SIZE];	// incremented each time the UID is freed, to tell when a UID was reused.
+	};
+	UIDPage**	_ppUIDPages;		// directory of UID_PAGE_QTY pages (nullptr = no UIDs allocated there yet).
+	dword		_dwUIDPageCount;	// 1 + the highest page allocated.
+	dword		_dwUIDPageNextFree;	// no page below this one is unallocated (the pages are freed only all together).
+
+	std::deque<dword> _qFreeUIDs;	// free UIDs, the oldest freed first (its slot may have been taken since then with an explicit UID).
 
 protected:
 	static const char *m_sClassName;
@@ -80,8 +91,43 @@ public:
 
 	// UID Managenent
     #define UID_PLACE_HOLDER (reinterpret_cast<CObjBase*>(INTPTR_MAX))
-	dword GetUIDCount() const;
-	CObjBase * FindUID(dword dwIndex) const;
+	dword GetUIDCount() const noexcept
+	{
+		return (_dwUIDPageCount << UID_PAGE_SHIFT);
+	}
+	CObjBase * FindUID(dword dwIndex) const noexcept
+	{
+		if ( !dwIndex || dwIndex >= GetUIDCount() )
+			return nullptr;
+		const UIDPage* pPage = _ppUIDPages[dwIndex >> UID_PAGE_SHIFT];
+		if ( pPage == nullptr )
+			return nullptr;
+		CObjBase* pObj = pPage->apObj[dwIndex & (UID_PAGE_SIZE - 1)];
+		if ( pObj == UID_PLACE_HOLDER )	// unusable for now. (background save is going on)
+			return nullptr;
+		return pObj;
+	}
+	// Changes each time the UID is freed: a UID kept with its generation is stale when the generation doesn't match anymore.
+	dword GetUIDGeneration(dword dwIndex) const noexcept
+	{
+		if ( !dwIndex || dwIndex >= GetUIDCount() )
+			return 0;
+		const UIDPage* pPage = _ppUIDPages[dwIndex >> UID_PAGE_SHIFT];
+		return pPage ? (pPage->adwGeneration[dwIndex & (UID_PAGE_SIZE - 1)] & UID_GEN_MASK) : 0;
+	}
+	// Start loading the slot of a UID in the cache, before looking it up.
+	void PrefetchUID(dword dwIndex) const noexcept
+	{
+		if ( dwIndex >= GetUIDCount() )
+			return;
+		const UIDPage* pPage = _ppUIDPages[dwIndex >> UID_PAGE_SHIFT];
+#ifdef __GNUC__
+		if ( pPage != nullptr )
+			__builtin_prefetch(&pPage->apObj[dwIndex & (UID_PAGE_SIZE - 1)]);
+#else
+		UnreferencedParameter(pPage);
+#endif
+	}
 	void FreeUID(dword dwIndex);
 	dword AllocUID( dword dwIndex, CObjBase * pObj );
 
@@ -102,6 +148,10 @@ public:
 	void InitUIDs();
 	void CloseAllUIDs();
 
+private:
+	UIDPage* AllocUIDPage(dword dwPage);
+	void PushFreeUID(dword dwIndex) noexcept;
+
 public:
 	CWorldThread();
 	virtual ~CWorldThread();
@@ -123,6 +173,7 @@ private:
 	// Clock stuff. how long have we been running ? all i care about.
 	friend class CWorldGameTime;
 	friend CServerTime;
+	friend class CBenchmark;
 	CWorldClock _GameClock;		// the current relative tick time (in milliseconds)
 
 	// Ticking world objects
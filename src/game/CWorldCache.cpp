@@ -1,14 +1,29 @@
+#include "../common/sphere_library/CSString.h"
 #include "../sphere/threads.h"
 #include "../sphere/ProfileTask.h"
 #include "uo_files/CUOMapList.h"
+#include "CSector.h"
+#include "CSectorList.h"
+#include "CServerConfig.h"
 #include "CWorldCache.h"
 
+// Max number of blocks loaded by the prefetch in a single tick.
+#define MAPBLOCK_PREFETCH_PER_TICK	16
+// Max number of blocks waiting to be prefetched.
+#define MAPBLOCK_PREFETCH_QUEUE_MAX	1024
+
+
 CWorldCache::CWorldCache()
 {
 	_iTimeLastMapBlockCacheCheck = 0;
+	_uiMapBlocksSize = 0;
 
-	for (int i = 0; i < MAP_SUPPORTED_QTY; ++i)
-		_mapBlocks[i].reset();
+	for (MapBlockCache& cache : _mapBlockCache)
+	{
+		cache._itLastBlock = _lruMapBlocks.end();
+		cache._iLastBlockIdx = -1;
+		cache._uiHits = cache._uiMisses = cache._uiEvictions = 0;
+	}
 }
 
 
@@ -21,14 +36,146 @@ static int _GetMapBlocksCount(int iMap)
 
 void CWorldCache::Init()
 {
+	// Blocks are loaded on demand, we only need to know how many blocks there can be for each map.
 	for (int i = 0; i < MAP_SUPPORTED_QTY; ++i)
 	{
 		if (!g_MapList.IsInitialized(i))
 			continue;
 
-		const int iBlocks = _GetMapBlocksCount(i);
-		_mapBlocks[i] = std::make_unique<MapBlockCacheCont[]>(iBlocks);
+		_mapBlockCache[i]._mapBlocks.reserve(size_t(_GetMapBlocksCount(i)) / 64);
+	}
+}
+
+const CServerMapBlock* CWorldCache::GetMapBlock(int iMap, int iBx, int iBy)
+{
+	// Get a map block from the cache. load it if not.
+	MapBlockCache& cache = _mapBlockCache[iMap];
+	const int iBlockIdx = (iBy * (g_MapList.GetMapSizeX(iMap) / UO_BLOCK_SIZE)) + iBx;
+
+	MapBlockLRU::iterator itRec;
+	if (cache._iLastBlockIdx == iBlockIdx)
+	{
+		itRec = cache._itLastBlock;
+	}
+	else
+	{
+		const auto itFound = cache._mapBlocks.find(iBlockIdx);
+		itRec = (itFound == cache._mapBlocks.end()) ? _lruMapBlocks.end() : itFound->second;
+	}
+
+	if (itRec != _lruMapBlocks.end())
+	{
+		// Found it in cache.
+		++cache._uiHits;
+		if (itRec != _lruMapBlocks.begin())
+			_lruMapBlocks.splice(_lruMapBlocks.begin(), _lruMapBlocks, itRec);
+	}
+	else
+	{
+		// else load and add it to the cache.
+		++cache._uiMisses;
+		itRec = _LoadMapBlock(iMap, iBx, iBy, iBlockIdx);
+		_CheckMapBlocksBudget();
+	}
+
+	cache._itLastBlock = itRec;
+	cache._iLastBlockIdx = iBlockIdx;
+	itRec->pBlock->m_CacheTime.HitCacheTime();
+	return itRec->pBlock.get();
+}
+
+CWorldCache::MapBlockLRU::iterator CWorldCache::_LoadMapBlock(int iMap, int iBx, int iBy, int iBlockIdx)
+{
+	auto pBlock = std::make_unique<CServerMapBlock>(iBx, iBy, iMap);
+	pBlock->m_CacheTime.HitCacheTime();
+	const size_t uiSize = sizeof(CServerMapBlock) + sizeof(MapBlockCacheRec) + (pBlock->m_Statics.GetStaticQty() * sizeof(CUOStaticItemRec));
+
+	_lruMapBlocks.push_front(MapBlockCacheRec{ std::move(pBlock), uiSize, iMap, iBlockIdx });
+	_mapBlockCache[iMap]._mapBlocks[iBlockIdx] = _lruMapBlocks.begin();
+	_uiMapBlocksSize += uiSize;
+	return _lruMapBlocks.begin();
+}
+
+void CWorldCache::_EvictMapBlock(MapBlockLRU::iterator itRec)
+{
+	MapBlockCache& cache = _mapBlockCache[itRec->iMap];
+	if (cache._iLastBlockIdx == itRec->iBlockIdx)
+	{
+		cache._itLastBlock = _lruMapBlocks.end();
+		cache._iLastBlockIdx = -1;
 	}
+	cache._mapBlocks.erase(itRec->iBlockIdx);
+	++cache._uiEvictions;
+
+	_uiMapBlocksSize -= itRec->uiSize;
+	_lruMapBlocks.erase(itRec);
+}
+
+void CWorldCache::_CheckMapBlocksBudget()
+{
+	const size_t uiBudget = size_t(g_Cfg._uiMapCacheSize) * 1024 * 1024;
+	if (uiBudget == 0)
+		return;
+
+	while ((_uiMapBlocksSize > uiBudget) && !_lruMapBlocks.empty())
+	{
+		const MapBlockLRU::iterator itOldest = std::prev(_lruMapBlocks.end());
+		// Blocks used during this tick may still be referenced by the caller (ie. the block above/below a point),
+		//  so the budget can be exceeded temporarily, until the next tick.
+		if (itOldest->pBlock->m_CacheTime.GetCacheAge() <= 0)
+			break;
+		_EvictMapBlock(itOldest);
+	}
+}
+
+void CWorldCache::PrefetchSector(const CSector* pSector)
+{
+	ADDTOCALLSTACK("CWorldCache::PrefetchSector");
+	// A client entered this sector: queue the blocks of this sector that aren't already cached,
+	//  they will be loaded a few per tick instead of all at once when the client walks on them or they enter its view.
+	const int iMap = pSector->GetMap();
+	const MapBlockCache& cache = _mapBlockCache[iMap];
+	const int iBXMax = g_MapList.GetMapSizeX(iMap) / UO_BLOCK_SIZE;
+	const int iBYMax = g_MapList.GetMapSizeY(iMap) / UO_BLOCK_SIZE;
+	const int iSectorBlocks = CSectorList::Get()->GetSectorSize(iMap) / UO_BLOCK_SIZE;
+	const CPointMap ptBase(pSector->GetBasePoint());
+	const int iBxStart = ptBase.m_x / UO_BLOCK_SIZE, iByStart = ptBase.m_y / UO_BLOCK_SIZE;
+
+	for (int iBy = iByStart; (iBy < iByStart + iSectorBlocks) && (iBy < iBYMax); ++iBy)
+	{
+		for (int iBx = iBxStart; (iBx < iBxStart + iSectorBlocks) && (iBx < iBXMax); ++iBx)
+		{
+			const int iBlockIdx = (iBy * iBXMax) + iBx;
+			if (cache._mapBlocks.count(iBlockIdx) == 0)
+				_queuePrefetch.emplace_back(iMap, iBlockIdx);
+		}
+	}
+
+	// Clients moving fast (teleporting, sailing) queue sectors that aren't relevant anymore, drop the oldest ones.
+	while (_queuePrefetch.size() > MAPBLOCK_PREFETCH_QUEUE_MAX)
+		_queuePrefetch.pop_front();
+}
+
+void CWorldCache::LoadPrefetchedBlocks()
+{
+	if (_queuePrefetch.empty())
+		return;
+
+	ADDTOCALLSTACK("CWorldCache::LoadPrefetchedBlocks");
+	const ProfileTask mapTask(PROFILE_MAP);
+	for (int iLoaded = 0; (iLoaded < MAPBLOCK_PREFETCH_PER_TICK) && !_queuePrefetch.empty(); )
+	{
+		const auto [iMap, iBlockIdx] = _queuePrefetch.front();
+		_queuePrefetch.pop_front();
+
+		if (_mapBlockCache[iMap]._mapBlocks.count(iBlockIdx) != 0)
+			continue;	// already loaded in the meanwhile
+
+		const int iBXMax = g_MapList.GetMapSizeX(iMap) / UO_BLOCK_SIZE;
+		_LoadMapBlock(iMap, iBlockIdx % iBXMax, iBlockIdx / iBXMax, iBlockIdx);
+		++iLoaded;
+	}
+	_CheckMapBlocksBudget();
 }
 
 void CWorldCache::CheckMapBlockCache(int64 iCurTime, int64 iCacheTime)
@@ -38,23 +185,87 @@ void CWorldCache::CheckMapBlockCache(int64 iCurTime, int64 iCacheTime)
 	// iTime == 0 = delete all.
 
 	const ProfileTask overheadTask(PROFILE_MAP);
-	for (int i = 0; i < MAP_SUPPORTED_QTY; ++i)
+	if (iCacheTime <= 0)
 	{
-		MapBlockCache& cache = _mapBlocks[i];
-		if (!cache)
-			continue;
-
-		const int iBlocks = _GetMapBlocksCount(i);
-		for (int j = 0; j < iBlocks; ++j)
+		for (MapBlockCache& cache : _mapBlockCache)
 		{
-			MapBlockCacheCont& block = cache[j];
-			if (!block)
-				continue;
-
-			if (iCacheTime <= 0 || (block->m_CacheTime.GetCacheAge() >= iCacheTime))
-				block.release();
+			cache._mapBlocks.clear();
+			cache._itLastBlock = _lruMapBlocks.end();
+			cache._iLastBlockIdx = -1;
+		}
+		_lruMapBlocks.clear();
+		_uiMapBlocksSize = 0;
+	}
+	else
+	{
+		// The least recently used blocks are at the end of the list: stop at the first one used recently.
+		while (!_lruMapBlocks.empty())
+		{
+			const MapBlockLRU::iterator itOldest = std::prev(_lruMapBlocks.end());
+			if (itOldest->pBlock->m_CacheTime.GetCacheAge() < iCacheTime)
+				break;
+			_EvictMapBlock(itOldest);
 		}
+		_CheckMapBlocksBudget();
 	}
 
 	_iTimeLastMapBlockCacheCheck = iCurTime + iCacheTime;
-}
\ No newline at end of file
+}
+
+size_t CWorldCache::GetMapBlocksSize() const noexcept
+{
+	return _uiMapBlocksSize;
+}
+
+size_t CWorldCache::GetMapBlocksCount(int iMap) const noexcept
+{
+	return _mapBlockCache[iMap]._mapBlocks.size();
+}
+
+ullong CWorldCache::GetMapBlocksHits(int iMap) const noexcept
+{
+	return _mapBlockCache[iMap]._uiHits;
+}
+
+ullong CWorldCache::GetMapBlocksMisses(int iMap) const noexcept
+{
+	return _mapBlockCache[iMap]._uiMisses;
+}
+
+ullong CWorldCache::GetMapBlocksEvictions(int iMap) const noexcept
+{
+	return _mapBlockCache[iMap]._uiEvictions;
+}
+
+bool CWorldCache::WriteStatsVal(lpctstr ptcKey, CSString& sVal) const
+{
+	ADDTOCALLSTACK("CWorldCache::WriteStatsVal");
+	// MAPCACHE.SIZE: memory used by the cached map blocks, in KB.
+	// MAPCACHE.n.BLOCKS/HITS/MISSES/EVICTIONS: cache stats for map n.
+	if (!strcmpi(ptcKey, "SIZE"))
+	{
+		sVal.FormatSTVal(_uiMapBlocksSize / 1024);
+		return true;
+	}
+
+	if (!IsDigit(*ptcKey))
+		return false;
+	const int iMap = atoi(ptcKey);
+	while (IsDigit(*ptcKey))
+		++ptcKey;
+	if ((iMap >= MAP_SUPPORTED_QTY) || (*ptcKey != '.'))
+		return false;
+	++ptcKey;
+
+	if (!strcmpi(ptcKey, "BLOCKS"))
+		sVal.FormatSTVal(GetMapBlocksCount(iMap));
+	else if (!strcmpi(ptcKey, "HITS"))
+		sVal.FormatULLVal(GetMapBlocksHits(iMap));
+	else if (!strcmpi(ptcKey, "MISSES"))
+		sVal.FormatULLVal(GetMapBlocksMisses(iMap));
+	else if (!strcmpi(ptcKey, "EVICTIONS"))
+		sVal.FormatULLVal(GetMapBlocksEvictions(iMap));
+	else
+		return false;
+	return true;
+}
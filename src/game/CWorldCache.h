@@ -5,7 +5,13 @@
 #ifndef _INC_CWORLDCACHE_H
 #define _INC_CWORLDCACHE_H
 
+#include "../../lib/parallel_hashmap/phmap.h"
 #include "../common/CServerMap.h"
+#include <deque>
+#include <list>
+
+class CSector;
+class CSString;
 
 class CWorldCache
 {
@@ -13,10 +19,31 @@ class CWorldCache
 	friend class CWorldMap;
 
 	int64	_iTimeLastMapBlockCacheCheck;
-	
-	using MapBlockCacheCont = std::unique_ptr<CServerMapBlock>;
-	using MapBlockCache = std::unique_ptr<MapBlockCacheCont[]>;
-	MapBlockCache _mapBlocks[MAP_SUPPORTED_QTY];
+
+	struct MapBlockCacheRec
+	{
+		std::unique_ptr<CServerMapBlock> pBlock;
+		size_t uiSize;		// (approximate) memory used by this block
+		int iMap;
+		int iBlockIdx;
+	};
+	using MapBlockLRU = std::list<MapBlockCacheRec>;	// most recently used blocks first
+	MapBlockLRU _lruMapBlocks;
+	size_t _uiMapBlocksSize;	// (approximate) memory used by all the cached blocks
+
+	struct MapBlockCache
+	{
+		phmap::flat_hash_map<int, MapBlockLRU::iterator> _mapBlocks;	// block index -> cached block
+		MapBlockLRU::iterator _itLastBlock;	// last block requested, it's very likely to be requested again.
+		int _iLastBlockIdx;
+
+		ullong _uiHits;
+		ullong _uiMisses;
+		ullong _uiEvictions;
+	};
+	MapBlockCache _mapBlockCache[MAP_SUPPORTED_QTY];
+
+	std::deque<std::pair<int, int>> _queuePrefetch;	// blocks (map, block index) to be loaded in the next ticks
 
 public:
 	static const char* m_sClassName;
@@ -25,7 +52,22 @@ public:
 
 	void Init();
 
+	const CServerMapBlock* GetMapBlock(int iMap, int iBx, int iBy);
+	void PrefetchSector(const CSector* pSector);
+	void LoadPrefetchedBlocks();
 	void CheckMapBlockCache(int64 iCurTime, int64 iCacheTime);
+
+	bool WriteStatsVal(lpctstr ptcKey, CSString& sVal) const;
+	size_t GetMapBlocksSize() const noexcept;
+	size_t GetMapBlocksCount(int iMap) const noexcept;
+	ullong GetMapBlocksHits(int iMap) const noexcept;
+	ullong GetMapBlocksMisses(int iMap) const noexcept;
+	ullong GetMapBlocksEvictions(int iMap) const noexcept;
+
+private:
+	MapBlockLRU::iterator _LoadMapBlock(int iMap, int iBx, int iBy, int iBlockIdx);
+	void _EvictMapBlock(MapBlockLRU::iterator itRec);
+	void _CheckMapBlocksBudget();
 };
 
-#endif // _INC_CWORLDCACHE_H
\ No newline at end of file
+#endif // _INC_CWORLDCACHE_H
@@ -33,7 +33,7 @@ bool CWorldClock::Advance()
 {
 	ADDTOCALLSTACK("CWorldClock::Advance");
 	const int64 iSysClock_Cur = GetSystemClock();
-	const int64 iTimeDiff = iSysClock_Cur - _iSysClock_Prev;
+	const int64 iTimeDiff = (_iFixedStep > 0) ? _iFixedStep : (iSysClock_Cur - _iSysClock_Prev);
 
 	if (iTimeDiff == 0)
 		return false;
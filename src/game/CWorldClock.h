@@ -15,10 +15,11 @@ private:
 	CServerTime _timeClock;     // SERVER TIME on the current game loop cycle (CWorld::_OnTick method), used to advance the ticks.
 	int64 _iSysClock_Prev;	    // REAL WORLD TIME (in milliseconds) of the last game loop cycle.
 	CServerTime	_timeNextTick;	// SERVER TIME we'll run the next tick on (to do sector and other stuff).
+	int64 _iFixedStep;			// If > 0, milliseconds advanced on each game loop cycle instead of the real time elapsed (benchmark mode).
 
 public:
 	static const char* m_sClassName;
-	CWorldClock()
+	CWorldClock() : _iFixedStep(0)
 	{
 		Init();
 	}
@@ -32,6 +33,11 @@ public:
 	void InitTime(int64 iTimeBase);
 	bool Advance();
 
+	inline void SetFixedStep(int64 iMsecs) noexcept
+	{
+		_iFixedStep = iMsecs;
+	}
+
 	inline void AdvanceTick() noexcept
 	{
 		++_iTickCur;
@@ -256,23 +256,14 @@ const CServerMapBlock* CWorldMap::GetMapBlock(const CPointMap& pt) // static
 
 	const ProfileTask mapTask(PROFILE_MAP);
 
-	const int iBx = pt.m_x / UO_BLOCK_SIZE;
-	const int iBy = pt.m_y / UO_BLOCK_SIZE;
-	const int iBXMax = g_MapList.GetMapSizeX(pt.m_map) / UO_BLOCK_SIZE;
-	const int iBlockIdx = (iBy * iBXMax) + iBx;
-	CWorldCache::MapBlockCacheCont& block = g_World._Cache._mapBlocks[pt.m_map][iBlockIdx];
-	if (block)
-	{
-		// Found it in cache.
-		block->m_CacheTime.HitCacheTime();
-		return block.get();
-	}
-
-	// else load and add it to the cache.
-	block = std::make_unique<CServerMapBlock>(iBx, iBy, pt.m_map);
-	ASSERT(block);
+	return g_World._Cache.GetMapBlock(pt.m_map, pt.m_x / UO_BLOCK_SIZE, pt.m_y / UO_BLOCK_SIZE);
+}
 
-	return block.get();
+void CWorldMap::PrefetchMapBlocks(const CSector* pSector) // static
+{
+	ADDTOCALLSTACK("CWorldMap::PrefetchMapBlocks");
+	ASSERT(pSector);
+	g_World._Cache.PrefetchSector(pSector);
 }
 
 // Tile info fromMAP*.MUL at given coordinates
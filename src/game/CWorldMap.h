@@ -34,6 +34,7 @@ public:
 	// Map blocks (for caching) and terrain
 
 	static const CServerMapBlock* GetMapBlock(const CPointMap& pt);
+	static void PrefetchMapBlocks(const CSector* pSector);	// Queue the blocks of the sector to be loaded in the next ticks
 	static const CUOMapMeter* GetMapMeter(const CPointMap& pt); // Height of MAP0.MUL at given coordinates
 
 	static std::optional<CUOMapMeter> GetMapMeterAdjusted(const CPointMap& pt);
@@ -1,10 +1,14 @@
 #include "../common/CException.h"
+#include "../network/CClientIterator.h"
+#include "../network/send.h"
 #include "../sphere/threads.h"
 #include "../sphere/ProfileTask.h"
 #include "chars/CChar.h"
+#include "clients/CClient.h"
 #include "items/CItem.h"
 #include "items/CItemShip.h"
 #include "CSector.h"
+#include "CSectorList.h"
 #include "CWorldClock.h"
 #include "CWorldGameTime.h"
 #include "CWorldTicker.h"
@@ -16,6 +20,7 @@ CWorldTicker::CWorldTicker(CWorldClock *pClock)
     _pWorldClock = pClock;
 
     _iLastTickDone = 0;
+    _fStatusBroadcastsDeferred = false;
 }
 
 
@@ -46,6 +51,13 @@ void CWorldTicker::_RemoveTimedObject(const int64 iOldTimeout, CTimedObject* pTi
 {
     ASSERT(iOldTimeout != 0);
 
+    if (pTimedObject->_fDecayBucket)
+    {
+        // Its entry in the decay bucket will be found stale and discarded when the bucket expires.
+        pTimedObject->_fDecayBucket = false;
+        return;
+    }
+
     std::unique_lock<std::shared_mutex> lock(_mWorldTickList.THREAD_CMUTEX);
     auto itList = _mWorldTickList.find(iOldTimeout);
     if (itList == _mWorldTickList.end())
@@ -122,7 +134,7 @@ void CWorldTicker::AddTimedObject(const int64 iTimeout, CTimedObject* pTimedObje
         }
     }
     
-    if (fCanTick)
+    if (fCanTick && !_InsertDecayBucket(iTimeout, pTimedObject))
     {
         _InsertTimedObject(iTimeout, pTimedObject);
     }
@@ -147,6 +159,71 @@ void CWorldTicker::DelTimedObject(CTimedObject* pTimedObject)
 }
 
 
+// Decay of the items on the ground
+
+bool CWorldTicker::_InsertDecayBucket(const int64 iTimeout, CTimedObject* pTimedObject)
+{
+    const int64 iBucketTime = g_Cfg._iDecayBucketTime;
+    if ((iBucketTime <= 0) || (pTimedObject->_GetProfileType() != PROFILE_ITEMS))
+        return false;
+    if (iTimeout - CWorldGameTime::GetCurrentTime().GetTimeRaw() < iBucketTime)
+        return false;   // Short timers stay precise, a bucket would delay them too much.
+
+    const CItem* pItem = dynamic_cast<const CItem*>(pTimedObject);
+    if ((pItem == nullptr) || !pItem->IsAttr(ATTR_DECAY) || !pItem->IsTopLevel())
+        return false;
+    const CSector* pSector = pItem->GetTopSector();
+    if (pSector == nullptr)
+        return false;
+
+    const int64 iBucket = ((iTimeout + iBucketTime - 1) / iBucketTime) * iBucketTime;
+    {
+        std::unique_lock<std::shared_mutex> lock(_mDecayBuckets.THREAD_CMUTEX);
+        _mDecayBuckets[iBucket][pSector].emplace_back(DecayEntry{pItem->GetUID().GetPrivateUID(), iTimeout});
+    }
+    pTimedObject->_fDecayBucket = true;
+    return true;
+}
+
+void CWorldTicker::_SelectDecayBuckets(const int64 iCurTime, std::vector<void*>& vecObjs)
+{
+    // Take all the expired buckets at once, their items are already grouped by sector.
+    std::vector<DecayEntry> vecEntries;
+    {
+        std::unique_lock<std::shared_mutex> lock(_mDecayBuckets.THREAD_CMUTEX);
+        auto itBucket = _mDecayBuckets.begin();
+        while ((itBucket != _mDecayBuckets.end()) && (iCurTime > itBucket->first))
+        {
+            for (const auto& sectorEntries : itBucket->second)
+                vecEntries.insert(vecEntries.end(), sectorEntries.second.begin(), sectorEntries.second.end());
+            itBucket = _mDecayBuckets.erase(itBucket);
+        }
+    }
+
+    for (const DecayEntry& entry : vecEntries)
+    {
+        CObjBase* pObj = CUID::ObjFindFromUID(entry.dwUID, true);
+        if ((pObj == nullptr) || !pObj->IsItem())
+            continue;
+        CItem* pItem = static_cast<CItem*>(pObj);
+        if (!pItem->_fDecayBucket || (pItem->_GetTimeoutRaw() != entry.iTimeout))
+            continue;   // Stale: the timer was changed or cleared, or the UID now belongs to another item.
+
+        pItem->_fDecayBucket = false;
+        if (pItem->_CanTick())
+        {
+            vecObjs.emplace_back(static_cast<void*>(static_cast<CTimedObject*>(pItem)));
+            pItem->_ClearTimeout();
+        }
+        else
+        {
+            // Wait in the precise list until it can tick, like the other timers.
+            _InsertTimedObject(entry.iTimeout, pItem);
+        }
+    }
+}
+
+
 // CChar Periodic Ticks (it's a different thing than TIMER!)
 
 void CWorldTicker::_InsertCharTicking(const int64 iTickNext, CChar* pChar)
@@ -279,6 +356,194 @@ void CWorldTicker::DelObjStatusUpdate(CObjBase* pObj, bool fNeedsLock) // static
     EXC_CATCH;
 }
 
+void CWorldTicker::AddObjStatusBroadcast(const CObjBase* pObj, uchar uiFlags)
+{
+    EXC_TRY("AddObjStatusBroadcast");
+
+    {
+        std::unique_lock<std::shared_mutex> lock(_ObjStatusBroadcasts.THREAD_CMUTEX);
+        _ObjStatusBroadcasts[pObj->GetUID().GetPrivateUID()] |= uiFlags;
+    }
+
+    EXC_CATCH;
+}
+
+void CWorldTicker::_FlushStatusBroadcasts()
+{
+    ADDTOCALLSTACK("CWorldTicker::_FlushStatusBroadcasts");
+    // Send to the nearby clients the hits bars and the tooltips changed during this tick: the changed objects are grouped by sector,
+    //  and each group is checked only for the clients in the sectors around it.
+    //  Every object is sent at most once per client per tick, no matter how many times it changed; what doesn't fit in
+    //  the client's StatusUpdateBudget is kept in the client's deferred list and sent (in its updated state) in the next ticks.
+
+    std::vector<std::pair<dword, uchar>> vecBatch;
+    {
+        std::unique_lock<std::shared_mutex> lock(_ObjStatusBroadcasts.THREAD_CMUTEX);
+        vecBatch.assign(_ObjStatusBroadcasts.begin(), _ObjStatusBroadcasts.end());
+        _ObjStatusBroadcasts.clear();
+    }
+    if (vecBatch.empty() && !_fStatusBroadcastsDeferred)
+        return;
+    const bool fDeferred = _fStatusBroadcastsDeferred;
+    _fStatusBroadcastsDeferred = false;
+
+    // Group the changed objects by the sector they are in: each one is checked only for the clients near its sector.
+    struct SectorObj
+    {
+        const CSector* pSector;
+        size_t uiBatchIndex;
+        int iViewDist;
+    };
+    std::vector<SectorObj> vecSectorObjs;
+    vecSectorObjs.reserve(vecBatch.size());
+    for (size_t i = 0; i < vecBatch.size(); ++i)
+    {
+        CObjBase* pObj = CUID::ObjFindFromUID(vecBatch[i].first, true);
+        if (pObj == nullptr)
+            continue;
+
+        // The tooltip changed: drop the cached property list, the first client receiving it will build the new one.
+        if (vecBatch[i].second & SU_UPDATE_TOOLTIP)
+            pObj->FreePropertyList();
+
+        if (pObj->IsDisconnected())
+            continue;
+        const CSector* pSector = pObj->GetTopSector();
+        if (pSector == nullptr)
+            continue;
+
+        int iViewDist = UO_MAP_VIEW_SIZE_MAX;
+        if (pObj->IsItem() && static_cast<const CItem*>(pObj)->IsTypeMulti())
+            iViewDist += static_cast<const CItemMulti*>(pObj)->Multi_GetDistanceMax();  // multis are seen from farther
+        vecSectorObjs.push_back({ pSector, i, iViewDist });
+    }
+    std::sort(vecSectorObjs.begin(), vecSectorObjs.end(),
+        [](const SectorObj& a, const SectorObj& b) noexcept {
+            return (a.pSector != b.pSector) ? std::less<const CSector*>()(a.pSector, b.pSector) : (a.uiBatchIndex < b.uiBatchIndex);
+        });
+
+    // Pairs of client and index of the changed object in vecBatch (SIZE_MAX: the client has only objects deferred in the previous ticks).
+    std::vector<std::pair<CClient*, size_t>> vecClientEntries;
+    const CSectorList* pSectors = CSectorList::Get();
+    for (size_t i = 0; i < vecSectorObjs.size(); )
+    {
+        const CSector* pSector = vecSectorObjs[i].pSector;
+        int iViewDist = 0;
+        size_t j = i;
+        for (; (j < vecSectorObjs.size()) && (vecSectorObjs[j].pSector == pSector); ++j)
+            iViewDist = maximum(iViewDist, vecSectorObjs[j].iViewDist);
+
+        // Start from the center of the sector, so every object in it is within half a sector from there.
+        CPointMap ptCenter = pSector->GetBasePoint();
+        const int iHalfSector = pSectors->GetSectorSize(ptCenter.m_map) / 2;
+        ptCenter.m_x += (short)iHalfSector;
+        ptCenter.m_y += (short)iHalfSector;
+
+        ClientNearbyIterator itNearby(ptCenter, iViewDist + iHalfSector);
+        for (CClient* pClient = itNearby.next(); pClient != nullptr; pClient = itNearby.next())
+        {
+            for (size_t k = i; k < j; ++k)
+                vecClientEntries.emplace_back(pClient, vecSectorObjs[k].uiBatchIndex);
+        }
+        i = j;
+    }
+
+    if (fDeferred)
+    {
+        ClientIterator it;
+        for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
+        {
+            if (!pClient->m_mapStatusDeferred.empty())
+                vecClientEntries.emplace_back(pClient, SIZE_MAX);
+        }
+    }
+
+    // Sorting groups the entries by client, keeping the order of the batch.
+    std::sort(vecClientEntries.begin(), vecClientEntries.end());
+
+    const uint uiBudget = g_Cfg._uiStatusUpdateBudget;
+    std::vector<std::pair<dword, uchar>> vecClientObjs;
+
+    for (size_t i = 0; i < vecClientEntries.size(); )
+    {
+        CClient* pClient = vecClientEntries[i].first;
+        size_t j = i;
+        while ((j < vecClientEntries.size()) && (vecClientEntries[j].first == pClient))
+            ++j;
+        const size_t uiEntriesStart = i;
+        const size_t uiEntriesEnd = j;
+        i = j;
+
+        auto& mapDeferred = pClient->m_mapStatusDeferred;
+        const CChar* pCharClient = pClient->GetChar();
+        if (pCharClient == nullptr)
+        {
+            mapDeferred.clear();
+            continue;
+        }
+
+        // Objects deferred in the previous ticks go first, merged with the changes they had in this tick.
+        vecClientObjs.clear();
+        for (size_t k = uiEntriesStart; k < uiEntriesEnd; ++k)
+        {
+            if (vecClientEntries[k].second == SIZE_MAX)
+                continue;
+            const std::pair<dword, uchar>& entry = vecBatch[vecClientEntries[k].second];
+            auto itDeferred = mapDeferred.find(entry.first);
+            if (itDeferred != mapDeferred.end())
+                itDeferred->second |= entry.second;
+        }
+        vecClientObjs.insert(vecClientObjs.end(), mapDeferred.begin(), mapDeferred.end());
+        for (size_t k = uiEntriesStart; k < uiEntriesEnd; ++k)
+        {
+            if (vecClientEntries[k].second == SIZE_MAX)
+                continue;
+            const std::pair<dword, uchar>& entry = vecBatch[vecClientEntries[k].second];
+            if (mapDeferred.count(entry.first) == 0)
+                vecClientObjs.emplace_back(entry);
+        }
+        mapDeferred.clear();
+
+        uint uiSent = 0;
+        for (const std::pair<dword, uchar>& entry : vecClientObjs)
+        {
+            CObjBase* pObj = CUID::ObjFindFromUID(entry.first, true);
+            if ((pObj == nullptr) || pObj->IsDisconnected())
+                continue;
+
+            if (uiBudget && (uiSent >= uiBudget))
+            {
+                mapDeferred.emplace(entry);
+                _fStatusBroadcastsDeferred = true;
+                continue;
+            }
+
+            if ((entry.second & SU_UPDATE_HITS) && pObj->IsChar())
+            {
+                const CChar* pChar = static_cast<const CChar*>(pObj);
+                if ((pChar->GetClientActive() != pClient) && pClient->CanSee(pChar))
+                {
+                    PacketHealthUpdate cmd(pChar, false);
+                    cmd.send(pClient);
+                    uiSent += cmd.getLength();
+                }
+            }
+
+            if ((entry.second & SU_UPDATE_TOOLTIP) && pCharClient->CanSee(pObj))
+            {
+                if (pClient->addAOSTooltip(pObj, false))
+                {
+                    // Sent at least once, so now the updated tooltip is cached.
+                    pObj->m_fStatusUpdate &= ~SU_UPDATE_TOOLTIP;
+
+                    const PacketPropertyList* pPropList = pObj->GetPropertyList();
+                    uiSent += ((g_Cfg.m_iTooltipMode == TOOLTIPMODE_SENDVERSION) || (pPropList == nullptr)) ? 9 : pPropList->getLength();
+                }
+            }
+        }
+    }
+}
+
 // Check timeouts and do ticks
 
 void CWorldTicker::Tick()
@@ -399,6 +664,11 @@ void CWorldTicker::Tick()
 
             EXC_CATCHSUB("");
         }
+        {
+            EXC_TRYSUB("Decay Buckets Selection");
+            _SelectDecayBuckets(iCurTime, vecObjs);
+            EXC_CATCHSUB("");
+        }
 
         lpctstr ptcSubDesc;
         for (void* pObjVoid : vecObjs)    // Loop through all msecs stored, unless we passed the timestamp.
@@ -596,5 +866,11 @@ void CWorldTicker::Tick()
         EXC_CATCHSUB("");
     }
 
+
+    /* Send the status changes accumulated during this tick */
+
+    EXC_SET_BLOCK("StatusBroadcasts");
+    _FlushStatusBroadcasts();
+
     EXC_CATCH;
 }
\ No newline at end of file
@@ -14,6 +14,8 @@
 
 class CObjBase;
 class CChar;
+class CItem;
+class CSector;
 class CWorldClock;
 
 class CWorldTicker
@@ -36,17 +38,39 @@ private:
         THREAD_CMUTEX_DEF;
     };
 
+    // Items decaying on the ground are the most of the timers and they don't need to be precise: instead of having each one in
+    //  the precise list, they are grouped in buckets of DecayBucketTime msecs (by the end of the bucket, so they can only decay
+    //  a bit later, never earlier), and in each bucket by sector, then a whole bucket is processed at once.
+    // The items are stored by UID and the entries aren't removed when the timer changes: they are checked when the bucket expires.
+    struct DecayEntry
+    {
+        dword dwUID;
+        int64 iTimeout;     // the timeout the item had when added, if it changed in the meanwhile this entry is stale
+    };
+    using DecayBucket = phmap::flat_hash_map<const CSector*, std::vector<DecayEntry>>;
+    struct DecayBucketList : public std::map<int64, DecayBucket>
+    {
+        THREAD_CMUTEX_DEF;
+    };
+
     struct StatusUpdatesList : public phmap::parallel_flat_hash_set<CObjBase*>
     //struct StatusUpdatesList : public std::unordered_set<CObjBase*>
     {
         THREAD_CMUTEX_DEF;
     };
 
+    struct StatusBroadcastList : public phmap::parallel_flat_hash_map<dword, uchar>
+    {
+        THREAD_CMUTEX_DEF;
+    };
+
     WorldTickList _mWorldTickList;
     CharTickList _mCharTickList;
+    DecayBucketList _mDecayBuckets;
 
     friend class CWorldTickingList;
     StatusUpdatesList _ObjStatusUpdates;   // objects that need OnTickStatusUpdate called
+    StatusBroadcastList _ObjStatusBroadcasts;   // UIDs (and SU_* flags) of objects whose hits bar/tooltip has to be sent to the nearby clients at the end of the tick
 
     friend class CWorld;
     friend class CWorldTimedFunctions;
@@ -54,6 +78,7 @@ private:
 
     CWorldClock* _pWorldClock;
     int64        _iLastTickDone;  
+    bool         _fStatusBroadcastsDeferred;  // some client has status broadcasts left over from the previous ticks
 
 public:
     void Tick();
@@ -64,12 +89,16 @@ public:
     void DelCharTicking(CChar* pChar, bool fNeedsLock);
     void AddObjStatusUpdate(CObjBase* pObj, bool fNeedsLock);
     void DelObjStatusUpdate(CObjBase* pObj, bool fNeedsLock);
+    void AddObjStatusBroadcast(const CObjBase* pObj, uchar uiFlags);
 
 private:
     void _InsertTimedObject(const int64 iTimeout, CTimedObject* pTimedObject);
     void _RemoveTimedObject(const int64 iOldTimeout, CTimedObject* pTimedObject);
+    bool _InsertDecayBucket(const int64 iTimeout, CTimedObject* pTimedObject);
+    void _SelectDecayBuckets(const int64 iCurTime, std::vector<void*>& vecObjs);
     void _InsertCharTicking(const int64 iTickNext, CChar* pChar);
     void _RemoveCharTicking(const int64 iOldTimeout, CChar* pChar);
+    void _FlushStatusBroadcasts();
 };
 
 #endif // _INC_CWORLDTICKER_H
@@ -34,6 +34,11 @@ void CWorldTickingList::DelObjStatusUpdate(CObjBase* pObj, bool fNeedsLock) // s
     g_World._Ticker.DelObjStatusUpdate(pObj, fNeedsLock);
 }
 
+void CWorldTickingList::AddObjStatusBroadcast(const CObjBase* pObj, uchar uiFlags) // static
+{
+    g_World._Ticker.AddObjStatusBroadcast(pObj, uiFlags);
+}
+
 
 void CWorldTickingList::ClearTickingLists() // static
 {
@@ -45,6 +50,10 @@ void CWorldTickingList::ClearTickingLists() // static
         std::unique_lock<std::shared_mutex> lock(g_World._Ticker._mCharTickList.THREAD_CMUTEX);
         g_World._Ticker._mCharTickList.clear();
     }
+    {
+        std::unique_lock<std::shared_mutex> lock(g_World._Ticker._mDecayBuckets.THREAD_CMUTEX);
+        g_World._Ticker._mDecayBuckets.clear();
+    }
     {
         std::unique_lock<std::shared_mutex> lock(g_World._Ticker._ObjStatusUpdates.THREAD_CMUTEX);
         g_World._Ticker._ObjStatusUpdates.clear();
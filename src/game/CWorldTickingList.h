@@ -23,6 +23,8 @@ public:
     static void AddObjStatusUpdate(CObjBase* pObj, bool fNeedsLock);
     static void DelObjStatusUpdate(CObjBase* pObj, bool fNeedsLock);
 
+    static void AddObjStatusBroadcast(const CObjBase* pObj, uchar uiFlags);
+
 private:
     friend class CWorld;
     static void ClearTickingLists();
@@ -483,6 +483,12 @@ void CChar::ClientDetach()
 			pShipItem->Stop();
 	}
 
+	if ( !IsDisconnected() )
+	{
+		CSector* pSector = GetTopSector();
+		if ( pSector )
+			pSector->m_Chars_Active.RemoveClientChar(this);
+	}
     m_pClient = nullptr;
 }
 
@@ -499,6 +505,13 @@ void CChar::ClientAttach( CClient * pClient )
 	m_pPlayer->_iTimeLastUsed = CWorldGameTime::GetCurrentTime().GetTimeRaw();
 
 	m_pClient = pClient;
+	if ( !IsDisconnected() )
+	{
+		// Possessing a char already in the world: it won't be added again to the sector.
+		CSector* pSector = GetTopSector();
+		if ( pSector )
+			pSector->m_Chars_Active.AddClientChar(this);
+	}
 	FixClimbHeight();
 }
 
@@ -4800,10 +4813,9 @@ bool CChar::OnTriggerSpeech( bool bIsPet, lpctstr pszText, CChar * pSrc, TALKMOD
 			CResourceLink * pLink	= dynamic_cast <CResourceLink *>( pDef );
 			if ( pLink )
 			{
-				CResourceLock	s;
-				if ( pLink->ResourceLock(s) && pLink->HasTrigger(XTRIG_UNKNOWN) )
+				if ( pLink->IsLinked() && pLink->HasTrigger(XTRIG_UNKNOWN) )
 				{
-					TRIGRET_TYPE iRet = OnHearTrigger(s, pszText, pSrc, mode, wHue);
+					TRIGRET_TYPE iRet = OnHearTrigger(pLink, pszText, pSrc, mode, wHue);
 					if ( iRet == TRIGRET_RET_TRUE )
 						return true;
 					else if ( iRet == TRIGRET_RET_HALFBAKED )
@@ -4835,11 +4847,7 @@ lbl_cchar_ontriggerspeech:
 			if ( !pLinkDSpeech )
 				continue;
 
-			CResourceLock sDSpeech;
-			if ( !pLinkDSpeech->ResourceLock(sDSpeech) )
-				continue;
-
-			TRIGRET_TYPE iRet = OnHearTrigger( sDSpeech, pszText, pSrc, mode, wHue );
+			TRIGRET_TYPE iRet = OnHearTrigger( pLinkDSpeech, pszText, pSrc, mode, wHue );
 			if ( iRet == TRIGRET_RET_TRUE )
 				return true;
 			else if ( iRet == TRIGRET_RET_HALFBAKED )
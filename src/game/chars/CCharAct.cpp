@@ -1224,7 +1224,7 @@ bool CChar::UpdateAnimate(ANIM_TYPE action, bool fTranslate, bool fBackward , by
 	PacketActionBasic* cmdnew = new PacketActionBasic(this, action1, subaction, variation);
 	PacketAction* cmd = new PacketAction(this, action, 1, fBackward, iFrameDelay, iAnimLen);
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if (!pClient->CanSee(this))
@@ -1253,7 +1253,7 @@ void CChar::UpdateMode( CClient * pExcludeClient, bool fFull )
 	if ( pExcludeClient == nullptr )
 		m_fStatusUpdate &= ~SU_UPDATE_MODE;
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for ( CClient* pClient = it.next(); pClient != nullptr; pClient = it.next() )
 	{
 		if ( pExcludeClient == pClient )
@@ -1315,7 +1315,7 @@ void CChar::UpdateMove( const CPointMap & ptOld, CClient * pExcludeClient, bool
     }
 	
 	EXC_SET_BLOCK("FOR LOOP");
-	ClientIterator it;
+	ClientNearbyIterator it(GetTopPoint(), ptOld);	// who sees me now and who could see me before
 	for ( CClient* pClient = it.next(); pClient != nullptr; pClient = it.next() )
 	{
 		if ( pClient == pExcludeClient )
@@ -1401,7 +1401,7 @@ void CChar::Update(const CClient * pClientExclude )
 	if ( pClientExclude == nullptr)
 		m_fStatusUpdate &= ~SU_UPDATE_MODE;
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for ( CClient* pClient = it.next(); pClient != nullptr; pClient = it.next() )
 	{
 		if ( pClient == pClientExclude )
@@ -3877,6 +3877,8 @@ bool CChar::MoveToRegion( CRegionWorld * pNewArea, bool fAllowReject )
 	}
 
 	m_pArea = pNewArea;
+	if ( pNewArea && pNewArea->IsFlag(REGION_FLAG_SHIP) )
+		CCMultiMovable::OnBoard(pNewArea, this);
 	return true;
 }
 
@@ -3975,6 +3977,13 @@ bool CChar::MoveToChar(const CPointMap& pt, bool fStanding, bool fCheckLocation,
 		SetDisconnected(pSector);
         SetTopPoint(pt); // This will clear the disconnected UID flag and the set the character position in the world.
 		SetDisconnected(); //Before entering here the player is not considered disconnected anymore, so we need to disconnect it again.
+
+		if ( !g_Serv.IsLoading() && !CCMultiMovable::IsMovingObjs() )
+		{
+			const CRegionWorld * pShipArea = dynamic_cast<const CRegionWorld *>(pt.GetRegion(REGION_TYPE_SHIP));
+			if ( pShipArea )
+				CCMultiMovable::OnBoard(pShipArea, this);
+		}
 		return true;
 	}
 
@@ -4000,6 +4009,13 @@ bool CChar::MoveToChar(const CPointMap& pt, bool fStanding, bool fCheckLocation,
 
 	if ( fSectorChanged && !g_Serv.IsLoading() )
 	{
+		if ( pClient )
+		{
+			if ( (ptOld.m_map == ptCur.m_map) && ptOld.IsValidPoint() )
+				pNewSector->WakeAhead(ptOld.GetSector());
+			CWorldMap::PrefetchMapBlocks(pNewSector);
+		}
+
 		if ( IsTrigUsed(TRIGGER_ENVIRONCHANGE) )
 		{
 			CScriptTriggerArgs Args(ptOld.m_x, ptOld.m_y, ((uchar)ptOld.m_z << 16) | ptOld.m_map);
@@ -4382,8 +4398,7 @@ void CChar::OnTickStatusUpdate()
 	{
 		if ( m_fStatusUpdate & SU_UPDATE_HITS )
 		{
-			PacketHealthUpdate *cmd = new PacketHealthUpdate(this, false);
-			UpdateCanSee(cmd, m_pClient);		// send hits update to all nearby clients
+			CWorldTickingList::AddObjStatusBroadcast(this, SU_UPDATE_HITS);	// send hits update to all nearby clients, at the end of the tick
 			m_fStatusUpdate &= ~SU_UPDATE_HITS;
 		}
 		_iTimeLastHitsUpdate = iTimeCur;
@@ -291,12 +291,9 @@ void CChar::NPC_OnHear( lpctstr pszCmd, CChar * pSrc, bool fAllPets )
 	for ( size_t i = 0; i < m_pNPC->m_Speech.size(); ++i )
 	{
 		CResourceLink * pLink = m_pNPC->m_Speech[i].GetRef();
-		if ( !pLink )
-			continue;
-		CResourceLock s;
-		if ( !pLink->ResourceLock(s) || !pLink->HasTrigger(XTRIG_UNKNOWN) )
+		if ( !pLink || !pLink->HasTrigger(XTRIG_UNKNOWN) )
 			continue;
-		TRIGRET_TYPE iRet = OnHearTrigger(s, pszCmd, pSrc, mode);
+		TRIGRET_TYPE iRet = OnHearTrigger(pLink, pszCmd, pSrc, mode);
 		if ( iRet == TRIGRET_ENDIF || iRet == TRIGRET_RET_FALSE )
 			continue;
 		if ( iRet == TRIGRET_RET_DEFAULT && skill == m_Act_SkillCurrent )
@@ -314,10 +311,7 @@ void CChar::NPC_OnHear( lpctstr pszCmd, CChar * pSrc, bool fAllPets )
 		CResourceLink * pLink = pCharDef->m_Speech[i].GetRef();
 		if ( !pLink )
 			continue;
-		CResourceLock s;
-		if ( !pLink->ResourceLock(s) )
-			continue;
-		TRIGRET_TYPE iRet = OnHearTrigger( s, pszCmd, pSrc, mode );
+		TRIGRET_TYPE iRet = OnHearTrigger( pLink, pszCmd, pSrc, mode );
 		if ( iRet == TRIGRET_ENDIF || iRet == TRIGRET_RET_FALSE )
 			continue;
 		if ( iRet == TRIGRET_RET_DEFAULT && skill == m_Act_SkillCurrent )
@@ -1105,15 +1099,17 @@ bool CChar::NPC_LookAround( bool fForceCheckItems )
 		iRange /= 4;
 
 	// Any interesting chars here ?
+	// The candidates come from the snapshot of the sector, shared with the other NPCs looking around from it in this tick:
+	//  check them again, they may have moved or gone away since then.
 	int iDist = 0;
-	CChar *pChar = nullptr;
-	CWorldSearch AreaChars(ptTop, iRange);
-	for (;;)
+	std::vector<dword> vUIDs;
+	pSector->GetPerception(false).Find(ptTop, iRange, vUIDs);
+	for (const dword dwUID : vUIDs)
 	{
-		pChar = AreaChars.GetChar();
-		if ( !pChar )
-			break;
-		if ( pChar == this )	// just myself.
+		CChar *pChar = CUID::CharFindFromUID(dwUID, true);
+		if ( !pChar || (pChar == this) )	// gone, or just myself.
+			continue;
+		if ( pChar->IsDisconnected() || (ptTop.GetDist(pChar->GetTopPoint()) > iRange) )
 			continue;
 
 		iDist = GetTopDist3D(pChar);
@@ -1135,13 +1131,13 @@ bool CChar::NPC_LookAround( bool fForceCheckItems )
 
 	if ( fForceCheckItems )
 	{
-		CItem *pItem = nullptr;
-		CWorldSearch AreaItems(ptTop, iRange);
-		for (;;)
+		vUIDs.clear();
+		pSector->GetPerception(true).Find(ptTop, iRange, vUIDs);
+		for (const dword dwUID : vUIDs)
 		{
-			pItem = AreaItems.GetItem();
-			if ( !pItem )
-				break;
+			CItem *pItem = CUID::ItemFindFromUID(dwUID, true);
+			if ( !pItem || !pItem->IsTopLevel() || (ptTop.GetDist(pItem->GetTopPoint()) > iRange) )
+				continue;
 
 			iDist = GetTopDist3D(pItem);
 			if ( iDist > iRangeBlur )
@@ -452,7 +452,7 @@ bool CChar::Spell_Resurrection(CItemCorpse * pCorpse, CChar * pCharSrc, bool fNo
 	if (m_pNPC && m_pNPC->m_bonded)
 		m_CanMask &= ~CAN_C_GHOST;
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if (!pClient->CanSee(this))
@@ -1,3 +1,4 @@
+#include "../../common/crypto/CBCrypt.h"
 #include "../../common/crypto/CMD5.h"
 #include "../../common/CLog.h"
 #include "../../common/CException.h"
@@ -884,11 +885,25 @@ bool CAccount::CheckPassword( lpctstr pszPassword )
 	ADDTOCALLSTACK("CAccount::CheckPassword");
 	ASSERT(pszPassword);
 
+	const int iPre = CheckPasswordPre(pszPassword);
+	if ( iPre >= 0 )
+		return (iPre == 1);
+
+	if ( VerifyPassword(pszPassword, GetPassword(), g_Cfg.m_fMd5Passwords) )
+		return true;
+	return CheckNewPassword(pszPassword);
+}
+
+int CAccount::CheckPasswordPre( lpctstr pszPassword )
+{
+	ADDTOCALLSTACK("CAccount::CheckPasswordPre");
+	ASSERT(pszPassword);
+
 	if ( m_sCurPassword.IsEmpty() )
 	{
 		// If account password is empty, set the password given by the client trying to connect
 		if ( !SetPassword(pszPassword) )
-			return false;
+			return 0;
 	}
 
     CScriptTriggerArgs Args;
@@ -897,26 +912,35 @@ bool CAccount::CheckPassword( lpctstr pszPassword )
 	TRIGRET_TYPE tr = TRIGRET_RET_FALSE;
 	g_Serv.r_Call("f_onaccount_connect", &g_Serv, &Args, nullptr, &tr);
 	if ( tr == TRIGRET_RET_TRUE )
-		return false;
+		return 0;
 	if ( tr == TRIGRET_RET_HALFBAKED)
-		return true;
+		return 1;
+
+	return -1;	// the password has to be verified.
+}
+
+bool CAccount::VerifyPassword( lpctstr pszPassword, lpctstr pszStored, bool fMD5 ) // static
+{
+	// No ADDTOCALLSTACK: it can run outside the main thread.
+	if ( CBCrypt::IsBCryptHash(pszStored) )
+	{
+		// The password was stored hashed with bcrypt (ie. by a script, using BCRYPTHASH).
+		return CBCrypt::ValidateBCrypt(pszPassword, pszStored);
+	}
 
-	// Get the password.
-	if( g_Cfg.m_fMd5Passwords )
+	if( fMD5 )
 	{
 		// Hash the Password provided by the user and compare the hashes
 		char digest[33];
 		CMD5::fastDigest( digest, pszPassword );
-
-		if( !strcmpi( digest, GetPassword() ) )
-			return true;
-	}
-	else
-	{
-		if ( ! strcmpi( GetPassword(), pszPassword ) )
-			return true;
+		return !strcmpi( digest, pszStored );
 	}
+	return !strcmpi( pszStored, pszPassword );
+}
 
+bool CAccount::CheckNewPassword( lpctstr pszPassword )
+{
+	ADDTOCALLSTACK("CAccount::CheckNewPassword");
 	if ( ! m_sNewPassword.IsEmpty() && ! strcmpi( GetNewPassword(), pszPassword ))
 	{
 		// using the new password.
@@ -952,6 +976,13 @@ bool CAccount::SetPassword( lpctstr pszPassword, bool isMD5Hash )
 			return false;
 		}
 	}
+	if ( CBCrypt::IsBCryptHash(pszPassword) )
+	{
+		// Already hashed with bcrypt (by a script): store it as it is, it's verified with bcrypt at login.
+		m_sCurPassword = pszPassword;
+		return true;
+	}
+
 	size_t enteredPasswordLength = strlen(pszPassword);
 	if ( isMD5Hash && useMD5 ) // If it is a hash, check length and set it directly
 	{
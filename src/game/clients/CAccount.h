@@ -178,6 +178,24 @@ public:
 	*/
 	bool CheckPassword( lpctstr pszPassword );
 	/**
+	* @brief First part of CheckPassword, the one which must run in the main thread.
+	* If CAccount has no password, set the given one. Then server f_onaccount_connect trigger is fired.
+	* @param pszPassword pass to check.
+	* @return 1 if the password is accepted, 0 if refused, -1 if it has to be verified with VerifyPassword (and then CheckNewPassword).
+	*/
+	int CheckPasswordPre( lpctstr pszPassword );
+	/**
+	* @brief Compare the given password with the stored one (plain text, MD5 or bcrypt hash).
+	* It doesn't access the account, so it can be called from any thread.
+	* @return true if they match.
+	*/
+	static bool VerifyPassword( lpctstr pszPassword, lpctstr pszStored, bool fMD5 );
+	/**
+	* @brief Check if the given password is the new password. If so, it replaces the current one.
+	* @return true if it's the new password.
+	*/
+	bool CheckNewPassword( lpctstr pszPassword );
+	/**
 	* @brief Get new password.
 	* @return new password.
 	*/
@@ -6,6 +6,7 @@
 #include "../../network/CIPHistoryManager.h"
 #include "../../network/send.h"
 #include "../../network/packet.h"
+#include "../../sphere/asyncauth.h"
 #include "../chars/CChar.h"
 #include "../components/CCSpawn.h"
 #include "../items/CItemMultiCustom.h"
@@ -72,6 +73,9 @@ CClient::CClient(CNetState* state)
 	m_pPopupPacket = nullptr;
 	m_pHouseDesign = nullptr;
 	m_fUpdateStats = 0;
+	_uiAuthTicket = 0;
+	_iAuthResult = -1;
+	_uiAuthEventLen = 0;
 
     m_timeLastSkillThrowing = 0;
     m_pSkillThrowingTarg = nullptr;
@@ -93,6 +97,11 @@ CClient::~CClient()
 	if ( GetConnectType() != CONNECT_GAME )
 		--history.m_connecting;
 	--history.m_connected;
+	if ( history.m_connected <= 0 )
+		history.update();	// start to forget the ip from now: its expiry check will be scheduled again if it's earlier
+
+	if ( _uiAuthTicket != 0 )
+		g_asyncAuth.removeClient(_uiAuthTicket);
 
 	const bool fWasChar = ( m_pChar != nullptr );
 
@@ -697,6 +706,15 @@ bool CClient::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc,
         case CC_LASTEVENTWALK:
             sVal.FormatLLVal( m_timeLastEventWalk );
             break;
+		case CC_NETOUTBYTES:	// bytes sent since the connection was opened
+			sVal.FormatULLVal( GetNetState()->getOutBytes() );
+			break;
+		case CC_NETOUTCALLS:	// socket send calls done to send them
+			sVal.FormatULLVal( GetNetState()->getOutSendCalls() );
+			break;
+		case CC_NETOUTPACKETS:	// packets sent
+			sVal.FormatULLVal( GetNetState()->getOutPackets() );
+			break;
 		case CC_PRIVSHOW:
 			// Show my priv title.
 			sVal.FormatVal( ! IsPriv( PRIV_PRIV_NOSHOW ));
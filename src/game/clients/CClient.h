@@ -6,6 +6,7 @@
 #ifndef _INC_CCLIENT_H
 #define _INC_CCLIENT_H
 
+#include "../../../lib/parallel_hashmap/phmap.h"
 #include "../../common/crypto/CCrypto.h"
 #include "../../common/CScriptTriggerArgs.h"
 #include "../../common/CTextConsole.h"
@@ -25,6 +26,7 @@
 
 class CItemMap;
 class CItemMultiCustom;
+struct CDialogPacketCache;
 
 enum CV_TYPE
 {
@@ -112,6 +114,15 @@ private:
     CSectorEnviron m_Env;	// Last Environment Info Sent. so i don't have to keep resending if it's the same.
     uchar m_fUpdateStats;	// update our own status (weight change) when done with the cycle.
 
+    friend class CWorldTicker;
+    phmap::flat_hash_map<dword, uchar> m_mapStatusDeferred;	// hits bars/tooltips (UID -> SU_* flags) of nearby objects not sent yet because over the StatusUpdateBudget.
+
+	// Password verification done by the auth threads (see CAuthAsyncHelper).
+	dword _uiAuthTicket;		// != 0 while waiting for the result.
+	int _iAuthResult;			// -1 = no result to use, 0 = wrong password, 1 = password ok (used by LogIn when the login packet is processed again).
+	std::unique_ptr<CEvent> _pAuthEvent;	// login packet (already decrypted) to process again when the result arrives.
+	uint _uiAuthEventLen;
+
 	// Screensize
 	struct __screensize
 	{
@@ -266,7 +277,7 @@ private:
 	bool OnRxWebPageRequest( byte * pRequest, size_t len );
 
 	byte LogIn( CAccount * pAccount, CSString & sMsg );
-	byte LogIn( lpctstr pszName, lpctstr pPassword, CSString & sMsg );
+	byte LogIn( lpctstr pszName, lpctstr pPassword, CSString & sMsg, bool fAsyncAuth = false );
 
 	bool CanInstantLogOut() const;
 
@@ -355,11 +366,11 @@ public:
 	TRIGRET_TYPE Dialog_OnButton( const CResourceID& rid, dword dwButtonID, CObjBase * pObj, CDialogResponseArgs * pArgs );
 
 	bool Login_Relay( uint iServer ); // Relay player to a certain IP
-	byte Login_ServerList( const char * pszAccount, const char * pszPassword ); // Initial login (Login on "loginserver", new format)
+	byte Login_ServerList( const char * pszAccount, const char * pszPassword, bool fAsyncAuth = false ); // Initial login (Login on "loginserver", new format)
 
 	byte Setup_Delete( dword iSlot ); // Deletion of character
 	uint Setup_FillCharList(Packet* pPacket, const CChar * pCharFirst); // Write character list to packet
-	byte Setup_ListReq( const char * pszAccount, const char * pszPassword, bool fTest ); // Gameserver login and character listing
+	byte Setup_ListReq( const char * pszAccount, const char * pszPassword, bool fTest, bool fAsyncAuth = false ); // Gameserver login and character listing
 	byte Setup_Play( uint iSlot ); // After hitting "Play Character" button
 	byte Setup_Start( CChar * pChar ); // Send character startup stuff to player
 
@@ -408,6 +419,13 @@ public:
 	static uint xCompress( byte * pOutput, const byte * pInput, uint outLen, uint inLen );
 
 	bool xProcessClientSetup( CEvent * pEvent, uint uiLen );
+private:
+	bool xProcessClientSetupLogin( CEvent * pEvent, uint uiLen );
+public:
+	dword GetAuthTicket() const noexcept {
+		return _uiAuthTicket;
+	}
+	void OnAuthResult( bool fMatch );
 	bool xPacketFilter(const byte * pEvent, uint uiLen = 0);
 	bool xOutPacketFilter(const byte * pEvent, uint uiLen = 0);
 	bool xCanEncLogin(bool bCheckCliver = false);	// Login crypt check
@@ -526,6 +544,7 @@ public:
 	void addHitsUpdate( CChar * pChar );
 	void addManaUpdate( CChar * pChar );
 	void addStamUpdate( CChar * pChar );
+	void addStatsUpdate( CChar * pChar, uchar fStats );
 	void addHealthBarUpdate( const CChar * pChar ) const;
 	void addBondedStatus( const CChar * pChar, bool fIsDead ) const;
 	void addSkillWindow(SKILL_TYPE skill, bool fFromInfo = false) const; // Opens the skills list
@@ -541,7 +560,7 @@ public:
 	void addGumpInpVal( bool fcancel, INPVAL_STYLE style, dword dwmask, lpctstr ptext1, lpctstr ptext2, CObjBase * pObj );
 
 	void addItemMenu( CLIMODE_TYPE mode, const CMenuItem * item, uint count, CObjBase * pObj = nullptr );
-	void addGumpDialog( CLIMODE_TYPE mode, const CSString * sControls, uint iControls, const CSString * psText, uint iTexts, int x, int y, CObjBase * pObj = nullptr, dword dwRid = 0 );
+	void addGumpDialog( CLIMODE_TYPE mode, const CSString * sControls, uint iControls, const CSString * psText, uint iTexts, int x, int y, CObjBase * pObj = nullptr, dword dwRid = 0, CDialogPacketCache * pCache = nullptr );
 
 	bool addGumpDialogProps( const CUID& uid );
 
@@ -4,9 +4,11 @@
 #include "../../common/sphere_library/CSFileList.h"
 #include "../../common/CLog.h"
 #include "../../common/CException.h"
+#include "../../common/sphereversion.h"
 #include "../../network/CIPHistoryManager.h"
 #include "../../network/CNetworkManager.h"
 #include "../../network/send.h"
+#include "../../sphere/Metrics.h"
 #include "../CServer.h"
 #include "CClient.h"
 
@@ -83,7 +85,7 @@ bool CClient::addLoginErr(byte code)
 	// 3 = no password
 	// LOGIN_ERR_OTHER
 
-	if (code == PacketLoginError::Success)
+	if ((code == PacketLoginError::Success) || (code == PacketLoginError::Pending))
 		return true;
 
 	// console message to display for each login error code
@@ -278,7 +280,7 @@ bool CClient::Login_Relay( uint iRelay ) // Relay player to a selected IP
 	return addRelay( pServ );
 }
 
-byte CClient::Login_ServerList( const char * pszAccount, const char * pszPassword )
+byte CClient::Login_ServerList( const char * pszAccount, const char * pszPassword, bool fAsyncAuth )
 {
 	ADDTOCALLSTACK("CClient::Login_ServerList");
 	// XCMD_ServersReq
@@ -304,7 +306,7 @@ byte CClient::Login_ServerList( const char * pszAccount, const char * pszPasswor
 	// if ( LogIn( pszAccount, pszPassword ) )
 	//   return( PacketLoginError::BadPass );
 	CSString sMsg;
-	byte lErr = LogIn( pszAccount, pszPassword, sMsg );
+	byte lErr = LogIn( pszAccount, pszPassword, sMsg, fAsyncAuth );
 	if ( lErr != PacketLoginError::Success )
 	{
 		return( lErr );
@@ -801,6 +803,33 @@ bool CClient::OnRxWebPageRequest( byte * pRequest, size_t uiLen )
 		// Host: localhost:2593\r\n
 		// \r\n
 
+		if ( !g_Cfg._sMetricsPage.IsEmpty() && !strcmpi(ppRequest[1], g_Cfg._sMetricsPage.GetBuffer()) )
+		{
+			// Metrics scraping (Prometheus text format), generated on every request.
+			g_Log.Event(LOGM_HTTP|LOGL_EVENT, "%x:HTTP Metrics Request\n", GetSocketID());
+			CSString sBody, sHead;
+			g_Metrics.Export(sBody);
+			sHead.Format(
+				"HTTP/1.1 200 OK\r\n"
+				"Server: " SPHERE_TITLE " " SPHERE_BUILD_NAME_VER_PREFIX SPHERE_BUILD_INFO_STR "\r\n"
+				"Content-Type: text/plain; version=0.0.4\r\n"
+				"Content-Length: %d\r\n"
+				"Connection: close\r\n"
+				"\r\n",
+				sBody.GetLength());
+
+			PacketWeb packet;
+			packet.setData(reinterpret_cast<const byte *>(sHead.GetBuffer()), (uint)sHead.GetLength());
+			packet.send(this);
+			static constexpr int iChunkSize = 8 * 1024;
+			for ( int iOffset = 0; iOffset < sBody.GetLength(); iOffset += iChunkSize )
+			{
+				packet.setData(reinterpret_cast<const byte *>(sBody.GetBuffer() + iOffset), (uint)minimum(iChunkSize, sBody.GetLength() - iOffset));
+				packet.send(this);
+			}
+			return false;
+		}
+
 		tchar szPageName[_MAX_PATH];
 		if ( !Str_GetBare( szPageName, Str_TrimWhitespace(ppRequest[1]), sizeof(szPageName), "!\"#$%&()*,:;<=>?[]^{|}-+'`" ) )
 			return false;
@@ -864,7 +893,17 @@ bool CClient::xProcessClientSetup( CEvent * pEvent, uint uiLen )
         g_Log.EventError("NET-IN: xProcessClientSetup failed (Decrypt).\n");
         return false;
     }
-	
+
+	xRecordPacketData(this, pEvent->m_Raw, uiLen, "client->server");
+	return xProcessClientSetupLogin( pEvent, uiLen );
+}
+
+bool CClient::xProcessClientSetupLogin( CEvent * pEvent, uint uiLen )
+{
+	ADDTOCALLSTACK("CClient::xProcessClientSetupLogin");
+	// Process the (decrypted) login packet.
+	// It's processed again when the password verification done by the auth threads has finished.
+
     byte lErr = PacketLoginError::EncUnknown;
 	tchar szAccount[MAX_ACCOUNT_NAME_SIZE+3];
 
@@ -875,7 +914,7 @@ bool CClient::xProcessClientSetup( CEvent * pEvent, uint uiLen )
 			if ( uiLen < sizeof( pEvent->ServersReq ))
 				return false;
 
-			lErr = Login_ServerList( pEvent->ServersReq.m_acctname, pEvent->ServersReq.m_acctpass );
+			lErr = Login_ServerList( pEvent->ServersReq.m_acctname, pEvent->ServersReq.m_acctpass, true );
 			if ( lErr == PacketLoginError::Success )
 			{
 				Str_GetBare( szAccount, pEvent->ServersReq.m_acctname, sizeof(szAccount)-1 );
@@ -904,7 +943,7 @@ bool CClient::xProcessClientSetup( CEvent * pEvent, uint uiLen )
 			if ( uiLen < sizeof( pEvent->CharListReq ))
 				return false;
 
-			lErr = Setup_ListReq( pEvent->CharListReq.m_acctname, pEvent->CharListReq.m_acctpass, true );
+			lErr = Setup_ListReq( pEvent->CharListReq.m_acctname, pEvent->CharListReq.m_acctpass, true, true );
 			if ( lErr == PacketLoginError::Success )
 			{
 				// pass detected client version to the game server to make valid cliver used
@@ -972,7 +1011,17 @@ bool CClient::xProcessClientSetup( CEvent * pEvent, uint uiLen )
 #endif
 	}
 	
-	xRecordPacketData(this, pEvent->m_Raw, uiLen, "client->server");
+	if ( lErr == PacketLoginError::Pending )
+	{
+		// Waiting for the password verification: keep the packet, to resume the login when it's done.
+		if ( _pAuthEvent.get() != pEvent )
+		{
+			_pAuthEvent = std::make_unique<CEvent>();
+			memcpy(_pAuthEvent->m_Raw, pEvent->m_Raw, uiLen);
+			_uiAuthEventLen = uiLen;
+		}
+		return true;
+	}
 
 	if ( lErr != PacketLoginError::Success )	// it never matched any crypt format.
 	{
@@ -982,6 +1031,20 @@ bool CClient::xProcessClientSetup( CEvent * pEvent, uint uiLen )
 	return( lErr == PacketLoginError::Success );
 }
 
+void CClient::OnAuthResult( bool fMatch )
+{
+	ADDTOCALLSTACK("CClient::OnAuthResult");
+	// The auth threads verified the password: process again the login packet, this time LogIn will use this result.
+	_uiAuthTicket = 0;
+	if ( !_pAuthEvent )
+		return;
+
+	_iAuthResult = fMatch ? 1 : 0;
+	const std::unique_ptr<CEvent> pEvent(std::move(_pAuthEvent));
+	xProcessClientSetupLogin( pEvent.get(), _uiAuthEventLen );
+	_iAuthResult = -1;
+}
+
 bool CClient::xCanEncLogin(bool bCheckCliver)
 {
 	ADDTOCALLSTACK("CClient::xCanEncLogin");
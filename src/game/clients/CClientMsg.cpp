@@ -4,6 +4,7 @@
 #include "../../common/resource/CResourceLock.h"
 #include "../../common/CException.h"
 #include "../../network/send.h"
+#include "../../sphere/asyncauth.h"
 #include "../chars/CChar.h"
 #include "../chars/CCharNPC.h"
 #include "../items/CItemMap.h"
@@ -2125,6 +2126,12 @@ void CClient::UpdateStats()
 		addStatusWindow( m_pChar);
 		m_fUpdateStats = 0;
 	}
+	else if ( !!(m_fUpdateStats & SF_UPDATE_HITS) + !!(m_fUpdateStats & SF_UPDATE_MANA) + !!(m_fUpdateStats & SF_UPDATE_STAM) > 1 )
+	{
+		// More than one stat changed: send them together
+		addStatsUpdate( m_pChar, m_fUpdateStats );
+		m_fUpdateStats &= ~(SF_UPDATE_HITS|SF_UPDATE_MANA|SF_UPDATE_STAM);
+	}
 	else
 	{
 		if ( m_fUpdateStats & SF_UPDATE_HITS )
@@ -2211,6 +2218,31 @@ void CClient::addStamUpdate( CChar *pChar )
 	}
 }
 
+void CClient::addStatsUpdate( CChar *pChar, uchar fStats )
+{
+	ADDTOCALLSTACK("CClient::addStatsUpdate");
+	// Hits, mana and stamina in a single packet (the party members still receive only the stats that changed).
+	if ( !pChar )
+		return;
+
+	PacketStatsUpdate cmd(pChar);
+	cmd.send(this);
+
+	if ( pChar->m_pParty )
+	{
+		if ( fStats & SF_UPDATE_MANA )
+		{
+			PacketManaUpdate cmd2(pChar, false);
+			pChar->m_pParty->AddStatsUpdate(pChar, &cmd2);
+		}
+		if ( fStats & SF_UPDATE_STAM )
+		{
+			PacketStaminaUpdate cmd2(pChar, false);
+			pChar->m_pParty->AddStatsUpdate(pChar, &cmd2);
+		}
+	}
+}
+
 void CClient::addHealthBarUpdate( const CChar * pChar ) const
 {
 	ADDTOCALLSTACK("CClient::addHealthBarUpdate");
@@ -2925,7 +2957,7 @@ byte CClient::Setup_Delete( dword iSlot ) // Deletion of character
 	
 }
 
-byte CClient::Setup_ListReq( const char * pszAccName, const char * pszPassword, bool fTest )
+byte CClient::Setup_ListReq( const char * pszAccName, const char * pszPassword, bool fTest, bool fAsyncAuth )
 {
 	ADDTOCALLSTACK("CClient::Setup_ListReq");
 	// XCMD_CharListReq
@@ -2945,11 +2977,11 @@ byte CClient::Setup_ListReq( const char * pszAccName, const char * pszPassword,
 	}
 
 	CSString sMsg;
-	byte lErr = LogIn( pszAccName, pszPassword, sMsg );
+	byte lErr = LogIn( pszAccName, pszPassword, sMsg, fAsyncAuth );
 
 	if ( lErr != PacketLoginError::Success )
 	{
-		if ( fTest && lErr != PacketLoginError::Other )
+		if ( fTest && (lErr != PacketLoginError::Other) && (lErr != PacketLoginError::Pending) )
 		{
 			if ( ! sMsg.IsEmpty())
 				SysMessage( sMsg );
@@ -3096,7 +3128,7 @@ byte CClient::LogIn( CAccount * pAccount, CSString & sMsg )
 	return( PacketLoginError::Success );
 }
 
-byte CClient::LogIn( lpctstr ptcAccName, lpctstr ptcPassword, CSString & sMsg )
+byte CClient::LogIn( lpctstr ptcAccName, lpctstr ptcPassword, CSString & sMsg, bool fAsyncAuth )
 {
 	ADDTOCALLSTACK("CClient::LogIn");
 	// Try to validate this account.
@@ -3175,7 +3207,11 @@ byte CClient::LogIn( lpctstr ptcAccName, lpctstr ptcPassword, CSString & sMsg )
 		return PacketLoginError::Invalid;
 	}
 
-	if ( g_Cfg.m_iClientLoginMaxTries && !pAccount->CheckPasswordTries(GetPeer()) )
+	// Are we processing again the login packet, after the auth threads verified the password?
+	const int iAuthResult = _iAuthResult;
+	_iAuthResult = -1;
+
+	if ( (iAuthResult == -1) && g_Cfg.m_iClientLoginMaxTries && !pAccount->CheckPasswordTries(GetPeer()) )
 	{
 		g_Log.Event(LOGM_CLIENTS_LOG, "%x: '%s' exceeded password tries in time lapse\n", GetSocketID(), pAccount->GetName());
 		sMsg = g_Cfg.GetDefaultMsg(DEFMSG_MSG_ACC_BADPASS);
@@ -3184,7 +3220,30 @@ byte CClient::LogIn( lpctstr ptcAccName, lpctstr ptcPassword, CSString & sMsg )
 
 	if ( ! fGuestAccount && ! pAccount->IsPriv(PRIV_BLOCKED) )
 	{
-		if ( ! pAccount->CheckPassword(ptcPassword))
+		bool fPasswordOk;
+		if ( iAuthResult != -1 )
+		{
+			fPasswordOk = (iAuthResult == 1) || pAccount->CheckNewPassword(ptcPassword);
+		}
+		else if ( fAsyncAuth && g_asyncAuth.isEnabled() )
+		{
+			const int iPre = pAccount->CheckPasswordPre(ptcPassword);
+			if ( iPre == -1 )
+			{
+				// Hashing the password (bcrypt above all) can be slow: let the auth threads do it, the login will be resumed by OnAuthResult.
+				if ( _uiAuthTicket != 0 )
+					g_asyncAuth.removeClient(_uiAuthTicket);	// the result of the previous request isn't wanted anymore
+				_uiAuthTicket = g_asyncAuth.addRequest(this, ptcPassword, pAccount->GetPassword(), g_Cfg.m_fMd5Passwords);
+				return PacketLoginError::Pending;
+			}
+			fPasswordOk = (iPre == 1);
+		}
+		else
+		{
+			fPasswordOk = pAccount->CheckPassword(ptcPassword);
+		}
+
+		if ( !fPasswordOk )
 		{
 			g_Log.Event(LOGM_CLIENTS_LOG, "%x: '%s' bad password\n", GetSocketID(), pAccount->GetName());
 			sMsg = g_Cfg.GetDefaultMsg(DEFMSG_MSG_ACC_BADPASS);
@@ -27,10 +27,14 @@ enum ShipDelay
 };
 
 
+bool CCMultiMovable::sm_fMovingObjs = false;
+
+
 CCMultiMovable::CCMultiMovable(bool fCanTurn) :
     _shipSpeed{}
 {
     _fCanTurn = fCanTurn;
+    _fOccupantsListed = false;
     _eSpeedMode = SMS_NORMAL;
     _pCaptain = nullptr;
 }
@@ -121,6 +125,76 @@ void CCMultiMovable::SetNextMove()
     pItemThis->SetTimeout(iDelay);
 }
 
+void CCMultiMovable::OnBoard(const CRegionWorld* pRegion, const CObjBase* pObj) // static
+{
+    ADDTOCALLSTACK("CCMultiMovable::OnBoard");
+    // A char stepped in the region of a ship, or an item was dropped in it: move it along with the ship from now on.
+    if (!pRegion->IsFlag(REGION_FLAG_SHIP) || (pRegion->_pMultiLink == nullptr))
+        return;
+    CItemMulti *pMulti = pRegion->_pMultiLink;
+    if (pMulti == pObj)
+        return;
+
+    pMulti->_setOccupants.emplace(pObj->GetUID().GetObjUID());
+    if (pMulti->_setOccupants.size() > MAX_MULTI_TRACKED_OBJS)
+        pMulti->PruneOccupants();
+}
+
+void CCMultiMovable::SearchOccupants()
+{
+    ADDTOCALLSTACK("CCMultiMovable::SearchOccupants");
+    // Look for everything already inside the structure.
+    CItem *pItemThis = dynamic_cast<CItem*>(this);
+    ASSERT(pItemThis);
+    CItemMulti *pMulti = static_cast<CItemMulti*>(pItemThis);
+    const int iMaxDist = pMulti->Multi_GetDistanceMax();
+
+    CWorldSearch AreaChar(pItemThis->GetTopPoint(), iMaxDist);
+    AreaChar.SetAllShow(true);
+    AreaChar.SetSearchSquare(true);
+    for (CChar *pChar = AreaChar.GetChar(); pChar != nullptr; pChar = AreaChar.GetChar())
+    {
+        if (pMulti->GetRegion()->IsInside2d(pChar->GetTopPoint()))
+            _setOccupants.emplace(pChar->GetUID().GetObjUID());
+    }
+
+    CWorldSearch AreaItem(pItemThis->GetTopPoint(), iMaxDist);
+    AreaItem.SetSearchSquare(true);
+    for (CItem *pItem = AreaItem.GetItem(); pItem != nullptr; pItem = AreaItem.GetItem())
+    {
+        if ((pItem == pItemThis) || pMulti->Multi_IsPartOf(pItem))
+            continue;
+        if (pMulti->GetRegion()->IsInside2d(pItem->GetTopPoint()))
+            _setOccupants.emplace(pItem->GetUID().GetObjUID());
+    }
+}
+
+CObjBase * CCMultiMovable::FindOccupant(dword dwUID) const
+{
+    // Is this object still on the ground (or disconnected, for the chars) inside the structure?
+    const CItemMulti *pMulti = static_cast<const CItemMulti*>(this);
+    CObjBase *pObj = CUID::ObjFindFromUID(dwUID, true);
+    if (pObj == nullptr)
+        return nullptr;
+    if (!pObj->IsTopLevel() && !(pObj->IsChar() && pObj->IsDisconnected()))
+        return nullptr;
+    if (!pMulti->GetRegion()->IsInside2d(pObj->GetTopPoint()))
+        return nullptr;
+    return pObj;
+}
+
+void CCMultiMovable::PruneOccupants()
+{
+    ADDTOCALLSTACK("CCMultiMovable::PruneOccupants");
+    for (auto it = _setOccupants.begin(); it != _setOccupants.end(); )
+    {
+        if (FindOccupant(*it) == nullptr)
+            it = _setOccupants.erase(it);
+        else
+            ++it;
+    }
+}
+
 uint CCMultiMovable::ListObjs(CObjBase ** ppObjList)
 {
     ADDTOCALLSTACK("CCMultiMovable::ListObjs");
@@ -133,7 +207,6 @@ uint CCMultiMovable::ListObjs(CObjBase ** ppObjList)
     if (!pItemThis->IsTopLevel())
         return 0;
 
-    int iMaxDist = pMulti->Multi_GetDistanceMax();
     int iShipHeight = pItemThis->GetTopZ() + maximum(3, pItemThis->GetHeight());
 
     // always list myself first. All other items must see my new region !
@@ -152,54 +225,62 @@ uint CCMultiMovable::ListObjs(CObjBase ** ppObjList)
         ppObjList[uiCount++] = pItemComp;
     }
 
-    // add chars to the list
-    CWorldSearch AreaChar(pItemThis->GetTopPoint(), iMaxDist);
-    AreaChar.SetAllShow(true);
-    AreaChar.SetSearchSquare(true);
-    while (uiCount < MAX_MULTI_LIST_OBJS)
+    // Ships search their area only the first time, then they are told about the objects boarding them.
+    //  The other multis aren't moved often enough to be worth it: they search it every time.
+    const bool fTracked = pItemThis->IsType(IT_SHIP);
+    if (!fTracked || !_fOccupantsListed)
     {
-        CChar *pChar = AreaChar.GetChar();
-        if (pChar == nullptr)
-            break;
-        if (!pMulti->GetRegion()->IsInside2d(pChar->GetTopPoint()))
-            continue;
-        if (pChar->IsDisconnected() && pChar->m_pNPC)
-            continue;
-
-        int zdiff = pChar->GetTopZ() - iShipHeight;
-        if ((zdiff < -2) || (zdiff > PLAYER_HEIGHT))
-            continue;
-
-        ppObjList[uiCount++] = pChar;
+        _setOccupants.clear();
+        SearchOccupants();
+        _fOccupantsListed = fTracked;
     }
 
-    // last, add the rest of the items
-    CWorldSearch AreaItem(pItemThis->GetTopPoint(), iMaxDist);
-    AreaItem.SetSearchSquare(true);
-    while (uiCount < MAX_MULTI_LIST_OBJS)
+    // add chars to the list, then the rest of the items
+    CObjBase * ppItems[MAX_MULTI_LIST_OBJS];
+    uint uiItems = 0;
+    for (auto it = _setOccupants.begin(); it != _setOccupants.end(); )
     {
-        CItem *pItem = AreaItem.GetItem();
-        if (pItem == nullptr)
-            break;
-        if (pItem == pItemThis)	// already listed.
-            continue;
-        if (pMulti->Multi_IsPartOf(pItem)) // already listed.
+        CObjBase *pObj = FindOccupant(*it);
+        if ((pObj == nullptr) || (pObj == pItemThis) || (pObj->IsItem() && pMulti->Multi_IsPartOf(static_cast<const CItem*>(pObj))))
+        {
+            it = _setOccupants.erase(it);   // it left the structure, or it's already listed
             continue;
+        }
+        ++it;
 
-        if (!pMulti->GetRegion()->IsInside2d(pItem->GetTopPoint()))
+        int zdiff = pObj->GetTopZ() - iShipHeight;
+        if ((zdiff < -2) || (zdiff > PLAYER_HEIGHT))
             continue;
 
-        //I guess we can allow items to be locked on the ships and still move... but disallow attr_static from moving
-        //if ( ! pItem->IsMovable() && !pItem->IsType(IT_CORPSE))
-        if (pItem->IsAttr(ATTR_STATIC))
-            continue;
+        if (pObj->IsChar())
+        {
+            if (uiCount >= MAX_MULTI_LIST_OBJS)
+                continue;
+            const CChar *pChar = static_cast<const CChar*>(pObj);
+            if (pChar->IsDisconnected() && pChar->m_pNPC)
+                continue;
 
-        int zdiff = pItem->GetTopZ() - iShipHeight;
-        if ((zdiff < -2) || (zdiff > PLAYER_HEIGHT))
-            continue;
+            ppObjList[uiCount++] = pObj;
+        }
+        else
+        {
+            if (uiItems >= MAX_MULTI_LIST_OBJS)
+                continue;
+            const CItem *pItem = static_cast<const CItem*>(pObj);
 
-        ppObjList[uiCount++] = pItem;
+            //I guess we can allow items to be locked on the ships and still move... but disallow attr_static from moving
+            //if ( ! pItem->IsMovable() && !pItem->IsType(IT_CORPSE))
+            if (pItem->IsAttr(ATTR_STATIC))
+                continue;
+
+            ppItems[uiItems++] = pObj;
+        }
     }
+    for (uint i = 0; (i < uiItems) && (uiCount < MAX_MULTI_LIST_OBJS); ++i)
+        ppObjList[uiCount++] = ppItems[i];
+
+    if (!fTracked)
+        _setOccupants.clear();
     return uiCount;
 }
 
@@ -281,7 +362,7 @@ bool CCMultiMovable::MoveDelta(const CPointMap& ptDelta, bool fUpdateViewFull)
     if ( (ptDelta.m_z < 0) && (zNew <= (UO_SIZE_MIN_Z + 3)) )
         return false;
 
-    const CPointMap& ptMultiOld = pItemThis->GetTopPoint();
+    const CPointMap ptMultiOld(pItemThis->GetTopPoint());
     CPointMap ptMultiNew(ptMultiOld);
     ptMultiNew += ptDelta;
     CRegionWorld *pRegionOld = dynamic_cast<CRegionWorld*>(ptMultiOld.GetRegion(REGION_TYPE_AREA));
@@ -296,6 +377,8 @@ bool CCMultiMovable::MoveDelta(const CPointMap& ptDelta, bool fUpdateViewFull)
     uint iCount = ListObjs(ppObjs);
     ASSERT(iCount > 0);
 
+    const bool fMovingObjsPrev = sm_fMovingObjs;
+    sm_fMovingObjs = true;  // they are already tracked by this ship
     for (uint i = 0; i < iCount; ++i)
     {
         CObjBase * pObj = ppObjs[i];
@@ -311,6 +394,10 @@ bool CCMultiMovable::MoveDelta(const CPointMap& ptDelta, bool fUpdateViewFull)
         }
         pObj->MoveTo(pt);
     }
+    sm_fMovingObjs = fMovingObjsPrev;
+
+    // Everything listed is inside the structure, so within this distance from it (before and after the move).
+    const int iMultiDist = pMultiThis->Multi_GetDistanceMax() + 1;
 
     ClientIterator it;
     for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
@@ -319,12 +406,16 @@ bool CCMultiMovable::MoveDelta(const CPointMap& ptDelta, bool fUpdateViewFull)
         if (pCharClient == nullptr)
             continue;
 
-        const CNetState* pNetState = pClient->GetNetState();
-        const bool fClientUsesSmoothSailing = !IsSetOF(OF_NoSmoothSailing) && (pNetState->isClientVersion(MINCLIVER_HS) || pNetState->isClientEnhanced());
-
         const CPointMap& ptMe = pCharClient->GetTopPoint();
         const int iViewDist = pCharClient->GetVisualRange();
 
+        // This client can't see the ship nor anything on it, before or after the move: nothing to update.
+        if ((ptMe.GetDistSight(ptMultiOld) > iViewDist + iMultiDist) && (ptMe.GetDistSight(ptMultiNew) > iViewDist + iMultiDist))
+            continue;
+
+        const CNetState* pNetState = pClient->GetNetState();
+        const bool fClientUsesSmoothSailing = !IsSetOF(OF_NoSmoothSailing) && (pNetState->isClientVersion(MINCLIVER_HS) || pNetState->isClientEnhanced());
+
         // No smooth sailing: update the view for each item inside the multi
         for (uint i = 0; i < iCount; ++i)
         {
@@ -589,9 +680,8 @@ bool CCMultiMovable::Face(DIR_TYPE dir)
             CItem * pItem = static_cast<CItem*>(pObj);
             if (pItem == pMultiThis)
             {
-                pMultiThis->GetRegion()->UnRealizeRegion();
                 pMultiThis->SetID(idnew);
-                pMultiThis->MultiRealizeRegion();
+                pMultiThis->MultiRealizeRegion();   // relinks the region with the rectangle of the new facing
             }
             else if (pMultiThis->Multi_IsPartOf(pItem))
             {
@@ -1,6 +1,7 @@
 #ifndef _INC_CCMULTIMOVABLE_H
 #define _INC_CCMULTIMOVABLE_H
 
+#include "../../../lib/parallel_hashmap/phmap.h"
 #include "../CRegion.h"
 
 
@@ -19,6 +20,12 @@ class CCMultiMovable
     CTextConsole *_pCaptain;
     bool _fCanTurn;
 
+    // Ships keep track of the chars and items boarding them, instead of searching the area at each step.
+    //  The UIDs are checked again when listing them (they may have left the deck, or have been deleted).
+    phmap::flat_hash_set<dword> _setOccupants;
+    bool _fOccupantsListed;     // the deck was searched once, since then the boarding objects were tracked
+    static bool sm_fMovingObjs; // a ship is moving its objects, they aren't boarding
+
 protected:
     ShipSpeed _shipSpeed;          // Speed of ships (IT_SHIP)
     ShipMovementSpeed _eSpeedMode;  // (0x01 = one tile, 0x02 = rowboat, 0x03 = slow, 0x04 = fast)
@@ -33,8 +40,16 @@ public:
     bool r_LoadVal(CScript & s);
     bool r_Verb(CScript & s, CTextConsole * pSrc); // Execute command from script
 
+    static void OnBoard(const CRegionWorld* pRegion, const CObjBase* pObj);  // a char or an item entered the region of a ship
+    static bool IsMovingObjs() noexcept {
+        return sm_fMovingObjs;
+    }
+
 protected:
     void SetNextMove();
+    void SearchOccupants();
+    CObjBase* FindOccupant(dword dwUID) const;
+    void PruneOccupants();
     uint ListObjs(CObjBase ** ppObjList);
     bool CanMoveTo(const CPointMap & pt) const;
     bool MoveDelta(const CPointMap& ptDelta, bool fUpdateViewFull);
@@ -1,12 +1,14 @@
 #include "../../common/resource/sections/CRandGroupDef.h"
 #include "../../common/CLog.h"
 #include "../../common/CException.h"
+#include "../../sphere/Metrics.h"
 #include "../chars/CChar.h"
 #include "../chars/CCharNPC.h"
 #include "../CObjBase.h"
 #include "../CContainer.h"
 #include "../CRegion.h"
 #include "../CServer.h"
+#include "../CWorldGameTime.h"
 #include "../CWorldMap.h"
 #include "CCChampion.h"
 #include "CCSpawn.h"
@@ -15,6 +17,8 @@
 
 /////////////////////////////////////////////////////////////////////////////
 std::vector<CCSpawn*> CCSpawn::_vBadSpawns; // static
+int64 CCSpawn::sm_iBudgetTime = 0; // static
+uint CCSpawn::sm_uiBudgetUsed = 0; // static
 
 void CCSpawn::AddBadSpawn()
 {
@@ -68,6 +72,8 @@ CCSpawn::CCSpawn(CItem *pLink, bool fIsChampion) : CComponent(COMP_SPAWN), _fIsC
     _iTimeHi = 30;
     _fKillingChildren = false;
     _fIsBadSpawn = false;
+    _iSpawnPointsDist = 0;
+    _dwSpawnPointsCan = 0;
 }
 
 CCSpawn::~CCSpawn()
@@ -364,6 +370,77 @@ void CCSpawn::GenerateItem()
 }
 
 
+bool CCSpawn::CheckSpawnPoints(const CChar* pChar)
+{
+    // Are the points remembered still good for this char? If the spawn was moved or its area changed, forget them.
+    const CItem *pSpawnItem = GetLink();
+    if ((_ptSpawnPointsOrigin != pSpawnItem->GetTopPoint()) || (_iSpawnPointsDist != _iMaxDist))
+    {
+        _vSpawnPoints.clear();
+        _ptSpawnPointsOrigin = pSpawnItem->GetTopPoint();
+        _iSpawnPointsDist = _iMaxDist;
+        return false;
+    }
+    return ((pChar->GetCanFlags() & CAN_C_MOVEMASK) == _dwSpawnPointsCan);
+}
+
+void CCSpawn::AddSpawnPoint(const CChar* pChar)
+{
+    ADDTOCALLSTACK("CCSpawn::AddSpawnPoint");
+    if (!CheckSpawnPoints(pChar))
+    {
+        // Different movement flags (ie. a spawn group of land and sea creatures): start again with this char.
+        _vSpawnPoints.clear();
+        _dwSpawnPointsCan = (pChar->GetCanFlags() & CAN_C_MOVEMASK);
+    }
+
+    const CPointMap& pt = pChar->GetTopPoint();
+    if (std::find(_vSpawnPoints.begin(), _vSpawnPoints.end(), pt) != _vSpawnPoints.end())
+        return;
+    if (_vSpawnPoints.size() < SPAWN_POINTS_MAX)
+        _vSpawnPoints.emplace_back(pt);
+    else
+        _vSpawnPoints[Calc_GetRandVal(SPAWN_POINTS_MAX)] = pt;   // keep them fresh
+}
+
+bool CCSpawn::MoveToSpawnPoint(CChar* pChar)
+{
+    ADDTOCALLSTACK("CCSpawn::MoveToSpawnPoint");
+    if (_vSpawnPoints.empty() || !CheckSpawnPoints(pChar))
+        return false;
+
+    const int iIndex = Calc_GetRandVal((int)_vSpawnPoints.size());
+    CPointMap pt(_vSpawnPoints[iIndex]);
+    pChar->m_zClimbHeight = 0;
+    if ((pChar->CanMoveWalkTo(pt, false, true) == nullptr) || !pChar->MoveTo(pt))
+    {
+        // Something is blocking it now (ie. an item or a house).
+        _vSpawnPoints.erase(_vSpawnPoints.begin() + iIndex);
+        return false;
+    }
+    g_Metrics.Add(METRIC_SPAWN_POINTS_REUSED);
+    return true;
+}
+
+bool CCSpawn::UseSpawnBudget() // static
+{
+    // Is there still room for a spawn in this world tick?
+    if (g_Cfg._uiSpawnsPerTick == 0)
+        return true;
+
+    const int64 iTimeCur = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+    if (iTimeCur != sm_iBudgetTime)
+    {
+        sm_iBudgetTime = iTimeCur;
+        sm_uiBudgetUsed = 0;
+    }
+    if (sm_uiBudgetUsed >= g_Cfg._uiSpawnsPerTick)
+        return false;
+    ++sm_uiBudgetUsed;
+    return true;
+}
+
+
 CChar* CCSpawn::GenerateChar(CResourceIDBase rid)
 {
     ADDTOCALLSTACK("CCSpawn::GenerateChar(rid)");
@@ -417,10 +494,17 @@ CChar* CCSpawn::GenerateChar(CResourceIDBase rid)
     // Try placing this char near the spawn
     if (pChar->GetTopPoint().IsValidPoint() == false)// Try to place it only if the @Spawn trigger didn't set it a valid P.
     {
+        bool fNewPoint = true;
         ushort iPlacingTries = 0;
         while (!pChar->MoveNear(pt, _iMaxDist ? (word)(Calc_GetRandVal(_iMaxDist) + 1) : 1) || pChar->IsStuck(false) || !pChar->CanSeeLOS(pt)) //Character shouldn't spawn where can't see it's spawn point.
         {
             ++iPlacingTries;
+            if ((iPlacingTries == 1) && MoveToSpawnPoint(pChar))
+            {
+                // Instead of trying other random points, use one where a previous char was placed.
+                fNewPoint = false;
+                break;
+            }
             if (iPlacingTries <= 3)
             {
                 continue;
@@ -433,8 +517,11 @@ CChar* CCSpawn::GenerateChar(CResourceIDBase rid)
                 pChar->Delete();
                 return nullptr;
             }
+            fNewPoint = false;
             break;
         }
+        if (fNewPoint)
+            AddSpawnPoint(pChar);
     }
 
     // Check if the NPC can spawn in this region
@@ -659,6 +746,12 @@ void CCSpawn::AddObj(const CUID& uid)
 CCRET_TYPE CCSpawn::OnTickComponent()
 {
     ADDTOCALLSTACK("CCSpawn::OnTickComponent");
+    return SpawnTick(true);
+}
+
+CCRET_TYPE CCSpawn::SpawnTick(bool fUseBudget)
+{
+    ADDTOCALLSTACK("CCSpawn::SpawnTick");
     int64 iMinutes;
     CItem *pSpawnItem = GetLink();
     if (_iTimeHi <= 0)
@@ -681,6 +774,15 @@ CCRET_TYPE CCSpawn::OnTickComponent()
         return CCRET_TRUE;
     }
 
+    if (fUseBudget && !UseSpawnBudget())
+    {
+        // Too many spawns in this tick (ie. after a restart): try again in a moment, instead of waiting for the whole spawn time.
+        pSpawnItem->_SetTimeout(Calc_GetRandLLVal2(MSECS_PER_TICK, SPAWN_DEFER_MSECS));
+        g_Metrics.Add(METRIC_SPAWNS_DEFERRED);
+        return CCRET_TRUE;
+    }
+    g_Metrics.Add(METRIC_SPAWNS);
+
     if (pSpawnItem->IsType(IT_SPAWN_CHAR) || pSpawnItem->IsType(IT_SPAWN_CHAMPION))
     {
         GenerateChar();
@@ -1217,7 +1319,7 @@ bool CCSpawn::r_Verb(CScript & s, CTextConsole * pSrc)
         }
         case ISPV_RESET:
             KillChildren();
-            OnTickComponent();
+            SpawnTick();
             return true;
         case ISPV_START:
             pItem->SetTimeout(0);
@@ -16,9 +16,13 @@
 
 
 class CCharBase;
+class CChar;
 class CItem;
 class CUID;
 
+#define SPAWN_POINTS_MAX        16      // points where chars were placed, remembered by each spawn
+#define SPAWN_DEFER_MSECS       2000    // max delay of a spawn postponed because too many spawned in the same tick
+
 class CCSpawn : public CComponent
 {
     THREAD_CMUTEX_DEF;
@@ -42,9 +46,24 @@ class CCSpawn : public CComponent
     static std::vector<CCSpawn*> _vBadSpawns;
     bool _fIsBadSpawn;
 
+    // Points where the previous chars were placed (valid for chars with the same movement flags),
+    //  used instead of trying more random points when the first one isn't good.
+    std::vector<CPointMap> _vSpawnPoints;
+    CPointMap _ptSpawnPointsOrigin;     // position of the spawn item when the points were found
+    uint8 _iSpawnPointsDist;            // and its max distance
+    dword _dwSpawnPointsCan;            // CAN_C_MOVEMASK flags of the chars placed on them
+
+    static int64 sm_iBudgetTime;        // world tick of the spawns counted in sm_uiBudgetUsed
+    static uint sm_uiBudgetUsed;
+
     void AddBadSpawn();
     void DelBadSpawn();
 
+    bool CheckSpawnPoints(const CChar* pChar);
+    void AddSpawnPoint(const CChar* pChar);
+    bool MoveToSpawnPoint(CChar* pChar);
+    static bool UseSpawnBudget();
+
 public:
     static const char *m_sClassName;
     static CCSpawn * GetBadSpawn(int index = -1);
@@ -124,6 +143,13 @@ public:
     */
     virtual CCRET_TYPE OnTickComponent() override;
     /**
+    * @brief Spawns now, as in the timer tick.
+    *
+    * @param fUseBudget Whether to check the spawns per tick limit: only the ticks driven by the world timer use it,
+    *   the direct calls (GM double-click, RESET, sector restock) always spawn.
+    */
+    CCRET_TYPE SpawnTick(bool fUseBudget = false);
+    /**
     * @brief Removes everything created by this spawn, if still belongs to the spawn.
     */
     void KillChildren();
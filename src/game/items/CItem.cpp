@@ -142,6 +142,9 @@ CItem::CItem( ITEMID_TYPE id, CItemBase * pItemDef ) :
 	m_wAmount = 1;
 	m_containedGridIndex = 0;
 	m_dwDispIndex = ITEMID_NOTHING;
+	_dwIndexedBaseKey = _dwIndexedTypeKey = 0;
+	_wIndexedAmount = 0;
+	_fIndexedSearchable = true;
 
 
 	m_itNormal.m_more1 = 0;
@@ -1455,12 +1458,13 @@ void CItem::SetDecayTime(int64 iMsecsTimeout, bool fOverrideAlways)
 		else
             iMsecsTimeout = -1;
 	}
-	_SetTimeout(iMsecsTimeout);
 
+	// Set the attribute first: the ticker needs it to put the timer in the decay buckets.
 	if (iMsecsTimeout >= 0)
 		SetAttr(ATTR_DECAY);
 	else
 		ClrAttr(ATTR_DECAY);
+	_SetTimeout(iMsecsTimeout);
 }
 
 SOUND_TYPE CItem::GetDropSound( const CObjBase * pObjOn ) const
@@ -1534,6 +1538,13 @@ bool CItem::MoveTo(const CPointMap& pt, bool fForceFix) // Put item on the groun
 	if ( fForceFix )
 		SetTopZ(GetFixZ(pt));
 
+	// Dropped on a ship ? (the saved items are found by the ship itself, when it moves the first time)
+	if ( ! g_Serv.IsLoading() && ! CCMultiMovable::IsMovingObjs() )
+	{
+		const CRegionWorld * pShipArea = dynamic_cast<const CRegionWorld *>(pt.GetRegion(REGION_TYPE_SHIP));
+		if ( pShipArea )
+			CCMultiMovable::OnBoard(pShipArea, this);
+	}
 	return true;
 }
 
@@ -2053,6 +2064,7 @@ bool CItem::SetBase( CItemBase * pItemDef )
 	}
 
 	m_type = pItemDef->GetType();
+	UpdateContentIndex();
 	return true;
 }
 
@@ -2167,9 +2179,70 @@ void CItem::SetAmount(word amount )
 		pParentCont->OnWeightChange(GetWeight(amount) - GetWeight(oldamount));
 	}
 
+	UpdateContentIndex();
 	UpdatePropertyFlag();
 }
 
+void CItem::_ContentIndexRecord()
+{
+	const CItemBase *pItemDef = Item_GetDef();
+	const CResourceID ridBase(pItemDef ? pItemDef->GetResourceID() : CResourceID(RES_ITEMDEF, 0));
+	_dwIndexedBaseKey = CContainer::GetContentIndexKey(ridBase.GetResType(), ridBase.GetResIndex());
+	_dwIndexedTypeKey = CContainer::GetContentIndexKey(RES_TYPEDEF, m_type);
+	_wIndexedAmount = m_wAmount;
+	const CItemContainer *pCont = dynamic_cast<const CItemContainer *>(this);
+	_fIndexedSearchable = (pCont == nullptr) || pCont->IsSearchable();
+}
+
+void CItem::UpdateContentIndex()
+{
+	ADDTOCALLSTACK("CItem::UpdateContentIndex");
+	// Move my old amounts in the indexes of the containers holding me to the new id/type.
+	CContainer *pParentCont = dynamic_cast<CContainer *>(GetParent());
+	if ( !pParentCont )
+	{
+		_ContentIndexRecord();	// we'll be counted when added to a container
+		return;
+	}
+
+	const dword dwBaseKeyOld = _dwIndexedBaseKey;
+	const dword dwTypeKeyOld = _dwIndexedTypeKey;
+	const llong iAmountOld = _wIndexedAmount;
+	const bool fSearchableOld = _fIndexedSearchable;
+	_ContentIndexRecord();
+	const llong iAmountNew = _wIndexedAmount;
+
+	if ( dwBaseKeyOld == _dwIndexedBaseKey )
+	{
+		if ( iAmountOld != iAmountNew )
+			pParentCont->ContentIndexPropagate(_dwIndexedBaseKey, iAmountNew - iAmountOld, 0, true, true);
+	}
+	else
+	{
+		pParentCont->ContentIndexPropagate(dwBaseKeyOld, -iAmountOld, -1, true, true);
+		pParentCont->ContentIndexPropagate(_dwIndexedBaseKey, iAmountNew, 1, true, true);
+	}
+
+	if ( dwTypeKeyOld == _dwIndexedTypeKey )
+	{
+		if ( iAmountOld != iAmountNew )
+			pParentCont->ContentIndexPropagate(_dwIndexedTypeKey, iAmountNew - iAmountOld, 0, true, true);
+	}
+	else
+	{
+		pParentCont->ContentIndexPropagate(dwTypeKeyOld, -iAmountOld, -1, true, true);
+		pParentCont->ContentIndexPropagate(_dwIndexedTypeKey, iAmountNew, 1, true, true);
+	}
+
+	if ( fSearchableOld != _fIndexedSearchable )
+	{
+		// A container became locked/unlocked (or a bank box...): what's inside it isn't/is now searchable from the outside.
+		const CContainer *pThisCont = dynamic_cast<const CContainer *>(this);
+		if ( pThisCont )
+			pParentCont->ContentIndexAddContents(pThisCont, _fIndexedSearchable ? 1 : -1, false, true);
+	}
+}
+
 word CItem::GetMaxAmount()
 {
 	ADDTOCALLSTACK("CItem::GetMaxAmount");
@@ -3765,6 +3838,7 @@ bool CItem::SetType(IT_TYPE type, bool fPreCheck)
 
     // Assign type
 	m_type = type;
+	UpdateContentIndex();
 
     // Post-assignment checks
     // CComponents sanity check.
@@ -3966,6 +4040,7 @@ void CItem::DupeCopy( const CObjBase* pItemObj )
 	_SetTimeout( pItem->_GetTimerAdjusted() );
 	SetType(pItem->m_type);
 	m_wAmount = pItem->m_wAmount;
+	UpdateContentIndex();
 	m_Attr  = pItem->m_Attr;
 	m_CanMask = pItem->m_CanMask;
 	m_CanUse = pItem->m_CanUse;
@@ -3990,6 +4065,7 @@ void CItem::SetAnim( ITEMID_TYPE id, int64 iTicksTimeout)
 	m_itAnim.m_PrevType = m_type;
 	SetDispID( id );
 	m_type = IT_ANIM_ACTIVE;    // Do not change the components? SetType(IT_ANIM_ACTIVE);
+	UpdateContentIndex();
 	_SetTimeout(iTicksTimeout);
 	//RemoveFromView();
 	Update();
@@ -4057,7 +4133,7 @@ void CItem::Update(const CClient * pClientExclude)
 	ADDTOCALLSTACK("CItem::Update");
 	// Send this new item to all that can see it.
 
-	ClientIterator it;
+	ClientNearbyIterator it(this);
 	for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
 	{
 		if ( pClient == pClientExclude )
@@ -4227,6 +4303,7 @@ void CItem::SetCorpseType( CREID_TYPE id )
 	// future: strongly typed enums will remove the need for this cast
     ASSERT(id <= UINT16_MAX);
 	m_wAmount = (word)id;	// m_corpse_DispID
+	UpdateContentIndex();
 }
 
 SPELL_TYPE CItem::GetScrollSpell() const
@@ -4360,7 +4437,7 @@ uint CItem::AddSpellbookSpell( SPELL_TYPE spell, bool fUpdate )
 	{
 		PacketItemContainer cmd(this, pSpellDef);
 
-		ClientIterator it;
+		ClientNearbyIterator it(this);
 		for ( CClient *pClient = it.next(); pClient != nullptr; pClient = it.next() )
 		{
 			if ( !pClient->CanSee(this) )
@@ -6166,6 +6243,7 @@ bool CItem::_OnTick()
 				RemoveFromView();
 				SetDispID( m_itAnim.m_PrevID );
 				m_type = m_itAnim.m_PrevType;   // don't change the components SetType(m_itAnim.m_PrevType);
+				UpdateContentIndex();
 				_SetTimeout( -1 );
 				Update();
 			}
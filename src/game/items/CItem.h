@@ -44,6 +44,7 @@ class CItem : public CObjBase
 
 	friend class CWorldTicker;
 	friend class CCSpawn;
+	friend class CContainer;
 
 public:
 	static const char *m_sClassName;
@@ -61,6 +62,12 @@ private:
 	dword	m_CanUse;		// Base attribute flags. can_u_all/male/female..
 	word	m_weight;
 
+	// How this item was counted in the content index of the containers holding it (see CContainer::ContentIndexAddItem).
+	dword	_dwIndexedBaseKey;
+	dword	_dwIndexedTypeKey;
+	word	_wIndexedAmount;
+	bool	_fIndexedSearchable;
+
 public:
 	CUID GetComponentOfMulti() const;
 	CUID GetLockDownOfMulti() const;
@@ -681,6 +688,10 @@ public:
 	word ConsumeAmount( word iQty = 1 );
 
 	void SetAmount( word amount );
+	void UpdateContentIndex();	// id, type or amount changed: update the content index of the containers holding me
+private:
+	void _ContentIndexRecord();
+public:
 	word GetMaxAmount();
 	bool SetMaxAmount( word amount );
 	void SetAmountUpdate( word amount );
@@ -55,10 +55,7 @@ void CItemCommCrystal::OnHear(lpctstr pszCmd, CChar *pSrc)
     {
         CResourceLink *pLink = m_Speech[i].GetRef();
         ASSERT(pLink);
-        CResourceLock s;
-        if ( !pLink->ResourceLock(s) )
-            continue;
-        TRIGRET_TYPE iRet = OnHearTrigger(s, pszCmd, pSrc, mode);
+        TRIGRET_TYPE iRet = OnHearTrigger(pLink, pszCmd, pSrc, mode);
         if ( iRet == TRIGRET_ENDIF || iRet == TRIGRET_RET_FALSE )
             continue;
         break;
@@ -186,17 +186,34 @@ bool CItemMulti::MultiRealizeRegion()
 {
     ADDTOCALLSTACK("CItemMulti::MultiRealizeRegion");
     // Add/move a region for the multi so we know when we are in it.
+    // If the region is already linked to the world, only the sectors it leaves or enters are changed.
     // RETURN: ignored.
 
-    if (!IsTopLevel() || IsType(IT_MULTI_ADDON))
+    if (IsType(IT_MULTI_ADDON))
     {
         return false;
     }
 
+    // OnMoveFrom doesn't unlink the region of a multi moved by a ship: if it can't be realized here, it must not stay in the old sectors.
+    const auto unRealizeLinked = [this]() -> void
+    {
+        if (m_pRegion && m_pRegion->m_iLinkedSectors)
+        {
+            m_pRegion->UnRealizeRegion();
+        }
+    };
+
+    if (!IsTopLevel())
+    {
+        unRealizeLinked();
+        return false;
+    }
+
     const CItemBaseMulti * pMultiDef = Multi_GetDef();
     if (pMultiDef == nullptr)
     {
         g_Log.EventError("Bad Multi type 0%x, uid=0%x.\n", GetID(), (dword)GetUID());
+        unRealizeLinked();
         return false;
     }
 
@@ -212,6 +229,7 @@ bool CItemMulti::MultiRealizeRegion()
     if (!pRegionBack)
     {
         g_Log.EventError("Can't realize multi region at invalid P=%hd,%hd,%hhd,%hhu. Multi uid=0%x.\n", pt.m_x, pt.m_y, pt.m_z, pt.m_map, (dword)GetUID());
+        unRealizeLinked();
         return false;
     }
     ASSERT(pRegionBack != m_pRegion);
@@ -220,7 +238,6 @@ bool CItemMulti::MultiRealizeRegion()
     CRectMap rect = pMultiDef->m_rect;
     rect.m_map = pt.m_map;
     rect.OffsetRect(pt.m_x, pt.m_y);
-    m_pRegion->SetRegionRect(rect);
     m_pRegion->m_pt = pt;
 
     dword dwFlags = pMultiDef->m_dwRegionFlags;
@@ -257,7 +274,7 @@ bool CItemMulti::MultiRealizeRegion()
         pChar->MoveToRegion(m_pRegion, false); //Move the character to house region.
     }
 
-    return m_pRegion->RealizeRegion();
+    return m_pRegion->RelinkRegion(rect);
 }
 
 void CItemMulti::MultiUnRealizeRegion()
@@ -505,6 +522,10 @@ void CItemMulti::OnMoveFrom()
     else
     {
         ASSERT(m_pRegion);
+        if (CCMultiMovable::IsMovingObjs())
+        {
+            return; // moved by a ship to another sector: MoveTo will relink the region to the sectors it changed
+        }
         m_pRegion->UnRealizeRegion();
     }
 }
@@ -539,11 +560,7 @@ bool CItemMulti::MoveTo(const CPointMap& pt, bool fForceFix) // Put item on the
     }
     else
     {
-        if (m_pRegion)
-        {
-            m_pRegion->UnRealizeRegion();
-        }
-        MultiRealizeRegion();
+        MultiRealizeRegion();   // moves the region, if it's still linked to the world
     }
     return true;
 }
@@ -579,10 +596,7 @@ void CItemMulti::OnHearRegion(lpctstr pszCmd, CChar * pSrc)
     {
         CResourceLink * pLink = pMultiDef->m_Speech[i].GetRef();
         ASSERT(pLink);
-        CResourceLock s;
-        if (!pLink->ResourceLock(s))
-            continue;
-        TRIGRET_TYPE iRet = OnHearTrigger(s, pszCmd, pSrc, mode);
+        TRIGRET_TYPE iRet = OnHearTrigger(pLink, pszCmd, pSrc, mode);
         if (iRet == TRIGRET_ENDIF || iRet == TRIGRET_RET_FALSE)
             continue;
         break;
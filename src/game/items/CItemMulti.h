@@ -12,6 +12,7 @@
 
 
 #define MAX_MULTI_LIST_OBJS 128
+#define MAX_MULTI_TRACKED_OBJS (MAX_MULTI_LIST_OBJS * 4)   // prune the objects tracked by a ship when they are more than this
 #define MAX_MULTI_CONTENT 1024
 
 
@@ -13,6 +13,7 @@
 #include "../CWorldMap.h"
 #include "../triggers.h"
 #include "CItemMultiCustom.h"
+#include <algorithm>
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -337,7 +338,8 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
     if (g_Serv.IsLoading() || !ptMe.IsValidPoint())
         return;
 
-    // remove all existing dynamic item fixtures
+    // Existing dynamic item fixtures: the ones still in the design, at the same place, are kept (the others are deleted later).
+    std::vector<CItem*> vFixtures;
     CWorldSearch Area(ptMe, GetDesignArea().GetWidth());
     Area.SetSearchSquare(true);
     CItem * pItem;
@@ -350,7 +352,7 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
         if ((dword)pItem->m_TagDefs.GetKeyNum("FIXTURE") != (dword)GetUID())
             continue;
 
-        pItem->Delete();
+        vFixtures.push_back(pItem);
     }
 
     CRectMap rectNew;
@@ -364,18 +366,32 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
             continue;
 
         // replace the doors and teleporters with real items
-        pItem = CItem::CreateScript(pComp->m_item.GetDispID());
-        if (pItem == nullptr)
-            continue;
-
         CPointMap pt(ptMe);
         pt.m_x += pComp->m_item.m_dx;
         pt.m_y += pComp->m_item.m_dy;
         pt.m_z += (char)(pComp->m_item.m_dz);
 
-        pItem->ClrAttr(ATTR_DECAY);
-        pItem->SetAttr(ATTR_MOVE_NEVER);
-        pItem->m_TagDefs.SetNum("FIXTURE", GetUID().GetObjUID());
+        const ITEMID_TYPE idFixture = pComp->m_item.GetDispID();
+        const auto itFixture = std::find_if(vFixtures.begin(), vFixtures.end(),
+            [idFixture, &pt](const CItem* pFixture) noexcept { return (pFixture->GetID() == idFixture) && (pFixture->GetTopPoint() == pt); });
+        const bool fNew = (itFixture == vFixtures.end());
+        if (fNew)
+        {
+            pItem = CItem::CreateScript(idFixture);
+            if (pItem == nullptr)
+                continue;
+
+            pItem->ClrAttr(ATTR_DECAY);
+            pItem->SetAttr(ATTR_MOVE_NEVER);
+            pItem->m_TagDefs.SetNum("FIXTURE", GetUID().GetObjUID());
+        }
+        else
+        {
+            // unchanged: don't create it again (and don't resend it)
+            pItem = *itFixture;
+            *itFixture = vFixtures.back();
+            vFixtures.pop_back();
+        }
 
         if (pItem->IsType(IT_TELEPAD))
         {
@@ -398,11 +414,17 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
         {
             pItem->m_uidLink = GetUID();
         }
+        if (!fNew)
+            continue;
         pItem->MoveToUpdate(pt);
         OnComponentCreate(pItem, false);    // TODO: how do i know that this is an AddOn?
         AddComponent(pItem->GetUID());
     }
 
+    // remove the dynamic item fixtures not in the design anymore
+    for (CItem* pFixture : vFixtures)
+        pFixture->Delete();
+
     rectNew.OffsetRect(ptMe.m_x, ptMe.m_y);
     if (m_pRegion != nullptr && !m_pRegion->IsInside(rectNew))
     {
@@ -413,9 +435,7 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
         CRect rect = m_pRegion->GetRegionRect(0);
         rectNew.UnionRect(rect);
 
-        m_pRegion->SetRegionRect(rectNew);
-        m_pRegion->UnRealizeRegion();
-        m_pRegion->RealizeRegion();
+        m_pRegion->RelinkRegion(rectNew);
     }
 
     ++ m_designMain.m_iRevision;
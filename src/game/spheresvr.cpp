@@ -19,12 +19,17 @@
 #include "../common/sphereversion.h"	// sphere version
 #include "../network/CNetworkManager.h"
 #include "../network/PingServer.h"
+#include "../sphere/asyncauth.h"
 #include "../sphere/asyncdb.h"
+#include "../sphere/asynclog.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ntwindow.h"
 #include "clients/CAccount.h"
+#include "CBenchmark.h"
 #include "CScriptProfiler.h"
 #include "CSector.h"
 #include "CServer.h"
+#include "CTickScheduler.h"
 #include "CWorld.h"
 #include "spheresvr.h"
 #include <sstream>
@@ -170,6 +175,8 @@ MainThread::MainThread()
     m_profile.EnableProfile(PROFILE_MULTIS);
     m_profile.EnableProfile(PROFILE_NPC_AI);
     m_profile.EnableProfile(PROFILE_SCRIPTS);
+    m_profile.EnableProfile(PROFILE_SECTORS);
+    m_profile.EnableProfile(PROFILE_SECTORS_COLD);
     m_profile.EnableProfile(PROFILE_SHIPS);
     m_profile.EnableProfile(PROFILE_TIMEDFUNCTIONS);
     m_profile.EnableProfile(PROFILE_TIMERS);
@@ -241,6 +248,10 @@ int Sphere_InitServer( int argc, char *argv[] )
 {
 	constexpr const char *m_sClassName = "SphereInit";
 	EXC_TRY("Init Server");
+	EXC_SET_BLOCK("log writer");
+	if ( g_Log.StartQueue(g_Cfg._iLogQueueLength) )
+		g_asyncLog.start();
+
 	EXC_SET_BLOCK("loading ini and scripts");
 	if ( !g_Serv.Load() )
 		return -3;
@@ -253,10 +264,16 @@ int Sphere_InitServer( int argc, char *argv[] )
 			return -1;
 	}
 
+	if ( g_Benchmark.IsActive() )
+	{
+		EXC_SET_BLOCK("benchmark setup");
+		g_Benchmark.Setup();
+	}
+
 	WritePidFile(2);
 
 	EXC_SET_BLOCK("sockets init");
-	if ( !g_Serv.SocketsInit() )
+	if ( !g_Benchmark.IsActive() && !g_Serv.SocketsInit() )	// no connections are accepted in benchmark mode
 		return -9;
 	EXC_SET_BLOCK("load world");
 	if ( !g_World.LoadAll() )
@@ -337,6 +354,7 @@ void Sphere_ExitServer()
 	g_Main.waitForClose();
 	g_PingServer.waitForClose();
 	g_asyncHdb.waitForClose();
+	g_asyncAuth.waitForClose();
 #ifdef _LIBEV
 	if ( g_Cfg.m_fUseAsyncNetwork != 0 )
 		g_NetworkEvent.waitForClose();
@@ -363,6 +381,7 @@ void Sphere_ExitServer()
 		case 4:		ptcReason = "Service shutdown";					    break;
 		case 5:		ptcReason = "Console window closed";				break;
 		case 6:		ptcReason = "Proccess aborted by SIGABRT signal";	break;
+		case BENCHMARK_EXIT_FLAG:	ptcReason = "Benchmark finished";	break;
 		default:	ptcReason = "Server shutdown complete";			    break;
 	}
 
@@ -371,6 +390,7 @@ void Sphere_ExitServer()
     if (!g_Serv._fCloseNTWindowOnTerminate)
         g_Log.Event(LOGM_INIT | LOGF_CONSOLE_ONLY, "You can now close this window.\n");
 #endif
+    g_asyncLog.waitForClose();
     g_Log.Close();
 #ifdef _WIN32
     if (iExitFlag != 5)
@@ -389,23 +409,48 @@ int Sphere_OnTick()
     g_NTService._OnTick();
 #endif
 
-	EXC_SET_BLOCK("world");
-	g_World._OnTick();
-
 	// process incoming data
 	EXC_SET_BLOCK("network-in");
-	g_NetworkManager.processAllInput();
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_NETWORK_IN);
+		g_NetworkManager.processAllInput();
+	}
+
+	// the world runs at its own rate (WorldTickPeriod), the network is processed on every cycle
+	EXC_SET_BLOCK("world");
+	if (g_TickScheduler.BeginStep())
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_WORLD);
+		g_World._OnTick();
+		g_TickScheduler.EndStep();
+	}
+
+	// resume the logins waiting for the password verification
+	EXC_SET_BLOCK("auth");
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_AUTH);
+		g_asyncAuth.processResults();
+	}
 
 	EXC_SET_BLOCK("server");
-	g_Serv._OnTick();
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_SERVER);
+		g_Serv._OnTick();
+	}
 
 	// push outgoing data
 	EXC_SET_BLOCK("network-out");
-	g_NetworkManager.processAllOutput();
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_NETWORK_OUT);
+		g_NetworkManager.processAllOutput();
+	}
 
 	// don't put the network-tick between in.tick and out.tick, otherwise it will clean the out queue!
 	EXC_SET_BLOCK("network-tick");
-	g_NetworkManager.tick();	// then this thread has to call the network tick
+	{
+		const MetricTimer phaseTimer(METRIC_TICK_NETWORK_TICK);
+		g_NetworkManager.tick();	// then this thread has to call the network tick
+	}
 
 	EXC_CATCH;
 	return g_Serv.GetExitFlag();
@@ -784,7 +829,13 @@ int _cdecl main( int argc, char * argv[] )
 
     g_Serv.SetServerMode(SERVMODE_Loading);
 	g_Serv.SetExitFlag( Sphere_InitServer( argc, argv ));
-	if ( ! g_Serv.GetExitFlag() )
+	if ( ! g_Serv.GetExitFlag() && g_Benchmark.IsActive() )
+	{
+		// Run the world ticks in this thread, then quit.
+		g_NetworkManager.start();
+		g_Serv.SetExitFlag( g_Benchmark.Run() );
+	}
+	else if ( ! g_Serv.GetExitFlag() )
 	{
 		WritePidFile();
 
@@ -831,6 +882,8 @@ exit_server:
     }
 #endif
 
+	if ( g_Serv.GetExitFlag() == BENCHMARK_EXIT_FLAG )
+		return 0;	// a successful run
 	return g_Serv.GetExitFlag();
 	EXC_CATCH;
 
@@ -1,3 +1,6 @@
+#include "../game/chars/CChar.h"
+#include "../game/items/CItemMulti.h"
+#include "../game/CSectorList.h"
 #include "CNetState.h"
 #include "CNetworkManager.h"
 #include "CClientIterator.h"
@@ -34,3 +37,132 @@ CClient* ClientIterator::next(bool includeClosing)
 
     return nullptr;
 }
+
+
+ClientNearbyIterator::ClientNearbyIterator(const CObjBaseTemplate* pObj) :
+    m_areas(0), m_areaCur(0), m_col(0), m_row(0), m_fCollected(false), m_charIndex(0)
+{
+    ASSERT(pObj);
+    const CObjBaseTemplate* pObjTop = pObj->GetTopLevelObj();
+    int iDist = UO_MAP_VIEW_SIZE_MAX;
+    if (pObj->IsItem())
+    {
+        // Multis are seen from farther than the visual range, see CChar::CanSee.
+        const CItem* pItem = static_cast<const CItem*>(pObj);
+        if (pItem->IsTypeMulti())
+            iDist += static_cast<const CItemMulti*>(pItem)->Multi_GetDistanceMax();
+    }
+    addArea(pObjTop->GetTopPoint(), iDist);
+}
+
+ClientNearbyIterator::ClientNearbyIterator(const CPointMap& pt, int iDist) :
+    m_areas(0), m_areaCur(0), m_col(0), m_row(0), m_fCollected(false), m_charIndex(0)
+{
+    addArea(pt, iDist);
+}
+
+ClientNearbyIterator::ClientNearbyIterator(const CPointMap& pt, const CPointMap& ptOld, int iDist) :
+    m_areas(0), m_areaCur(0), m_col(0), m_row(0), m_fCollected(false), m_charIndex(0)
+{
+    addArea(pt, iDist);
+    addArea(ptOld, iDist);
+}
+
+void ClientNearbyIterator::addArea(const CPointMap& pt, int iDist)
+{
+    if (!pt.IsValidPoint())
+        return;
+
+    const CSectorList* pSectors = CSectorList::Get();
+    const int iSectorSize = pSectors->GetSectorSize(pt.m_map);
+    if (iSectorSize <= 0)
+        return;
+
+    SectorArea& area = m_area[m_areas];
+    area.iMap = pt.m_map;
+    area.iColMin = maximum(0, (pt.m_x - iDist) / iSectorSize);
+    area.iRowMin = maximum(0, (pt.m_y - iDist) / iSectorSize);
+    area.iColMax = minimum(pSectors->GetSectorCols(pt.m_map) - 1, (pt.m_x + iDist) / iSectorSize);
+    area.iRowMax = minimum(pSectors->GetSectorRows(pt.m_map) - 1, (pt.m_y + iDist) / iSectorSize);
+
+    if (m_areas == 0)
+    {
+        m_col = area.iColMin - 1;   // nextSector starts moving to the next column
+        m_row = area.iRowMin;
+    }
+    ++m_areas;
+}
+
+const CSector* ClientNearbyIterator::nextSector()
+{
+    const CSectorList* pSectors = CSectorList::Get();
+    while (m_areaCur < m_areas)
+    {
+        const SectorArea& area = m_area[m_areaCur];
+        if (++m_col > area.iColMax)
+        {
+            m_col = area.iColMin;
+            if (++m_row > area.iRowMax)
+            {
+                if (++m_areaCur < m_areas)
+                {
+                    m_col = m_area[m_areaCur].iColMin - 1;
+                    m_row = m_area[m_areaCur].iRowMin;
+                }
+                continue;
+            }
+        }
+
+        if (m_areaCur > 0)
+        {
+            // Skip the sectors already visited in the first area.
+            const SectorArea& areaFirst = m_area[0];
+            if ((area.iMap == areaFirst.iMap) && (m_col >= areaFirst.iColMin) && (m_col <= areaFirst.iColMax) && (m_row >= areaFirst.iRowMin) && (m_row <= areaFirst.iRowMax))
+                continue;
+        }
+
+        const CSector* pSector = pSectors->GetSector(area.iMap, (m_row * pSectors->GetSectorCols(area.iMap)) + m_col);
+        if (pSector && !pSector->m_Chars_Active.GetClientChars().empty())
+            return pSector;
+    }
+
+    return nullptr;
+}
+
+void ClientNearbyIterator::collectChars()
+{
+    // Copy the client chars of the sectors before returning any client: sending something to a client may trigger scripts
+    //  moving chars around, and a sector removes a char from its list swapping it with the last one.
+    //  This way no char is skipped or returned twice.
+    m_fCollected = true;
+    for (const CSector* pSector = nextSector(); pSector != nullptr; pSector = nextSector())
+    {
+        const std::vector<CChar*>& vChars = pSector->m_Chars_Active.GetClientChars();
+        m_chars.insert(m_chars.end(), vChars.begin(), vChars.end());
+    }
+}
+
+CClient* ClientNearbyIterator::next(bool includeClosing)
+{
+    if (!m_fCollected)
+        collectChars();
+
+    while (m_charIndex < m_chars.size())
+    {
+        CClient* current = m_chars[m_charIndex++]->GetClientActive();
+        if (current == nullptr)
+            continue;
+
+        // skip clients without a state, or whose state is invalid/closed
+        const CNetState* ns = current->GetNetState();
+        if (ns == nullptr || ns->isInUse(current) == false || ns->isClosed())
+            continue;
+
+        // skip clients whose connection is being closed
+        if (includeClosing == false && ns->isClosing())
+            continue;
+
+        return current;
+    }
+    return nullptr;
+}
@@ -7,6 +7,7 @@
 #define _INC_CCLIENTITERATOR_H
 
 #include "../game/clients/CClient.h"
+#include <vector>
 
 class CNetworkManager;
 
@@ -28,5 +29,43 @@ public:
     CClient* next(bool includeClosing = false); // finds next client
 };
 
+class ClientNearbyIterator
+{
+    // Iterates only the clients whose char is in the sectors around the given point(s), instead of every connected client.
+    // It doesn't check the distance between the point and each client: it returns a superset of the clients within iDist from it.
+    struct SectorArea
+    {
+        int iMap;
+        int iColMin, iColMax;
+        int iRowMin, iRowMax;
+    };
+
+protected:
+    int m_areas;
+    SectorArea m_area[2];   // a second area is used when an object moves, to reach also the clients which could see it before
+    int m_areaCur;
+    int m_col, m_row;
+    bool m_fCollected;
+    std::vector<CChar*> m_chars;    // client chars of all the sectors, taken at the first call of next()
+    size_t m_charIndex;
+
+public:
+    explicit ClientNearbyIterator(const CObjBaseTemplate* pObj);    // clients which may see the object
+    ClientNearbyIterator(const CPointMap& pt, int iDist = UO_MAP_VIEW_SIZE_MAX);
+    ClientNearbyIterator(const CPointMap& pt, const CPointMap& ptOld, int iDist = UO_MAP_VIEW_SIZE_MAX);
+    ~ClientNearbyIterator(void) = default;
+
+private:
+    ClientNearbyIterator(const ClientNearbyIterator& copy);
+    ClientNearbyIterator& operator=(const ClientNearbyIterator& other);
+
+    void addArea(const CPointMap& pt, int iDist);
+    const CSector* nextSector();
+    void collectChars();
+
+public:
+    CClient* next(bool includeClosing = false); // finds next client
+};
+
 
 #endif // _INC_CCLIENTITERATOR_H
\ No newline at end of file
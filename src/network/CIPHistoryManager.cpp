@@ -15,10 +15,34 @@
  *
  *
  ***************************************************************************/
+// Token bucket: each connection attempt takes a token, there are iMaxPings tokens and one comes back every NETHISTORY_PINGDECAY
+//  seconds. The tokens are given back when checking, so nothing needs to be done meanwhile.
+static bool TakePingToken(int& iPings, int64& iTimePingDecay, int iMaxPings, int64 iTimeCur) noexcept
+{
+    const int64 iDecayPeriod = NETHISTORY_PINGDECAY * MSECS_PER_SEC;
+    if ((iPings > 0) && (iTimeCur >= iTimePingDecay))
+    {
+        const int64 iDecayed = 1 + ((iTimeCur - iTimePingDecay) / iDecayPeriod);
+        if (iDecayed >= iPings)
+        {
+            iPings = 0;
+        }
+        else
+        {
+            iPings -= (int)iDecayed;
+            iTimePingDecay += iDecayed * iDecayPeriod;
+        }
+    }
+    if (iPings == 0)
+        iTimePingDecay = iTimeCur + iDecayPeriod;
+
+    return (iPings++ >= iMaxPings);
+}
+
 void HistoryIP::update(void)
 {
     // reset ttl
-    m_ttl = NETHISTORY_TTL;
+    m_timeExpire = CWorldGameTime::GetCurrentTime().GetTimeRaw() + (NETHISTORY_TTL * MSECS_PER_SEC);
 }
 
 bool HistoryIP::checkPing(void)
@@ -26,7 +50,10 @@ bool HistoryIP::checkPing(void)
     // ip is pinging, check if blocked
     update();
 
-    return (m_blocked || (m_pings++ >= g_Cfg.m_iNetMaxPings));
+    if (m_blocked && (m_blockExpire > 0) && (CWorldGameTime::GetCurrentTime().GetTimeRaw() > m_blockExpire))
+        setBlocked(false);
+
+    return (m_blocked || TakePingToken(m_pings, m_timePingDecay, g_Cfg.m_iNetMaxPings, CWorldGameTime::GetCurrentTime().GetTimeRaw()));
 }
 
 void HistoryIP::setBlocked(bool isBlocked, int timeout)
@@ -58,59 +85,86 @@ void HistoryIP::setBlocked(bool isBlocked, int timeout)
  ***************************************************************************/
 IPHistoryManager::IPHistoryManager(void)
 {
-    m_lastDecayTime = 0;
+    m_lastWheelSecond = 0;
 }
 
 IPHistoryManager::~IPHistoryManager(void)
 {
     m_ips.clear();
+    m_subnets.clear();
 }
 
-void IPHistoryManager::tick(void)
+void IPHistoryManager::schedule(const ExpiryEntry& entry, int64 iTimeExpire)
 {
-    // periodic events
-    ADDTOCALLSTACK("IPHistoryManager::tick");
-
-    // check if ttl should decay (only do this once every second)
-    bool decayTTL = (!(m_lastDecayTime > 0) || CWorldGameTime::GetCurrentTime().GetTimeDiff(m_lastDecayTime) > MSECS_PER_SEC);
-    if (decayTTL)
-        m_lastDecayTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+    // Never in a slot already checked in this turn: it would wait for the next one.
+    const int64 iSecond = maximum(iTimeExpire / MSECS_PER_SEC, m_lastWheelSecond + 1);
+    m_expiryWheel[iSecond % NETHISTORY_WHEEL_SLOTS].emplace_back(entry);
+}
 
-    for (IPHistoryList::iterator it = m_ips.begin(), end = m_ips.end(); it != end; ++it)
+void IPHistoryManager::checkExpiry(const ExpiryEntry& entry, int64 iTimeCur)
+{
+    if (entry.fSubnet)
     {
-        if (it->m_blocked)
-        {
-            // blocked ips don't decay, but check if the ban has expired
-            if (it->m_blockExpire > 0 && (CWorldGameTime::GetCurrentTime().GetTimeRaw() > it->m_blockExpire))
-                it->setBlocked(false);
-        }
-        else if (decayTTL)
-        {
-            if (it->m_connected == 0 && it->m_connecting == 0)
-            {
-                // start to forget about clients who aren't connected
-                if (it->m_ttl >= 0)
-                    --it->m_ttl;
-            }
-
-            // wait a 5th of TTL between each ping decay, but do not wait less than 30 seconds
-            if (it->m_pings > 0 && --it->m_pingDecay < 0)
-            {
-                --it->m_pings;
-                it->m_pingDecay = NETHISTORY_PINGDECAY;
-            }
-        }
+        auto itSubnet = m_subnets.find(entry.dwAddr);
+        if (itSubnet == m_subnets.end())
+            return;
+        if (itSubnet->second.m_timeExpire <= iTimeCur)
+            m_subnets.erase(itSubnet);
+        else
+            schedule(entry, itSubnet->second.m_timeExpire);
+        return;
     }
 
-    // clear old ip history
-    for (IPHistoryList::iterator it = m_ips.begin(), end = m_ips.end(); it != end; ++it)
+    auto itIP = m_ips.find(entry.dwAddr);
+    if (itIP == m_ips.end())
+        return;
+    HistoryIP& hist = itIP->second;
+
+    if (hist.m_blocked && (hist.m_blockExpire > 0) && (iTimeCur > hist.m_blockExpire))
+        hist.setBlocked(false);
+
+    if (hist.m_blocked || (hist.m_connecting > 0) || (hist.m_connected > 0))
     {
-        if (it->m_ttl >= 0)
-            continue;
+        // blocked and connected ips aren't forgotten: start to forget them when the block expires or they disconnect
+        hist.update();
+        int64 iTimeCheck = hist.m_timeExpire;
+        if (hist.m_blocked && (hist.m_blockExpire > 0))
+            iTimeCheck = minimum(iTimeCheck, hist.m_blockExpire + 1);
+        schedule(entry, iTimeCheck);
+    }
+    else if (hist.m_timeExpire <= iTimeCur)
+    {
+        // clear old ip history
+        m_ips.erase(itIP);
+    }
+    else
+    {
+        schedule(entry, hist.m_timeExpire);
+    }
+}
+
+void IPHistoryManager::tick(void)
+{
+    // periodic events
+    ADDTOCALLSTACK("IPHistoryManager::tick");
+
+    const int64 iTimeCur = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+    const int64 iSecondCur = iTimeCur / MSECS_PER_SEC;
+    if (m_lastWheelSecond == 0)
+        m_lastWheelSecond = iSecondCur - 1;
 
-        m_ips.erase(it);
-        break;
+    // check the slots of the seconds elapsed since the last tick (once each, even if a whole turn elapsed)
+    const int64 iSecondLast = minimum(iSecondCur, m_lastWheelSecond + NETHISTORY_WHEEL_SLOTS);
+    std::vector<ExpiryEntry> vecEntries;
+    while (m_lastWheelSecond < iSecondLast)
+    {
+        ++m_lastWheelSecond;
+        vecEntries.swap(m_expiryWheel[m_lastWheelSecond % NETHISTORY_WHEEL_SLOTS]);
+        for (const ExpiryEntry& entry : vecEntries)
+            checkExpiry(entry, iTimeCur);
+        vecEntries.clear();
     }
+    m_lastWheelSecond = iSecondCur;
 }
 
 HistoryIP& IPHistoryManager::getHistoryForIP(const CSocketAddressIP& ip) noexcept
@@ -118,21 +172,17 @@ HistoryIP& IPHistoryManager::getHistoryForIP(const CSocketAddressIP& ip) noexcep
     // get history for an ip
 
     // find existing entry
-    for (IPHistoryList::iterator it = m_ips.begin(), end = m_ips.end(); it != end; ++it)
-    {
-        if (it->m_ip == ip)
-            return *it;
-    }
+    const dword dwAddr = ip.GetAddrIP();
+    auto it = m_ips.find(dwAddr);
+    if (it != m_ips.end())
+        return it->second;
 
     // create a new entry
-    HistoryIP hist = {};
+    HistoryIP& hist = m_ips[dwAddr];
     hist.m_ip = ip;
-    hist.m_pingDecay = NETHISTORY_PINGDECAY;
     hist.update();
-
-    m_ips.emplace_back(std::move(hist));
-
-    return getHistoryForIP(ip);
+    schedule(ExpiryEntry{ dwAddr, false }, hist.m_timeExpire);
+    return hist;
 }
 
 HistoryIP& IPHistoryManager::getHistoryForIP(const char* ip)
@@ -143,3 +193,24 @@ HistoryIP& IPHistoryManager::getHistoryForIP(const char* ip)
     CSocketAddressIP me(ip);
     return getHistoryForIP(me);
 }
+
+bool IPHistoryManager::checkSubnetPing(const CSocketAddressIP& ip)
+{
+    // ip of this subnet is pinging, check if the whole subnet is pinging too much (many ips of the same provider or botnet)
+    ADDTOCALLSTACK("IPHistoryManager::checkSubnetPing");
+    if (g_Cfg._iNetMaxPingsSubnet <= 0)
+        return false;
+
+    const int64 iTimeCur = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+    const dword dwSubnet = ip.GetAddrIP() & htonl(0xFFFFFF00);  // the address is in network byte order
+    auto it = m_subnets.find(dwSubnet);
+    if (it == m_subnets.end())
+    {
+        it = m_subnets.emplace(dwSubnet, HistorySubnet{}).first;
+        schedule(ExpiryEntry{ dwSubnet, true }, iTimeCur + (NETHISTORY_TTL * MSECS_PER_SEC));
+    }
+
+    HistorySubnet& subnet = it->second;
+    subnet.m_timeExpire = iTimeCur + (NETHISTORY_TTL * MSECS_PER_SEC);
+    return TakePingToken(subnet.m_pings, subnet.m_timePingDecay, g_Cfg._iNetMaxPingsSubnet, iTimeCur);
+}
@@ -6,8 +6,12 @@
 #ifndef _INC_CIPHISTORYMANAGER_H
 #define _INC_CIPHISTORYMANAGER_H
 
+#include "../../lib/parallel_hashmap/phmap.h"
 #include "CSocket.h"
-#include <deque>
+#include <vector>
+
+
+#define NETHISTORY_WHEEL_SLOTS	256		// seconds covered by a turn of the expiry wheel
 
 
 /***************************************************************************
@@ -20,20 +24,25 @@
 struct HistoryIP
 {
     CSocketAddressIP m_ip;
-    int m_pings;
+    int m_pings;            // connection attempts not decayed yet (tokens taken from its bucket)
     int m_connecting;
     int m_connected;
     bool m_blocked;
-    int m_ttl;
+    int64 m_timeExpire;     // when to forget about this ip, if it isn't connected nor blocked
     int64 m_blockExpire;
-    int m_pingDecay;
+    int64 m_timePingDecay;  // when the next ping decays
 
     void update(void);
     bool checkPing(void); // IP is blocked -or- too many pings to it?
     void setBlocked(bool isBlocked, int timeout = -1); // timeout in seconds
 };
 
-typedef std::deque<HistoryIP> IPHistoryList;
+struct HistorySubnet
+{
+    int m_pings;
+    int64 m_timeExpire;
+    int64 m_timePingDecay;
+};
 
 
 
@@ -47,8 +56,18 @@ typedef std::deque<HistoryIP> IPHistoryList;
 class IPHistoryManager
 {
 private:
-    IPHistoryList m_ips;		// list of known ips
-    int64 m_lastDecayTime;	// last decay time
+    // The ips are looked up by address (node map: the references given out stay valid when other ips are added).
+    // Instead of checking every ip on each tick, each one is in a slot of the expiry wheel: the slot of the second when it
+    //  might expire. Each second only its slot is checked: the ips still in use are moved to the slot of their new expiry.
+    struct ExpiryEntry
+    {
+        dword dwAddr;
+        bool fSubnet;
+    };
+    phmap::node_hash_map<dword, HistoryIP> m_ips;          // known ips
+    phmap::flat_hash_map<dword, HistorySubnet> m_subnets;   // known /24 subnets, if MaxPingsSubnet is set
+    std::vector<ExpiryEntry> m_expiryWheel[NETHISTORY_WHEEL_SLOTS];
+    int64 m_lastWheelSecond;	// last second checked in the expiry wheel
 
 public:
     IPHistoryManager(void);
@@ -63,6 +82,11 @@ public:
 
     HistoryIP& getHistoryForIP(const CSocketAddressIP& ip) noexcept;	// get history for an ip
     HistoryIP& getHistoryForIP(const char* ip);				// get history for an ip
+    bool checkSubnetPing(const CSocketAddressIP& ip);		// too many pings from the subnet of this ip?
+
+private:
+    void schedule(const ExpiryEntry& entry, int64 iTimeExpire);	// put the entry in the slot of the wheel of its expiry time
+    void checkExpiry(const ExpiryEntry& entry, int64 iTimeCur);
 };
 
 #endif // _INC_CIPHISTORYMANAGER_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "CPacketPool.h"
+#include "CNetOutQueue.h"
+
+
+CNetOutQueue::CNetOutQueue() : m_asyncSegment{ nullptr, 0, 0, 0 }, m_uiDataQty(0)
+{
+}
+
+CNetOutQueue::~CNetOutQueue()
+{
+    Empty();
+    freeSegment(m_asyncSegment);
+}
+
+void CNetOutQueue::freeSegment(Segment& segment)
+{
+    if (segment.pData != nullptr)
+        PacketPool::free(segment.pData, segment.uiCapacity);
+    segment.pData = nullptr;
+    segment.uiCapacity = segment.uiStart = segment.uiEnd = 0;
+}
+
+byte* CNetOutQueue::GetWriteBuffer(uint uiMinLen, uint* puiAvailable)
+{
+    ASSERT(puiAvailable != nullptr);
+    if (!m_segments.empty())
+    {
+        Segment& last = m_segments.back();
+        if (last.uiCapacity - last.uiEnd >= uiMinLen)
+        {
+            *puiAvailable = last.uiCapacity - last.uiEnd;
+            return last.pData + last.uiEnd;
+        }
+    }
+
+    // Start a new segment.
+    Segment segment;
+    segment.pData = static_cast<byte*>(PacketPool::alloc(maximum(uiMinLen, (uint)NETOUT_SEGMENT_SIZE), &segment.uiCapacity));
+    segment.uiStart = segment.uiEnd = 0;
+    m_segments.emplace_back(segment);
+
+    *puiAvailable = segment.uiCapacity;
+    return segment.pData;
+}
+
+void CNetOutQueue::CommitData(uint uiLen)
+{
+    ASSERT(!m_segments.empty());
+    Segment& last = m_segments.back();
+    ASSERT(last.uiEnd + uiLen <= last.uiCapacity);
+    last.uiEnd += uiLen;
+    m_uiDataQty += uiLen;
+}
+
+void CNetOutQueue::AddNewData(const byte* pData, uint uiLen)
+{
+    // The data can be split among the free space of the last segment and a new one.
+    while (uiLen > 0)
+    {
+        uint uiAvailable = 0;
+        byte* pBuffer = GetWriteBuffer(1, &uiAvailable);
+        const uint uiCopy = minimum(uiAvailable, uiLen);
+        memcpy(pBuffer, pData, uiCopy);
+        CommitData(uiCopy);
+        pData += uiCopy;
+        uiLen -= uiCopy;
+    }
+}
+
+uint CNetOutQueue::GetSendBuffers(CSocketBuf* pBuffers, uint uiMaxBuffers, size_t* puiLength) const
+{
+    uint uiBuffers = 0;
+    size_t uiLength = 0;
+    for (const Segment& segment : m_segments)
+    {
+        if (uiBuffers >= uiMaxBuffers)
+            break;
+        if (segment.uiEnd == segment.uiStart)
+            continue;
+
+        SetSocketBuf(pBuffers[uiBuffers++], segment.pData + segment.uiStart, segment.uiEnd - segment.uiStart);
+        uiLength += segment.uiEnd - segment.uiStart;
+    }
+
+    if (puiLength != nullptr)
+        *puiLength = uiLength;
+    return uiBuffers;
+}
+
+void CNetOutQueue::RemoveDataAmount(size_t uiSize, bool fAsync)
+{
+    // use up this sent data. (from the start)
+    if (uiSize > m_uiDataQty)
+        uiSize = m_uiDataQty;
+    m_uiDataQty -= uiSize;
+
+    while (!m_segments.empty())
+    {
+        Segment& first = m_segments.front();
+        const size_t uiRemove = minimum(uiSize, (size_t)(first.uiEnd - first.uiStart));
+        first.uiStart += (uint)uiRemove;
+        uiSize -= uiRemove;
+
+        if (first.uiStart < first.uiEnd)
+            break;  // partially sent
+
+        if (fAsync)
+        {
+            // Only one asynchronous send at a time, so the segment of the previous one can be freed now.
+            freeSegment(m_asyncSegment);
+            m_asyncSegment = first;
+        }
+        else
+        {
+            freeSegment(first);
+        }
+        m_segments.pop_front();
+    }
+}
+
+void CNetOutQueue::Empty()
+{
+    for (Segment& segment : m_segments)
+        freeSegment(segment);
+    m_segments.clear();
+    m_uiDataQty = 0;
+}
@@ -0,0 +1,58 @@
+/**
+* @file CNetOutQueue.h
+* @brief Chained buffers holding the data waiting to be sent to a client.
+*/
+
+#ifndef _INC_CNETOUTQUEUE_H
+#define _INC_CNETOUTQUEUE_H
+
+#include "../common/sphereproto.h"
+#include "CSocket.h"
+#include <deque>
+
+
+#define NETOUT_SEGMENT_SIZE		MAX_BUFFER	// min size of a segment, enough for any compressed and encrypted packet
+#define NETOUT_MAX_BUFFERS		16			// max segments sent with a single call
+
+
+// The packets are compressed and encrypted directly at the end of the last segment, and the segments are sent
+//  all together with a single (scatter/gather) call, without copying the data around.
+class CNetOutQueue
+{
+private:
+    struct Segment
+    {
+        byte* pData;
+        uint uiCapacity;
+        uint uiStart;   // first byte not sent yet
+        uint uiEnd;     // end of the data
+    };
+    std::deque<Segment> m_segments;    // the blocks are taken from the PacketPool, so allocating them is cheap
+    Segment m_asyncSegment;             // segment given to an asynchronous send, it must stay valid until the send is done
+    size_t m_uiDataQty;
+
+public:
+    CNetOutQueue();
+    ~CNetOutQueue();
+
+private:
+    CNetOutQueue(const CNetOutQueue& copy);
+    CNetOutQueue& operator=(const CNetOutQueue& other);
+
+public:
+    size_t GetDataQty() const noexcept {
+        return m_uiDataQty;
+    }
+
+    byte* GetWriteBuffer(uint uiMinLen, uint* puiAvailable);    // free space at the end of the queue, at least uiMinLen bytes
+    void CommitData(uint uiLen);                                // uiLen bytes were written in the space given by GetWriteBuffer
+    void AddNewData(const byte* pData, uint uiLen);
+    uint GetSendBuffers(CSocketBuf* pBuffers, uint uiMaxBuffers, size_t* puiLength) const;  // the data to be sent, at most uiMaxBuffers segments
+    void RemoveDataAmount(size_t uiSize, bool fAsync = false);  // uiSize bytes were sent (fAsync = or are being sent asynchronously)
+    void Empty();
+
+private:
+    void freeSegment(Segment& segment);
+};
+
+#endif // _INC_CNETOUTQUEUE_H
@@ -1,5 +1,8 @@
 #include "../common/sphereproto.h"
 #include "../common/CLog.h"
+#include "../common/sphere_library/CSFile.h"
+#include "../common/sphere_library/CSTime.h"
+#include "../game/CBenchmark.h"
 #include "../game/CServer.h"
 #include "../game/CServerConfig.h"
 #include "../game/CWorld.h"
@@ -28,17 +31,21 @@ CNetState::CNetState(int id)
     m_incoming.rawBuffer = nullptr;
     m_packetExceptions = 0;
     _iInByteCounter = _iOutByteCounter = 0;
+    _uiOutPackets = _uiOutSendCalls = _uiOutBytes = 0;
     m_clientType = CLIENTTYPE_2D;
     m_clientVersion = 0;
     m_reportedVersion = 0;
     m_isInUse = false;
     m_parent = nullptr;
+    _pRecordFile = nullptr;
+    _iRecordStart = 0;
 
     clear();
 }
 
 CNetState::~CNetState(void)
 {
+    delete _pRecordFile;
 }
 
 void CNetState::clear(void)
@@ -102,6 +109,13 @@ void CNetState::clear(void)
     m_socket.Close();
     m_client = nullptr;
 
+    if (_pRecordFile != nullptr)
+    {
+        _pRecordFile->Close();
+        delete _pRecordFile;
+        _pRecordFile = nullptr;
+    }
+
     // empty queues
     clearQueues();
 
@@ -190,6 +204,8 @@ void CNetState::init(SOCKET socket, CSocketAddress addr)
 
     m_peerAddress = addr;
     m_socket.SetSocket(socket);
+    _uiOutPackets = _uiOutSendCalls = _uiOutBytes = 0;
+    _iRecordStart = CSTime::GetPreciseSysTimeMilli();
     iSockRet = m_socket.SetNonBlocking();
     ASSERT(iSockRet == 0);
 
@@ -221,6 +237,34 @@ void CNetState::init(SOCKET socket, CSocketAddress addr)
     detectAsyncMode();
 }
 
+void CNetState::recordInput(const byte* data, int length)
+{
+    ADDTOCALLSTACK("CNetState::recordInput");
+    // Called by the thread reading this state: see CBenchmark.h for the format of the file.
+    if (_pRecordFile == nullptr)
+    {
+        _pRecordFile = new CSFile();
+        const CSString sFile(g_Benchmark.GetRecordFileName(id(), _iRecordStart));
+        if (!_pRecordFile->Open(sFile, OF_WRITE|OF_CREATE|OF_BINARY))
+        {
+            g_Log.Event(LOGL_ERROR, "%x:Can't create the recorded input file '%s'.\n", id(), sFile.GetBuffer());
+            return;
+        }
+
+        const dword dwMagic = BENCHMARK_RECORD_MAGIC;
+        _pRecordFile->Write(&dwMagic, sizeof(dwMagic));
+        _pRecordFile->Write(&_iRecordStart, sizeof(_iRecordStart));
+    }
+    if (!_pRecordFile->IsFileOpen())
+        return;
+
+    const int64 iTime = CSTime::GetPreciseSysTimeMilli() - _iRecordStart;
+    const int32 iLength = length;
+    _pRecordFile->Write(&iTime, sizeof(iTime));
+    _pRecordFile->Write(&iLength, sizeof(iLength));
+    _pRecordFile->Write(data, length);
+}
+
 bool CNetState::isInUse(const CClient* client) const volatile
 {
     if (m_isInUse == false)
@@ -6,9 +6,9 @@
 #ifndef _INC_CNETSTATE_H
 #define _INC_CNETSTATE_H
 
-#include "../common/sphere_library/CSQueue.h"
 #include "../common/sphereproto.h"
 #include "../sphere/containers.h"
+#include "CNetOutQueue.h"
 #include "CSocket.h"
 #include "packet.h"
 
@@ -26,6 +26,7 @@
 
 class CClient;
 class CNetworkThread;
+class CSFile;
 
 class CNetState
 {
@@ -64,7 +65,7 @@ protected:
     {
         PacketTransactionQueue queue[PacketSend::PRI_QTY];	// packet queue
         PacketSendQueue asyncQueue;		// async packet queue
-        CSQueueBytes bytes;				// byte queue
+        CNetOutQueue bytes;				// byte queue
 
         PacketTransaction* currentTransaction;			// transaction currently being processed
         ExtendedPacketTransaction* pendingTransaction;	// transaction being built
@@ -81,6 +82,15 @@ protected:
     int64 _iInByteCounter;    // number of bytes received by this client since the last legitimacy check
     int64 _iOutByteCounter;   // number of bytes sent     by this client since the last legitimacy check
 
+    // Output statistics, since the connection was opened.
+    ullong _uiOutPackets;     // packets sent
+    ullong _uiOutSendCalls;   // socket send calls
+    ullong _uiOutBytes;       // bytes sent
+
+    // Recording of the received data (-R command line switch), opened at the first read.
+    CSFile* _pRecordFile;
+    int64 _iRecordStart;      // system time (msecs) when the connection was opened
+
 public:
     GAMECLIENT_TYPE m_clientType;	// type of client
     dword m_clientVersion;			// client version (encryption)
@@ -109,6 +119,11 @@ public:
     void detectAsyncMode(void);
     void setAsyncMode(bool isAsync) { m_useAsync = isAsync; };	// set asynchronous mode
     bool isAsyncMode(void) const { return m_useAsync; };		// get asyncronous mode
+
+    ullong getOutPackets(void) const { return _uiOutPackets; };		// packets sent
+    ullong getOutSendCalls(void) const { return _uiOutSendCalls; };	// socket send calls
+    ullong getOutBytes(void) const { return _uiOutBytes; };			// bytes sent
+    void recordInput(const byte* data, int length);		// append the received data to the recorded input
 #ifdef _LIBEV
     struct ev_io* iocb(void) { return &m_eventWatcher; };		// get io callback
 #endif
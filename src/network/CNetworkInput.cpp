@@ -1,8 +1,10 @@
 #include "../common/crypto/CCrypto.h"
 #include "../game/clients/CClient.h"
+#include "../game/CBenchmark.h"
 #include "../game/CServer.h"
 #include "../game/CWorldGameTime.h"
 #include "../sphere/threads.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ProfileTask.h"
 #include "packet.h"
 #include "send.h"
@@ -107,6 +109,9 @@ void CNetworkInput::receiveData()
 
         EXC_SET_BLOCK("start client profile");
         CurrentProfileData.Count(PROFILE_DATA_RX, received);
+        g_Metrics.Add(METRIC_NETWORK_RX_BYTES, received);
+        if (g_Benchmark.IsRecording())
+            state->recordInput(m_receiveBuffer, received);
 
         EXC_SET_BLOCK("messages - parse");
 
@@ -131,11 +131,13 @@ void CNetworkManager::acceptNewConnection(void)
     int maxIp = g_Cfg.m_iConnectingMaxIP;
     int climaxIp = g_Cfg.m_iClientsMaxIP;
 
-    DEBUGNETWORK(("Incoming connection from '%s' [blocked=%d, ttl=%d, pings=%d, connecting=%d, connected=%d]\n",
-        ip.m_ip.GetAddrStr(), ip.m_blocked, ip.m_ttl, ip.m_pings, ip.m_connecting, ip.m_connected));
+    DEBUGNETWORK(("Incoming connection from '%s' [blocked=%d, expire=%" PRId64 ", pings=%d, connecting=%d, connected=%d]\n",
+        ip.m_ip.GetAddrStr(), ip.m_blocked, ip.m_timeExpire, ip.m_pings, ip.m_connecting, ip.m_connected));
 
     // check if ip is allowed to connect
-    if (ip.checkPing() ||								// check for ip ban
+    const bool fPingRejected = ip.checkPing();
+    const bool fSubnetRejected = !fPingRejected && m_ips.checkSubnetPing(client_addr);
+    if (fPingRejected || fSubnetRejected ||				// check for ip ban, too many pings from the ip or its subnet
         (maxIp > 0 && ip.m_connecting > maxIp) ||		// check for too many connecting
         (climaxIp > 0 && ip.m_connected > climaxIp))	// check for too many connected
     {
@@ -152,15 +154,17 @@ void CNetworkManager::acceptNewConnection(void)
             g_Log.Event(LOGM_CLIENTS_LOG | LOGL_ERROR, "Connection from %s rejected. (CLIENTMAXIP reached %d/%d)\n", static_cast<lpctstr>(client_addr.GetAddrStr()), ip.m_connected, climaxIp);
         else if (ip.m_pings >= g_Cfg.m_iNetMaxPings)
             g_Log.Event(LOGM_CLIENTS_LOG | LOGL_ERROR, "Connection from %s rejected. (MAXPINGS reached %d/%d)\n", static_cast<lpctstr>(client_addr.GetAddrStr()), ip.m_pings, (int)(g_Cfg.m_iNetMaxPings));
+        else if (fSubnetRejected)
+            g_Log.Event(LOGM_CLIENTS_LOG | LOGL_ERROR, "Connection from %s rejected. (MAXPINGSSUBNET reached %d)\n", static_cast<lpctstr>(client_addr.GetAddrStr()), g_Cfg._iNetMaxPingsSubnet);
         else
             g_Log.Event(LOGM_CLIENTS_LOG | LOGL_ERROR, "Connection from %s rejected.\n", static_cast<lpctstr>(client_addr.GetAddrStr()));
 
         return;
     }
 
-    // select an empty slot
-    EXC_SET_BLOCK("detecting slot");
-    CNetState* state = findFreeSlot();
+    // select an empty slot and assign it
+    EXC_SET_BLOCK("assigning slot");
+    CNetState* state = attachConnection(h, client_addr);
     if (state == nullptr)
     {
         // not enough empty slots
@@ -172,25 +176,30 @@ void CNetworkManager::acceptNewConnection(void)
         return;
     }
 
-    DEBUGNETWORK(("%x:Allocated slot for client (%u).\n", state->id(), (uint)(h)));
+    EXC_CATCH;
+}
 
-    // assign slot
-    EXC_SET_BLOCK("assigning slot");
+CNetState* CNetworkManager::attachConnection(SOCKET h, const CSocketAddress& client_addr)
+{
+    // assign an accepted socket to a new client (also used by the benchmark to connect the recorded input)
+    ADDTOCALLSTACK("CNetworkManager::attachConnection");
+
+    CNetState* state = findFreeSlot();
+    if (state == nullptr)
+        return nullptr;
+
+    DEBUGNETWORK(("%x:Allocated slot for client (%u).\n", state->id(), (uint)(h)));
     state->init(h, client_addr);
 
     DEBUGNETWORK(("%x:State initialised, registering client instance.\n", state->id()));
-
-    EXC_SET_BLOCK("recording client");
     if (state->getClient() != nullptr)
         m_clients.InsertContentHead(state->getClient());
 
-    EXC_SET_BLOCK("assigning thread");
     DEBUGNETWORK(("%x:Selecting a thread to assign to.\n", state->id()));
     assignNetworkState(state);
 
     DEBUGNETWORK(("%x:Client successfully initialised.\n", state->id()));
-
-    EXC_CATCH;
+    return state;
 }
 
 CNetState* CNetworkManager::findFreeSlot(int start)
@@ -370,7 +379,8 @@ void CNetworkManager::processAllInput(void)
     ADDTOCALLSTACK("CNetworkManager::processAllInput");
 
     // checkNewConnection will work on both Windows and Linux because it uses the select method, even if it's not the most efficient way to do it
-    if (checkNewConnection())
+    // the listening socket isn't open in benchmark mode
+    if (g_Serv.m_SocketMain.IsOpen() && checkNewConnection())
         acceptNewConnection();
 
     if (isInputThreaded() == false)	// Don't do this if the input is multi threaded, since the CNetworkThread ticks automatically by itself
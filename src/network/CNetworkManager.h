@@ -44,6 +44,7 @@ public:
 
     bool checkNewConnection(void);				// check if a new connection is waiting to be accepted
     void acceptNewConnection(void);				// accept a new connection
+    CNetState* attachConnection(SOCKET h, const CSocketAddress& client_addr);	// assign a connected socket to a free slot (nullptr if there's none)
 
     void processAllInput(void);					// process network input (NOT THREADSAFE)
     void processAllOutput(void);				// process network output (NOT THREADSAFE)
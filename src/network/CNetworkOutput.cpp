@@ -1,6 +1,7 @@
 #include "../game/clients/CClient.h"
 #include "../game/CServerConfig.h"
 #include "../sphere/threads.h"
+#include "../sphere/Metrics.h"
 #include "../sphere/ProfileTask.h"
 #include "packet.h"
 #include "CNetState.h"
@@ -51,13 +52,10 @@ void CALLBACK SendCompleted_Winsock(DWORD dwError, DWORD cbTransferred, LPWSAOVE
 
 CNetworkOutput::CNetworkOutput() : m_thread(nullptr)
 {
-	m_encryptBuffer = new byte[MAX_BUFFER];
 }
 
 CNetworkOutput::~CNetworkOutput()
 {
-	if (m_encryptBuffer != nullptr)
-		delete[] m_encryptBuffer;
 }
 
 bool CNetworkOutput::processOutput()
@@ -341,7 +339,18 @@ bool CNetworkOutput::processByteQueue(CNetState* state)
 	if (state->isWriteClosed() || state->m_outgoing.bytes.GetDataQty() <= 0)
 		return false;
 
-	size_t result = sendData(state, state->m_outgoing.bytes.RemoveDataLock(), state->m_outgoing.bytes.GetDataQty());
+#if defined(_WIN32) && !defined(_LIBEV)
+	const bool isAsyncSend = state->isAsyncMode();
+#else
+	const bool isAsyncSend = false;
+#endif
+
+	// send all the queued segments at once (the async winsock send supports only one buffer at a time)
+	CSocketBuf buffers[NETOUT_MAX_BUFFERS];
+	size_t length = 0;
+	const uint count = state->m_outgoing.bytes.GetSendBuffers(buffers, isAsyncSend ? 1 : NETOUT_MAX_BUFFERS, &length);
+
+	size_t result = sendData(state, buffers, count, length);
 	if (result == _failed_result())
 	{
 		// error occurred
@@ -353,7 +362,7 @@ bool CNetworkOutput::processByteQueue(CNetState* state)
 	if (result > 0)
 	{
 		state->_iOutByteCounter += minimum(INT64_MAX, result);
-		state->m_outgoing.bytes.RemoveDataAmount(result);
+		state->m_outgoing.bytes.RemoveDataAmount(result, isAsyncSend);
 	}
 
 	return true;
@@ -410,17 +419,20 @@ bool CNetworkOutput::sendPacketData(CNetState* state, PacketSend* packet)
 		return true;
 	}
 
-	EXC_SET_BLOCK("prepare data");
-	byte* sendBuffer = nullptr;
-	uint sendBufferLength = 0;
-
 	if (client->GetConnectType() == CONNECT_GAME)
 	{
-		// game clients require encryption
+		// game clients require encryption: compress and encrypt the packet directly in the byte queue
 		EXC_SET_BLOCK("compress and encrypt");
 
-		// compress
-		uint compressLength = client->xCompress(m_encryptBuffer, packet->getData(), MAX_BUFFER, packet->getLength());
+		// compress (in the space left in the last segment, or in a new one if it doesn't fit)
+		uint available = 0;
+		byte* sendBuffer = state->m_outgoing.bytes.GetWriteBuffer(packet->getLength(), &available);
+		uint compressLength = client->xCompress(sendBuffer, packet->getData(), available, packet->getLength());
+		if ((compressLength == 0) && (available < MAX_BUFFER))
+		{
+			sendBuffer = state->m_outgoing.bytes.GetWriteBuffer(MAX_BUFFER, &available);
+			compressLength = client->xCompress(sendBuffer, packet->getData(), available, packet->getLength());
+		}
         if (compressLength == 0)
         {
             g_Log.EventError("NET-OUT: Trying to compress (Huffman) too much data. Packet will not be sent. (Probably it's a dialog with a lot of data inside).\n");
@@ -430,26 +442,23 @@ bool CNetworkOutput::sendPacketData(CNetState* state, PacketSend* packet)
 		// encrypt
         if (client->m_Crypt.GetEncryptionType() == ENC_TFISH)
         {
-            if (!client->m_Crypt.Encrypt(m_encryptBuffer, m_encryptBuffer, MAX_BUFFER, compressLength))
+            if (!client->m_Crypt.Encrypt(sendBuffer, sendBuffer, available, compressLength))
             {
                 g_Log.EventError("NET-OUT: Trying to compress (TFISH/MD5) too much data. Packet will not be sent. (Probably it's a dialog with a lot of data inside).\n");
                 return false;
             }
         }
 
-		sendBuffer = m_encryptBuffer;
-		sendBufferLength = compressLength;
+		EXC_SET_BLOCK("queue data");
+		state->m_outgoing.bytes.CommitData(compressLength);
 	}
 	else
 	{
 		// other clients expect plain data
-		sendBuffer = packet->getData();
-		sendBufferLength = packet->getLength();
+		EXC_SET_BLOCK("queue data");
+		state->m_outgoing.bytes.AddNewData(packet->getData(), packet->getLength());
 	}
-
-	// queue packet data
-	EXC_SET_BLOCK("queue data");
-	state->m_outgoing.bytes.AddNewData(sendBuffer, sendBufferLength);
+	++state->_uiOutPackets;
 
 	// if buffering is disabled then process the queue straight away
 	// we need to do this rather than sending the packet data directly, otherwise if
@@ -474,12 +483,13 @@ bool CNetworkOutput::sendPacketData(CNetState* state, PacketSend* packet)
 	return false;
 }
 
-size_t CNetworkOutput::sendData(CNetState* state, const byte* data, size_t length)
+size_t CNetworkOutput::sendData(CNetState* state, CSocketBuf* buffers, uint count, size_t length)
 {
 	// send raw data to client
 	ADDTOCALLSTACK("CNetworkOutput::sendData");
 	ASSERT(state != nullptr);
-	ASSERT(data != nullptr);
+	ASSERT(buffers != nullptr);
+	ASSERT(count > 0);
 	ASSERT(length > 0);
 	ASSERT(length != _failed_result());
 	ASSERT(!m_thread->isActive() || m_thread->isCurrentThread());
@@ -495,8 +505,8 @@ size_t CNetworkOutput::sendData(CNetState* state, const byte* data, size_t lengt
 		// send via async winsock
 		ZeroMemory(&state->m_overlapped, sizeof(WSAOVERLAPPED));
 		state->m_overlapped.hEvent = state;
-		state->m_bufferWSA.len = static_cast<ULONG>(length);
-		state->m_bufferWSA.buf = reinterpret_cast<CHAR *>(const_cast<byte *>(data));
+		state->m_bufferWSA = buffers[0];
+		++state->_uiOutSendCalls;
 
 		DWORD bytesSent;
 		if (state->m_socket.SendAsync(&state->m_bufferWSA, 1, &bytesSent, 0, &state->m_overlapped, (LPWSAOVERLAPPED_COMPLETION_ROUTINE)SendCompleted_Winsock) == 0)
@@ -512,8 +522,9 @@ size_t CNetworkOutput::sendData(CNetState* state, const byte* data, size_t lengt
 	else
 #endif
 	{
-		// send via standard api
-		int sent = state->m_socket.Send(data, (int)length);
+		// send via standard api, all the buffers with a single call
+		int sent = state->m_socket.SendV(buffers, (int)count);
+		++state->_uiOutSendCalls;
 		if (sent > 0)
 			result = (size_t)(sent);
 		else
@@ -561,12 +572,16 @@ size_t CNetworkOutput::sendData(CNetState* state, const byte* data, size_t lengt
 	}
 
 	if (result > 0 && result != _failed_result())
+	{
 		CurrentProfileData.Count(PROFILE_DATA_TX, (dword)(result));
+		g_Metrics.Add(METRIC_NETWORK_TX_BYTES, result);
+		state->_uiOutBytes += result;
+	}
 
 	return result;
 	EXC_CATCH;
 	EXC_DEBUG_START;
-	g_Log.EventDebug("id='%x', packet '0x%x', length '%" PRIuSIZE_T "'\n", state->id(), *data, length);
+	g_Log.EventDebug("id='%x', buffers '%u', length '%" PRIuSIZE_T "'\n", state->id(), count, length);
 	EXC_DEBUG_END;
 	return _failed_result();
 }
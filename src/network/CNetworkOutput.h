@@ -7,6 +7,7 @@
 #define _INC_NETWORKOUTPUT_H
 
 #include "../common/common.h"
+#include "CSocket.h"
 
 class CNetworkThread;
 class PacketTransaction;
@@ -22,7 +23,6 @@ private:
 
 private:
 	CNetworkThread* m_thread;	// owning network thread
-	byte* m_encryptBuffer;		// buffer for encrpyted data
 
 public:
 	static const char* m_sClassName;
@@ -50,7 +50,7 @@ private:
 
 	bool sendPacket(CNetState* state, PacketSend* packet);				// send packet to client (can be queued for async operation)
 	bool sendPacketData(CNetState* state, PacketSend* packet);			// send packet data to client
-	size_t sendData(CNetState* state, const byte* data, size_t length);	// send raw data to client
+	size_t sendData(CNetState* state, CSocketBuf* buffers, uint count, size_t length);	// send raw data to client
 };
 
 
@@ -0,0 +1,187 @@
+#include "../common/sphere_library/CSString.h"
+#include "../common/sphere_library/smutex.h"
+#include "CPacketPool.h"
+#include <vector>
+
+
+// Size classes, matching the common packet lengths (and the size of the packet objects).
+static const size_t sm_uiClassSizes[PACKETPOOL_CLASSES] = { 32, 64, 128, 256, 512, 1024, 4096, 16384, 65536 };
+
+struct PacketPoolThreadCache
+{
+    std::vector<void*> vFree[PACKETPOOL_CLASSES];
+    ~PacketPoolThreadCache();
+};
+
+struct PacketPoolSharedCache
+{
+    SimpleMutex mutex;
+    std::vector<void*> vFree;
+};
+
+static thread_local PacketPoolThreadCache t_cache;
+static thread_local bool t_fCacheAlive = true;  // false when the thread is exiting and t_cache was destroyed
+
+// Never deleted: packets can still be freed during the static destruction at shutdown.
+static PacketPoolSharedCache* const sm_pSharedCache = new PacketPoolSharedCache[PACKETPOOL_CLASSES];
+
+std::atomic<ullong> PacketPool::sm_uiPoolHits(0);
+std::atomic<ullong> PacketPool::sm_uiHeapAllocs(0);
+std::atomic<uint> PacketPool::sm_uiPacketCount[0x100];
+std::atomic<uint> PacketPool::sm_uiReallocCount[0x100];
+
+
+static inline size_t GetThreadCacheMax(int iClass) noexcept
+{
+    return maximum(PACKETPOOL_CACHE_BYTES / sm_uiClassSizes[iClass], (size_t)4);
+}
+
+static inline size_t GetBatchSize(int iClass) noexcept
+{
+    return minimum((size_t)PACKETPOOL_BATCH, GetThreadCacheMax(iClass) / 2);
+}
+
+PacketPoolThreadCache::~PacketPoolThreadCache()
+{
+    t_fCacheAlive = false;
+    for (std::vector<void*>& vFree : this->vFree)
+    {
+        for (void* ptr : vFree)
+            ::operator delete(ptr);
+        vFree.clear();
+    }
+}
+
+
+int PacketPool::getSizeClass(size_t size) noexcept
+{
+    for (int i = 0; i < PACKETPOOL_CLASSES; ++i)
+    {
+        if (size <= sm_uiClassSizes[i])
+            return i;
+    }
+    return -1;  // too big, use the heap
+}
+
+void* PacketPool::alloc(size_t size, uint* puiCapacity)
+{
+    const int iClass = getSizeClass(size);
+    if (iClass < 0)
+    {
+        sm_uiHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+        if (puiCapacity != nullptr)
+            *puiCapacity = (uint)size;
+        return ::operator new(size);
+    }
+
+    const size_t uiClassSize = sm_uiClassSizes[iClass];
+    if (puiCapacity != nullptr)
+        *puiCapacity = (uint)uiClassSize;
+
+    if (!t_fCacheAlive)
+    {
+        // Still allocate the whole class size: the block can be freed later by a thread with a live cache.
+        sm_uiHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(uiClassSize);
+    }
+
+    std::vector<void*>& vFree = t_cache.vFree[iClass];
+    if (vFree.empty())
+    {
+        // Take a batch of the blocks freed by the other threads.
+        PacketPoolSharedCache& shared = sm_pSharedCache[iClass];
+        SimpleThreadLock lock(shared.mutex);
+        const size_t uiTake = minimum(shared.vFree.size(), GetBatchSize(iClass));
+        vFree.insert(vFree.end(), shared.vFree.end() - uiTake, shared.vFree.end());
+        shared.vFree.resize(shared.vFree.size() - uiTake);
+    }
+
+    if (vFree.empty())
+    {
+        sm_uiHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(uiClassSize);
+    }
+
+    sm_uiPoolHits.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = vFree.back();
+    vFree.pop_back();
+    return ptr;
+}
+
+void PacketPool::free(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    const int iClass = getSizeClass(size);
+    if ((iClass < 0) || !t_fCacheAlive)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    std::vector<void*>& vFree = t_cache.vFree[iClass];
+    vFree.push_back(ptr);
+    if (vFree.size() <= GetThreadCacheMax(iClass))
+        return;
+
+    // This thread is freeing more than it allocates (ie. a network thread freeing the packets sent):
+    //  move a batch to the shared cache, where the other threads can take them.
+    const size_t uiBatch = GetBatchSize(iClass);
+    const size_t uiSharedMax = GetThreadCacheMax(iClass) * 4;
+    PacketPoolSharedCache& shared = sm_pSharedCache[iClass];
+    SimpleThreadLock lock(shared.mutex);
+    for (size_t i = 0; i < uiBatch; ++i)
+    {
+        void* ptrFree = vFree.back();
+        vFree.pop_back();
+        if (shared.vFree.size() < uiSharedMax)
+            shared.vFree.push_back(ptrFree);
+        else
+            ::operator delete(ptrFree);
+    }
+}
+
+void PacketPool::countPacket(byte id)
+{
+    sm_uiPacketCount[id].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PacketPool::countRealloc(byte id)
+{
+    sm_uiReallocCount[id].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PacketPool::dump(CSString& output)
+{
+    CSString sLine;
+    size_t uiSharedBytes = 0;
+    for (int i = 0; i < PACKETPOOL_CLASSES; ++i)
+    {
+        SimpleThreadLock lock(sm_pSharedCache[i].mutex);
+        uiSharedBytes += sm_pSharedCache[i].vFree.size() * sm_uiClassSizes[i];
+    }
+
+    sLine.Format("Packet pool: %llu recycled, %llu heap allocations, %" PRIuSIZE_T " KB shared\n",
+        sm_uiPoolHits.load(std::memory_order_relaxed), sm_uiHeapAllocs.load(std::memory_order_relaxed), uiSharedBytes / 1024);
+    output += sLine.GetBuffer();
+
+    // Packets built and buffers grown, by packet id. Only the ids seen so far, 4 per line.
+    int iColumn = 0;
+    for (uint id = 0; id < 0x100; ++id)
+    {
+        const uint uiPackets = sm_uiPacketCount[id].load(std::memory_order_relaxed);
+        if (uiPackets == 0)
+            continue;
+
+        sLine.Format("  0x%02x: %10u (%u grown)", id, uiPackets, sm_uiReallocCount[id].load(std::memory_order_relaxed));
+        output += sLine.GetBuffer();
+        if (++iColumn == 4)
+        {
+            output += "\n";
+            iColumn = 0;
+        }
+    }
+    if (iColumn != 0)
+        output += "\n";
+}
@@ -0,0 +1,43 @@
+/**
+* @file CPacketPool.h
+* @brief Recycles the memory of the packets and their buffers.
+*/
+
+#ifndef _INC_CPACKETPOOL_H
+#define _INC_CPACKETPOOL_H
+
+#include "../common/common.h"
+#include <atomic>
+
+class CSString;
+
+
+#define PACKETPOOL_CLASSES		9		// number of size classes
+#define PACKETPOOL_CACHE_BYTES	0x40000	// max bytes cached by each thread, for each size class
+#define PACKETPOOL_BATCH		32		// blocks moved at once between a thread cache and the shared one
+
+
+// Packets are allocated by the main thread and freed by the network threads (or the other way around), at a very high rate:
+//  instead of going every time to the heap, the packet objects and their buffers are taken from size classes matching the
+//  common packet lengths. Each thread keeps its own cache of free blocks, exchanging them in batches with a shared one.
+class PacketPool
+{
+public:
+    static void* alloc(size_t size, uint* puiCapacity = nullptr);   // get a block of at least size bytes (puiCapacity = its real size)
+    static void free(void* ptr, size_t size);                       // give back a block (size = the one requested to alloc)
+
+    // Packet statistics
+    static void countPacket(byte id);       // a packet with this id was built
+    static void countRealloc(byte id);      // the buffer of a packet with this id had to be grown
+    static void dump(CSString& output);   // write the statistics, for the profile dump
+
+private:
+    static int getSizeClass(size_t size) noexcept;
+
+    static std::atomic<ullong> sm_uiPoolHits;       // blocks taken from the caches
+    static std::atomic<ullong> sm_uiHeapAllocs;     // blocks allocated from the heap
+    static std::atomic<uint> sm_uiPacketCount[0x100];
+    static std::atomic<uint> sm_uiReallocCount[0x100];
+};
+
+#endif // _INC_CPACKETPOOL_H
@@ -378,6 +378,20 @@ int CSocket::Send( const void * pData, int len ) const
 	return( send( m_hSocket, static_cast<const char *>(pData), len, 0 ));
 }
 
+int CSocket::SendV( CSocketBuf * pBuffers, int iCount ) const
+{
+	// Send many buffers with a single call.
+	// RETURN: length sent
+#ifdef _WIN32
+	DWORD dwSent = 0;
+	if ( WSASend( m_hSocket, pBuffers, (DWORD)iCount, &dwSent, 0, nullptr, nullptr ) == SOCKET_ERROR )
+		return SOCKET_ERROR;
+	return (int)dwSent;
+#else
+	return (int)writev( m_hSocket, pBuffers, iCount );
+#endif
+}
+
 int CSocket::Receive( void * pData, int len, int flags )
 {
 	// RETURN: length, <= 0 is closed or error.
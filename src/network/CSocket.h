@@ -19,6 +19,7 @@
 	#include <arpa/inet.h>
 	#include <signal.h>
 	#include <fcntl.h>
+	#include <sys/uio.h>
 
 	// Compatibility stuff.
 	#define INVALID_SOCKET  (SOCKET)(~0)
@@ -29,6 +30,23 @@
 #endif	// _WIN32
 
 
+// A buffer for scatter/gather sends.
+#ifdef _WIN32
+	typedef WSABUF CSocketBuf;
+	inline void SetSocketBuf(CSocketBuf& buf, const byte* pData, size_t len)
+	{
+		buf.buf = reinterpret_cast<CHAR *>(const_cast<byte *>(pData));
+		buf.len = static_cast<ULONG>(len);
+	}
+#else
+	typedef struct iovec CSocketBuf;
+	inline void SetSocketBuf(CSocketBuf& buf, const byte* pData, size_t len)
+	{
+		buf.iov_base = const_cast<byte *>(pData);
+		buf.iov_len = len;
+	}
+#endif
+
 #ifdef _WIN32
 #	define CLOSESOCKET(_x_)	{ shutdown(_x_, 2); closesocket(_x_); }
 #else
@@ -141,6 +159,7 @@ public:
 	SOCKET Accept( struct sockaddr_in * pSockAddrIn ) const;
 	SOCKET Accept( CSocketAddress & SockAddr ) const;
 	int Send( const void * pData, int len ) const;
+	int SendV( CSocketBuf * pBuffers, int iCount ) const;
 	int Receive( void * pData, int len, int flags = 0 );
 
 	int GetSockName( struct sockaddr_in * pSockAddrIn ) const;
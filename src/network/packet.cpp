@@ -3,6 +3,7 @@
 #include "../game/clients/CClient.h"
 #include "CNetState.h"
 #include "CNetworkThread.h"
+#include "CPacketPool.h"
 #include "net_datatypes.h"
 #include "packet.h"
 
@@ -84,20 +85,20 @@ void xRecordPacket(const CClient* client, Packet* packet, lpctstr heading)
 
 
 
-Packet::Packet(uint size) : m_buffer(nullptr)
+Packet::Packet(uint size) : m_buffer(nullptr), m_bufferCapacity(0)
 {
 	m_expectedLength = size;
 	clear();
 	resize(size > 0 ? size : PACKET_BUFFERDEFAULT);
 }
 
-Packet::Packet(const Packet& other) : m_buffer(nullptr)
+Packet::Packet(const Packet& other) : m_buffer(nullptr), m_bufferCapacity(0)
 {
 	clear();
 	copy(other);
 }
 
-Packet::Packet(const byte* data, uint size) : m_buffer(nullptr)
+Packet::Packet(const byte* data, uint size) : m_buffer(nullptr), m_bufferCapacity(0)
 {
 	clear();
 	m_expectedLength = 0;
@@ -111,6 +112,16 @@ Packet::~Packet(void)
 	clear();
 }
 
+void* Packet::operator new(size_t size)
+{
+	return PacketPool::alloc(size);
+}
+
+void Packet::operator delete(void* ptr, size_t size)
+{
+	PacketPool::free(ptr, size);
+}
+
 bool Packet::isValid(void) const
 {
 	return m_buffer != nullptr && m_length > 0;
@@ -147,11 +158,12 @@ void Packet::clear(void)
 {
 	if (m_buffer != nullptr)
 	{
-		delete[] m_buffer;
+		PacketPool::free(m_buffer, m_bufferCapacity);
 		m_buffer = nullptr;
 	}
 
 	m_bufferSize = 0;
+	m_bufferCapacity = 0;
 	m_position = 0;
 }
 
@@ -176,16 +188,25 @@ void Packet::expand(uint size)
 void Packet::resize(uint newsize)
 {
 	ASSERT(newsize > 0);
-	if ( newsize > m_bufferSize )		// increase buffer, copying the contents
+	if ( newsize > m_bufferCapacity )	// increase buffer, copying the contents
 	{
-		byte* buffer = new byte[newsize];
+		uint capacity = 0;
+		byte* buffer = static_cast<byte*>(PacketPool::alloc(newsize, &capacity));
 		if (m_buffer != nullptr)
 		{
+			if (m_bufferSize > 0)
+				PacketPool::countRealloc(m_buffer[0]);
 			memcpy(buffer, m_buffer, m_bufferSize);
-			delete[] m_buffer;
+			PacketPool::free(m_buffer, m_bufferCapacity);
 		}
 		
 		m_buffer = buffer;
+		m_bufferCapacity = capacity;
+		m_bufferSize = newsize;
+		m_length = m_bufferSize;
+	}
+	else if ( newsize > m_bufferSize )	// increase buffer, the memory block is already big enough
+	{
 		m_bufferSize = newsize;
 		m_length = m_bufferSize;
 	}
@@ -1207,11 +1228,13 @@ PacketSend::PacketSend(byte id, uint len, Priority priority)
 		resize(len);
 
 	writeByte(id);
+	PacketPool::countPacket(id);
 }
 
 PacketSend::PacketSend(const PacketSend *other)
 {
 	copy(*other);
+	PacketPool::countPacket(m_buffer[0]);
 	m_target = other->m_target;
 	m_priority = other->m_priority;
 	m_lengthPosition = other->m_lengthPosition;
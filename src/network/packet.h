@@ -42,6 +42,7 @@ class Packet
 protected:
 	byte* m_buffer;				// raw data
 	uint m_bufferSize;		// size of raw data
+	uint m_bufferCapacity;	// size of the memory block holding the raw data (taken from the PacketPool)
 
 	uint m_length;			// length of packet
 	uint m_position;			// current position in packet
@@ -53,6 +54,10 @@ public:
 	Packet(const byte* data, uint size);
 	virtual ~Packet(void);
 
+	// Packet objects are taken from the PacketPool too.
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 private:
 	Packet& operator=(const Packet& other);
 
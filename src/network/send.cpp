@@ -3,6 +3,7 @@
 	#include <sys/time.h>
 #endif
 
+#include "../common/resource/sections/CDialogDef.h"
 #include "../common/resource/CResourceLock.h"
 #include "../common/CLog.h"
 #include "../common/CUOInstall.h"
@@ -20,6 +21,7 @@
 #include "../game/components/CCPropsChar.h"
 #include "../game/CServer.h"
 #include "../game/CWorldGameTime.h"
+#include "../sphere/Metrics.h"
 #include "CNetworkManager.h"
 #include "send.h"
 
@@ -1033,6 +1035,27 @@ PacketDeathMenu::PacketDeathMenu(const CClient* target, Mode mode) : PacketSend(
 }
 
 
+/***************************************************************************
+ *
+ *
+ *	Packet 0x2D : PacketStatsUpdate			update character health, mana and stamina (LOW)
+ *
+ *
+ ***************************************************************************/
+PacketStatsUpdate::PacketStatsUpdate(const CChar* character) : PacketSend(XCMD_StatChngAll, 17, g_Cfg.m_fUsePacketPriorities? PRI_LOW : PRI_NORMAL)
+{
+	ADDTOCALLSTACK("PacketStatsUpdate::PacketStatsUpdate");
+
+	writeInt32(character->GetUID());
+	writeInt16((word)(character->Stat_GetMaxAdjusted(STAT_STR)));
+	writeInt16((word)(character->Stat_GetVal(STAT_STR)));
+	writeInt16((word)(character->Stat_GetMaxAdjusted(STAT_INT)));
+	writeInt16((word)(character->Stat_GetVal(STAT_INT)));
+	writeInt16((word)(character->Stat_GetMaxAdjusted(STAT_DEX)));
+	writeInt16((word)(character->Stat_GetVal(STAT_DEX)));
+}
+
+
 /***************************************************************************
  *
  *
@@ -3574,18 +3597,50 @@ PacketGumpDialog::PacketGumpDialog(int x, int y, CObjBase* object, dword context
 	writeInt32(y);
 }
 
-void PacketGumpDialog::writeControls(const CClient* target, const CSString* controls, uint controlCount, const CSString* texts, uint textCount)
+void PacketGumpDialog::writeControls(const CClient* target, const CSString* controls, uint controlCount, const CSString* texts, uint textCount, CDialogPacketCache* cache)
 {
 	ADDTOCALLSTACK("PacketGumpDialog::writeControls");
 
 	const CNetState* net = target->GetNetState();
 	if (net->isClientVersion(MINCLIVER_COMPRESSDIALOG) || net->isClientKR() || net->isClientEnhanced())
-		writeCompressedControls(controls, controlCount, texts, textCount);
+		writeCompressedControls(controls, controlCount, texts, textCount, cache);
 	else
 		writeStandardControls(controls, controlCount, texts, textCount);
 }
 
-void PacketGumpDialog::writeCompressedControls(const CSString* controls, uint controlCount, const CSString* texts, uint textCount)
+// Compress a part of the gump. If the dialog sends the same data of the last time, its compressed data is reused.
+static const std::vector<byte>* compressGumpPart(const byte* source, uint sourceLength, CDialogCompressedPart* cache, std::vector<byte>& buffer)
+{
+	if (cache != nullptr && !cache->m_vecCompressed.empty() && cache->m_vecSource.size() == sourceLength &&
+		memcmp(cache->m_vecSource.data(), source, sourceLength) == 0)
+	{
+		g_Metrics.Add(METRIC_GUMP_CACHE_HITS);
+		g_Metrics.Add(METRIC_GUMP_CACHE_SAVED_BYTES, sourceLength);
+		return &cache->m_vecCompressed;
+	}
+
+	std::vector<byte>& compressed = (cache != nullptr) ? cache->m_vecCompressed : buffer;
+	z_uLong compressLength = z_compressBound((z_uLong)sourceLength);
+	compressed.resize(compressLength);
+
+	int error = z_compress2(compressed.data(), &compressLength, source, (z_uLong)sourceLength, Z_DEFAULT_COMPRESSION);
+	if (error != Z_OK || compressLength <= 0)
+	{
+		compressed.clear();
+		g_Log.EventError("Compress failed with error %d when generating gump. Using old packet.\n", error);
+		return nullptr;
+	}
+	compressed.resize(compressLength);
+
+	if (cache != nullptr)
+	{
+		cache->m_vecSource.assign(source, source + sourceLength);
+		g_Metrics.Add(METRIC_GUMP_CACHE_MISSES);
+	}
+	return &compressed;
+}
+
+void PacketGumpDialog::writeCompressedControls(const CSString* controls, uint controlCount, const CSString* texts, uint textCount, CDialogPacketCache* cache)
 {
 	ADDTOCALLSTACK("PacketGumpDialog::writeCompressedControls");
 
@@ -3594,6 +3649,7 @@ void PacketGumpDialog::writeCompressedControls(const CSString* controls, uint co
 
 	seek(19);
 
+	std::vector<byte> compressBuffer;
 	{
 		// compress and write controls
 		int controlLength = 1;
@@ -3609,26 +3665,18 @@ void PacketGumpDialog::writeCompressedControls(const CSString* controls, uint co
 
 		ASSERT(controlLengthActual == controlLength);
 
-		z_uLong compressLength = z_compressBound(controlLengthActual);
-		byte* compressBuffer = new byte[compressLength];
-
-		int error = z_compress2(compressBuffer, &compressLength, (byte*)toCompress, controlLengthActual, Z_DEFAULT_COMPRESSION);
+		const std::vector<byte>* compressed = compressGumpPart((byte*)toCompress, controlLengthActual, cache ? &cache->m_Layout : nullptr, compressBuffer);
 		delete[] toCompress;
 
-		if (error != Z_OK || compressLength <= 0)
+		if (compressed == nullptr)
 		{
-			delete[] compressBuffer;
-			g_Log.EventError("Compress failed with error %d when generating gump. Using old packet.\n", error);
-
 			writeStandardControls(controls, controlCount, texts, textCount);
 			return;
 		}
 
-		writeInt32(compressLength + 4);
+		writeInt32((dword)compressed->size() + 4);
 		writeInt32(controlLengthActual);
-		writeData(compressBuffer, compressLength);
-
-		delete[] compressBuffer;
+		writeData(compressed->data(), (uint)compressed->size());
 	}
 
 	{
@@ -3643,27 +3691,18 @@ void PacketGumpDialog::writeCompressedControls(const CSString* controls, uint co
 
 		uint textsLength = getPosition() - textsPosition;
 
-		z_uLong compressLength = z_compressBound((z_uLong)textsLength);
-		byte* compressBuffer = new byte[compressLength];
-
-		int error = z_compress2(compressBuffer, &compressLength, &m_buffer[textsPosition], (z_uLong)textsLength, Z_DEFAULT_COMPRESSION);
-		if (error != Z_OK || compressLength <= 0)
+		const std::vector<byte>* compressed = compressGumpPart(&m_buffer[textsPosition], textsLength, cache ? &cache->m_Texts : nullptr, compressBuffer);
+		if (compressed == nullptr)
 		{
-			delete[] compressBuffer;
-
-			g_Log.EventError("Compress failed with error %d when generating gump. Using old packet.\n", error);
-
 			writeStandardControls(controls, controlCount, texts, textCount);
 			return;
 		}
 
 		seek(textsPosition);
 		writeInt32((dword)textCount);
-		writeInt32(compressLength + 4);
+		writeInt32((dword)compressed->size() + 4);
 		writeInt32((dword)textsLength);
-		writeData(compressBuffer, compressLength);
-
-		delete[] compressBuffer;
+		writeData(compressed->data(), (uint)compressed->size());
 	}
 }
 
@@ -28,6 +28,8 @@ class CItemCorpse;
 class CCharRefArray;
 class CItemMultiCustom;
 class CItemShip;
+struct CDialogPacketCache;
+struct CDialogCompressedPart;
 class CClientTooltip;
 
 
@@ -398,6 +400,19 @@ public:
 	PacketDeathMenu(const CClient* target, Mode mode);
 };
 
+/***************************************************************************
+ *
+ *
+ *	Packet 0x2D : PacketStatsUpdate			update character health, mana and stamina (LOW)
+ *
+ *
+ ***************************************************************************/
+class PacketStatsUpdate : public PacketSend
+{
+public:
+	PacketStatsUpdate(const CChar* character);
+};
+
 /***************************************************************************
  *
  *
@@ -883,6 +898,7 @@ public:
 		MaxPassTries,   // max password tries reached
 
 
+		Pending = 0xFE, // (internal) waiting for the password verification, the reply is sent later
 		Success = 0xFF  // no error
 	};
 
@@ -1223,10 +1239,10 @@ class PacketGumpDialog : public PacketSend
 {
 public:
 	PacketGumpDialog(int x, int y, CObjBase* object, dword context);
-	void writeControls(const CClient* target, const CSString* controls, uint controlCount, const CSString* texts, uint textCount);
+	void writeControls(const CClient* target, const CSString* controls, uint controlCount, const CSString* texts, uint textCount, CDialogPacketCache* cache = nullptr);
 
 protected:
-	void writeCompressedControls(const CSString* controls, uint controlCount, const CSString* texts, uint textCount);
+	void writeCompressedControls(const CSString* controls, uint controlCount, const CSString* texts, uint textCount, CDialogPacketCache* cache);
 	void writeStandardControls(const CSString* controls, uint controlCount, const CSString* texts, uint textCount);
 };
 
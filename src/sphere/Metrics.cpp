@@ -0,0 +1,195 @@
+#include "../common/sphere_library/CSString.h"
+#include "../common/sphereversion.h"
+#include "threads.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <chrono>
+
+MetricsRegistry g_Metrics;
+
+
+struct MetricDef
+{
+	lpctstr ptcName;	// metrics with the same name (and different labels) must be consecutive
+	lpctstr ptcLabels;
+	lpctstr ptcHelp;
+};
+
+static constexpr MetricDef sm_MetricDefs[METRIC_QTY] =
+{
+	{ "sphere_tick_phase_seconds",		"phase=\"network_in\"",		"Duration of the phases of the main loop." },
+	{ "sphere_tick_phase_seconds",		"phase=\"world\"",			nullptr },
+	{ "sphere_tick_phase_seconds",		"phase=\"auth\"",			nullptr },
+	{ "sphere_tick_phase_seconds",		"phase=\"server\"",			nullptr },
+	{ "sphere_tick_phase_seconds",		"phase=\"network_out\"",	nullptr },
+	{ "sphere_tick_phase_seconds",		"phase=\"network_tick\"",	nullptr },
+	{ "sphere_world_tick_jitter_seconds",	nullptr,				"Delay of the world ticks from their scheduled time." },
+	{ "sphere_save_stage_seconds",		"stage=\"gc\"",				"Duration of the steps of the world save." },
+	{ "sphere_save_stage_seconds",		"stage=\"sectors\"",		nullptr },
+	{ "sphere_save_stage_seconds",		"stage=\"globals\"",		nullptr },
+	{ "sphere_save_stage_seconds",		"stage=\"accounts\"",		nullptr },
+	{ "sphere_save_stage_seconds",		"stage=\"finish\"",			nullptr },
+	{ "sphere_script_run_seconds",		nullptr,					"Duration of the scripts run (outermost trigger or function)." },
+
+	{ "sphere_network_received_bytes_total",	nullptr,			"Bytes received from the clients." },
+	{ "sphere_network_sent_bytes_total",	nullptr,				"Bytes sent to the clients." },
+	{ "sphere_world_tick_overruns_total",	nullptr,				"World ticks which took longer than WorldTickPeriod." },
+	{ "sphere_world_tick_missed_total",		nullptr,				"World ticks skipped because the server was late." },
+	{ "sphere_saves_total",				nullptr,					"World saves completed." },
+	{ "sphere_mapcache_hits_total",		nullptr,					"Map blocks found in the cache." },
+	{ "sphere_mapcache_misses_total",	nullptr,					"Map blocks loaded from the map files." },
+	{ "sphere_mapcache_evictions_total",	nullptr,				"Map blocks removed from the cache." },
+	{ "sphere_log_lines_total",			nullptr,					"Lines queued for the log writer." },
+	{ "sphere_log_dropped_lines_total",	nullptr,					"Lines not logged because the log queue was full." },
+	{ "sphere_gump_cache_hits_total",	nullptr,					"Parts of the dialogs (layout or texts) sent again without compressing them." },
+	{ "sphere_gump_cache_misses_total",	nullptr,					"Parts of the dialogs (layout or texts) compressed because they changed." },
+	{ "sphere_gump_cache_saved_bytes_total",	nullptr,			"Bytes of the dialogs not compressed again." },
+	{ "sphere_gump_layout_hits_total",	nullptr,					"Dialogs with a static layout opened without running their layout script." },
+	{ "sphere_gump_layout_misses_total",	nullptr,				"Static layouts of the dialogs built by their script." },
+	{ "sphere_spawns_total",			nullptr,					"Spawns which generated (or tried to generate) a char or an item." },
+	{ "sphere_spawns_deferred_total",	nullptr,					"Spawns postponed because too many spawned in the same tick (SpawnsPerTick)." },
+	{ "sphere_spawn_points_reused_total",	nullptr,				"Chars placed on a point already found by their spawn, instead of looking for a new one." },
+	{ "sphere_npc_looks_total",			nullptr,					"NPC looks around, served by the perception snapshots of the sectors." },
+	{ "sphere_npc_perception_snapshots_total",	nullptr,			"Perception snapshots taken: the other looks from the same sector in the same tick reused them." },
+
+	{ "sphere_clients",					nullptr,					"Connected clients." },
+	{ "sphere_chars",					nullptr,					"Chars in the world." },
+	{ "sphere_items",					nullptr,					"Items in the world." },
+	{ "sphere_mapcache_bytes",			nullptr,					"Memory used by the cached map blocks." }
+};
+
+
+MetricsRegistry::MetricsRegistry() :
+	_iTimeNextSample(0)
+{
+	for (Histogram& histogram : _histograms)
+	{
+		histogram._uiSampleNext = histogram._uiSampleCount = 0;
+		histogram._uiObservations = histogram._uiSum = 0;
+	}
+	for (std::atomic<llong>& iValue : _iValues)
+		iValue.store(0, std::memory_order_relaxed);
+}
+
+int64 MetricsRegistry::GetTimeUsecs() noexcept // static
+{
+	const auto timeNow = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(timeNow).count();
+}
+
+void MetricsRegistry::Observe(METRIC_TYPE id, int64 iUsecs)
+{
+	ASSERT(id < METRIC_HISTOGRAM_QTY);
+	Histogram& histogram = _histograms[id];
+	const uint uiUsecs = uint(std::clamp(iUsecs, int64(0), int64(UINT32_MAX)));
+
+	SimpleThreadLock lock(histogram._mutex);
+	histogram._uiSamples[histogram._uiSampleNext] = uiUsecs;
+	histogram._uiSampleNext = (histogram._uiSampleNext + 1) % METRICS_HISTOGRAM_SAMPLES;
+	if (histogram._uiSampleCount < METRICS_HISTOGRAM_SAMPLES)
+		++histogram._uiSampleCount;
+	++histogram._uiObservations;
+	histogram._uiSum += uiUsecs;
+}
+
+void MetricsRegistry::Add(METRIC_TYPE id, llong iVal) noexcept
+{
+	ASSERT((id >= METRIC_HISTOGRAM_QTY) && (id < METRIC_COUNTER_QTY));
+	_iValues[id - METRIC_HISTOGRAM_QTY].fetch_add(iVal, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Set(METRIC_TYPE id, llong iVal) noexcept
+{
+	ASSERT((id >= METRIC_HISTOGRAM_QTY) && (id < METRIC_QTY));
+	_iValues[id - METRIC_HISTOGRAM_QTY].store(iVal, std::memory_order_relaxed);
+}
+
+bool MetricsRegistry::IsSampleDue(int64 iTimeCur) noexcept
+{
+	if (iTimeCur < _iTimeNextSample)
+		return false;
+	_iTimeNextSample = iTimeCur + METRICS_SAMPLE_PERIOD;
+	return true;
+}
+
+void MetricsRegistry::ExportHistogram(CSString& sOut, METRIC_TYPE id)
+{
+	// Exported as a summary: the quantiles of the latest observations, the count and the sum of all of them.
+	static constexpr uint sm_uiQuantiles[] = { 50, 90, 95, 99 };
+
+	uint uiSorted[METRICS_HISTOGRAM_SAMPLES];
+	uint uiCount;
+	ullong uiObservations, uiSum;
+	{
+		Histogram& histogram = _histograms[id];
+		SimpleThreadLock lock(histogram._mutex);
+		uiCount = histogram._uiSampleCount;
+		std::copy(histogram._uiSamples, histogram._uiSamples + uiCount, uiSorted);
+		uiObservations = histogram._uiObservations;
+		uiSum = histogram._uiSum;
+	}
+
+	const MetricDef& def = sm_MetricDefs[id];
+	const lpctstr ptcSep = def.ptcLabels ? "," : "";
+	const lpctstr ptcLabels = def.ptcLabels ? def.ptcLabels : "";
+	CSString sLine;
+	if (uiCount > 0)
+	{
+		std::sort(uiSorted, uiSorted + uiCount);
+		for (uint uiQuantile : sm_uiQuantiles)
+		{
+			const uint uiIndex = minimum(uiCount - 1, (uiCount * uiQuantile) / 100);
+			sLine.Format("%s{%s%squantile=\"0.%02u\"} %.6f\n", def.ptcName, ptcLabels, ptcSep, uiQuantile, uiSorted[uiIndex] / 1000000.0);
+			sOut += sLine.GetBuffer();
+		}
+	}
+	sLine.Format("%s_sum%s%s%s %.6f\n%s_count%s%s%s %" PRIu64 "\n",
+		def.ptcName, def.ptcLabels ? "{" : "", ptcLabels, def.ptcLabels ? "}" : "", uiSum / 1000000.0,
+		def.ptcName, def.ptcLabels ? "{" : "", ptcLabels, def.ptcLabels ? "}" : "", uiObservations);
+	sOut += sLine.GetBuffer();
+}
+
+void MetricsRegistry::Export(CSString& sOut)
+{
+	ADDTOCALLSTACK("MetricsRegistry::Export");
+	sOut.Format("# HELP sphere_build_info Version of the server.\n# TYPE sphere_build_info gauge\n"
+		"sphere_build_info{version=\"%s\"} 1\n", SPHERE_BUILD_NAME_VER_PREFIX SPHERE_BUILD_INFO_STR);
+
+	CSString sLine;
+	for (int i = 0; i < METRIC_QTY; ++i)
+	{
+		const METRIC_TYPE id = (METRIC_TYPE)i;
+		const MetricDef& def = sm_MetricDefs[id];
+		if (def.ptcHelp)
+		{
+			const lpctstr ptcType = (id < METRIC_HISTOGRAM_QTY) ? "summary" : ((id < METRIC_COUNTER_QTY) ? "counter" : "gauge");
+			sLine.Format("# HELP %s %s\n# TYPE %s %s\n", def.ptcName, def.ptcHelp, def.ptcName, ptcType);
+			sOut += sLine.GetBuffer();
+		}
+
+		if (id < METRIC_HISTOGRAM_QTY)
+		{
+			ExportHistogram(sOut, id);
+			continue;
+		}
+
+		const llong iVal = _iValues[id - METRIC_HISTOGRAM_QTY].load(std::memory_order_relaxed);
+		if (def.ptcLabels)
+			sLine.Format("%s{%s} %lld\n", def.ptcName, def.ptcLabels, iVal);
+		else
+			sLine.Format("%s %lld\n", def.ptcName, iVal);
+		sOut += sLine.GetBuffer();
+	}
+}
+
+
+MetricTimer::MetricTimer(METRIC_TYPE id, bool fEnabled) noexcept :
+	_iStart(fEnabled ? MetricsRegistry::GetTimeUsecs() : 0), _id(id), _fEnabled(fEnabled)
+{
+}
+
+MetricTimer::~MetricTimer()
+{
+	if (_fEnabled)
+		g_Metrics.Observe(_id, MetricsRegistry::GetTimeUsecs() - _iStart);
+}
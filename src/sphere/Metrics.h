@@ -0,0 +1,129 @@
+/**
+* @file Metrics.h
+* @brief Counters, gauges and histograms of the server internals, exported in the Prometheus text format.
+*/
+
+#ifndef _INC_METRICS_H
+#define _INC_METRICS_H
+
+#include "../common/sphere_library/smutex.h"
+#include <atomic>
+
+class CSString;
+
+
+#define METRICS_HISTOGRAM_SAMPLES	1024	// latest observations kept by each histogram, to calculate the quantiles
+#define METRICS_SAMPLE_PERIOD		1000	// msecs between two samplings of the gauges
+
+
+enum METRIC_TYPE : uchar
+{
+	// Histograms (durations, in usecs)
+	METRIC_TICK_NETWORK_IN,		// phases of the main loop
+	METRIC_TICK_WORLD,
+	METRIC_TICK_AUTH,
+	METRIC_TICK_SERVER,
+	METRIC_TICK_NETWORK_OUT,
+	METRIC_TICK_NETWORK_TICK,
+	METRIC_WORLD_TICK_JITTER,	// delay of the world ticks from their scheduled time
+	METRIC_SAVE_GC,				// stages of the world save
+	METRIC_SAVE_SECTORS,
+	METRIC_SAVE_GLOBALS,
+	METRIC_SAVE_ACCOUNTS,
+	METRIC_SAVE_FINISH,
+	METRIC_SCRIPT_RUN,			// scripts run (outermost trigger or function)
+	METRIC_HISTOGRAM_QTY,
+
+	// Counters
+	METRIC_NETWORK_RX_BYTES = METRIC_HISTOGRAM_QTY,
+	METRIC_NETWORK_TX_BYTES,
+	METRIC_WORLD_TICK_OVERRUNS,
+	METRIC_WORLD_TICK_MISSED,
+	METRIC_SAVES,
+	METRIC_MAPCACHE_HITS,		// these are sampled from the map cache
+	METRIC_MAPCACHE_MISSES,
+	METRIC_MAPCACHE_EVICTIONS,
+	METRIC_LOG_LINES,			// these are sampled from the log queue
+	METRIC_LOG_DROPPED_LINES,
+	METRIC_GUMP_CACHE_HITS,		// compressed parts of the dialogs reused
+	METRIC_GUMP_CACHE_MISSES,
+	METRIC_GUMP_CACHE_SAVED_BYTES,
+	METRIC_GUMP_LAYOUT_HITS,	// static dialog layouts reused
+	METRIC_GUMP_LAYOUT_MISSES,
+	METRIC_SPAWNS,				// spawns generating a char or an item
+	METRIC_SPAWNS_DEFERRED,		// postponed because of SpawnsPerTick
+	METRIC_SPAWN_POINTS_REUSED,
+	METRIC_NPC_LOOKS,			// these are sampled from the sectors
+	METRIC_NPC_PERCEPTION_SNAPSHOTS,
+	METRIC_COUNTER_QTY,
+
+	// Gauges (sampled every METRICS_SAMPLE_PERIOD)
+	METRIC_CLIENTS = METRIC_COUNTER_QTY,
+	METRIC_CHARS,
+	METRIC_ITEMS,
+	METRIC_MAPCACHE_BYTES,
+
+	METRIC_QTY
+};
+
+// Metrics are fed by the main thread and by the network threads, and exported by whatever thread handles the http request:
+//  counters and gauges are atomic, each histogram has its own lock. The histograms keep the latest observations in a ring buffer,
+//  so the quantiles are calculated over the recent activity, while their count and sum cover the whole uptime.
+class MetricsRegistry
+{
+	struct Histogram
+	{
+		SimpleMutex _mutex;
+		uint _uiSamples[METRICS_HISTOGRAM_SAMPLES];
+		uint _uiSampleNext;
+		uint _uiSampleCount;
+		ullong _uiObservations;
+		ullong _uiSum;			// usecs
+	};
+	Histogram _histograms[METRIC_HISTOGRAM_QTY];
+	std::atomic<llong> _iValues[METRIC_QTY - METRIC_HISTOGRAM_QTY];
+	int64 _iTimeNextSample;		// msecs
+
+public:
+	static const char* m_sClassName;
+	MetricsRegistry();
+	~MetricsRegistry() = default;
+
+private:
+	MetricsRegistry(const MetricsRegistry& copy);
+	MetricsRegistry& operator=(const MetricsRegistry& other);
+
+public:
+	static int64 GetTimeUsecs() noexcept;
+
+	void Observe(METRIC_TYPE id, int64 iUsecs);		// histograms
+	void Add(METRIC_TYPE id, llong iVal = 1) noexcept;	// counters
+	void Set(METRIC_TYPE id, llong iVal) noexcept;		// counters and gauges
+	bool IsSampleDue(int64 iTimeCur) noexcept;		// is it time to sample the gauges again?
+
+	void Export(CSString& sOut);
+
+private:
+	void ExportHistogram(CSString& sOut, METRIC_TYPE id);
+};
+
+extern MetricsRegistry g_Metrics;
+
+
+// Observes the time spent in a scope.
+class MetricTimer
+{
+	int64 _iStart;
+	METRIC_TYPE _id;
+	bool _fEnabled;
+
+public:
+	explicit MetricTimer(METRIC_TYPE id, bool fEnabled = true) noexcept;
+	~MetricTimer();
+
+private:
+	MetricTimer(const MetricTimer& copy);
+	MetricTimer& operator=(const MetricTimer& other);
+};
+
+#endif // _INC_METRICS_H
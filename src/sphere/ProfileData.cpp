@@ -11,6 +11,7 @@ ProfileData::ProfileData() noexcept
 	memset(m_AverageTimes, 0, sizeof(m_AverageTimes));
 	memset(m_CurrentTimes, 0, sizeof(m_CurrentTimes));
 	memset(m_PreviousTimes, 0, sizeof(m_PreviousTimes));
+	memset(m_TotalTimes, 0, sizeof(m_TotalTimes));
 	memset(m_EnabledProfiles, 0, sizeof(m_EnabledProfiles));
 
 	m_iActiveWindowSeconds = 10 * 1000; // expressed in milliseconds
@@ -36,6 +37,7 @@ void ProfileData::SetActive(int iSampleSec)
 	memset(m_AverageTimes, 0, sizeof(m_AverageTimes));
 	memset(m_CurrentTimes, 0, sizeof(m_CurrentTimes));
 	memset(m_PreviousTimes, 0, sizeof(m_PreviousTimes));
+	memset(m_TotalTimes, 0, sizeof(m_TotalTimes));
 
 	m_iActiveWindowSeconds = iSampleSec * 1000; // expressed in milliseconds;
 	m_iAverageCount		= 1;
@@ -101,6 +103,8 @@ void ProfileData::Start(PROFILE_TYPE id)
     ASSERT(m_TimeTotal >= 0);
 	m_CurrentTimes[m_CurrentTask].m_Time += llDiff;
 	++ m_CurrentTimes[m_CurrentTask].m_iCount;
+	m_TotalTimes[m_CurrentTask].m_Time += llDiff;
+	++ m_TotalTimes[m_CurrentTask].m_iCount;
 
 	// We are now on to the new task.
 	m_CurrentTime = llTicksStart;
@@ -114,6 +118,8 @@ void ProfileData::Count(PROFILE_TYPE id, dword dwVal)
 	ASSERT( id >= PROFILE_TIME_QTY && id < PROFILE_QTY );
 	m_CurrentTimes[id].m_Time += dwVal;
 	++ m_CurrentTimes[id].m_iCount;
+	m_TotalTimes[id].m_Time += dwVal;
+	++ m_TotalTimes[id].m_iCount;
 }
 
 void ProfileData::EnableProfile(PROFILE_TYPE id) noexcept
@@ -142,6 +148,16 @@ bool ProfileData::IsEnabled(PROFILE_TYPE id) const noexcept
 	return false;
 }
 
+llong ProfileData::GetTotalTime(PROFILE_TYPE id) const noexcept
+{
+	return (id < PROFILE_QTY) ? m_TotalTimes[id].m_Time : 0;
+}
+
+llong ProfileData::GetTotalCount(PROFILE_TYPE id) const noexcept
+{
+	return (id < PROFILE_QTY) ? m_TotalTimes[id].m_iCount : 0;
+}
+
 PROFILE_TYPE ProfileData::GetCurrentTask() const noexcept
 {
 	return m_CurrentTask;
@@ -163,6 +179,7 @@ lpctstr ProfileData::GetName(PROFILE_TYPE id) const noexcept
 		"NPC_AI",
 		"SCRIPTS",
         "SECTORS",
+        "SECTORS_COLD",
         "SHIPS",
         "TIMEDFUNCTIONS",
         "TIMERS",
@@ -22,6 +22,7 @@ enum PROFILE_TYPE : uchar
 	PROFILE_NPC_AI,		// processing npc ai
 	PROFILE_SCRIPTS,	// running scripts
     PROFILE_SECTORS,    // sector stuff
+    PROFILE_SECTORS_COLD, // sector stuff, for the awake sectors without clients nearby
     PROFILE_SHIPS,      // sips moving
     PROFILE_TIMEDFUNCTIONS, // TimerF
     PROFILE_TIMERS,
@@ -49,6 +50,11 @@ protected:
 	ProfileDataRec m_AverageTimes[PROFILE_QTY];
 	ProfileDataRec m_PreviousTimes[PROFILE_QTY];
 	ProfileDataRec m_CurrentTimes[PROFILE_QTY];
+	struct
+	{
+		llong m_Time;
+		llong m_iCount;
+	} m_TotalTimes[PROFILE_QTY];		// since the last SetActive, never averaged (for the benchmark report)
 	bool m_EnabledProfiles[PROFILE_QTY];
 
 	int m_iActiveWindowSeconds;	// The sample window size in seconds. 0=off
@@ -82,6 +88,8 @@ public:
 	PROFILE_TYPE GetCurrentTask() const noexcept;
 	lpctstr GetName(PROFILE_TYPE id) const noexcept;
 	lpctstr GetDescription(PROFILE_TYPE id) const;
+	llong GetTotalTime(PROFILE_TYPE id) const noexcept;		// msecs (or bytes/instances for the data profiles)
+	llong GetTotalCount(PROFILE_TYPE id) const noexcept;
 };
 
 #endif // _INC_PROFILEDATA_H
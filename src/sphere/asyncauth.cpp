@@ -0,0 +1,135 @@
+#include "../common/crypto/CBCrypt.h"
+#include "../common/crypto/CMD5.h"
+#include "../game/clients/CAccount.h"
+#include "../game/clients/CClient.h"
+#include "../game/CServerConfig.h"
+#include "asyncauth.h"
+
+CAuthAsyncHelper g_asyncAuth;
+
+static const char * const sm_szAuthThreadNames[AUTH_THREADS_MAX] =
+{
+	"AsyncAuthHelper#1", "AsyncAuthHelper#2", "AsyncAuthHelper#3", "AsyncAuthHelper#4",
+	"AsyncAuthHelper#5", "AsyncAuthHelper#6", "AsyncAuthHelper#7", "AsyncAuthHelper#8"
+};
+
+
+CAuthAsyncWorker::CAuthAsyncWorker(const char *pcName) : AbstractSphereThread(pcName, IThread::Normal)
+{
+}
+
+void CAuthAsyncWorker::tick()
+{
+	// Verify all the queued passwords, then sleep until awaken by a new request.
+	CAuthAsyncHelper::AuthRequest request;
+	while ( g_asyncAuth.takeRequest(request) )
+	{
+		const bool fMatch = CAccount::VerifyPassword(request.sPassword.GetBuffer(), request.sStored.GetBuffer(), request.fMD5);
+		g_asyncAuth.addResult(request, fMatch);
+	}
+}
+
+
+CAuthAsyncHelper::CAuthAsyncHelper(void) :
+	m_uiLastTicket(0), m_uiPending(0), m_uiProcessed(0), m_iLatencyTotal(0), m_iLatencyMax(0)
+{
+}
+
+bool CAuthAsyncHelper::isEnabled() const
+{
+	return (g_Cfg._iAuthThreads > 0);
+}
+
+dword CAuthAsyncHelper::addRequest(CClient* pClient, lpctstr pszPassword, lpctstr pszStored, bool fMD5)
+{
+	ADDTOCALLSTACK("CAuthAsyncHelper::addRequest");
+	// Main thread: queue a password to be verified, the ticket identifies the client waiting for the result.
+
+	const size_t uiThreads = (size_t)minimum(g_Cfg._iAuthThreads, AUTH_THREADS_MAX);
+	while ( m_workers.size() < uiThreads )
+	{
+		m_workers.emplace_back(std::make_unique<CAuthAsyncWorker>(sm_szAuthThreadNames[m_workers.size()]));
+		m_workers.back()->start();
+	}
+
+	if ( ++m_uiLastTicket == 0 )	// 0 = no ticket
+		++m_uiLastTicket;
+
+	{
+		SimpleThreadLock lock(m_requestMutex);
+		m_requestsTodo.emplace_back(AuthRequest{ m_uiLastTicket, CSString(pszPassword), CSString(pszStored), fMD5, CSTime::GetPreciseSysTimeMilli() });
+	}
+	++m_uiPending;
+	m_waitingClients[m_uiLastTicket] = pClient;
+
+	for ( std::unique_ptr<CAuthAsyncWorker>& pWorker : m_workers )
+		pWorker->awaken();
+	return m_uiLastTicket;
+}
+
+void CAuthAsyncHelper::removeClient(dword uiTicket)
+{
+	ADDTOCALLSTACK("CAuthAsyncHelper::removeClient");
+	m_waitingClients.erase(uiTicket);
+}
+
+bool CAuthAsyncHelper::takeRequest(AuthRequest& request)
+{
+	SimpleThreadLock lock(m_requestMutex);
+	if ( m_requestsTodo.empty() )
+		return false;
+
+	request = m_requestsTodo.front();
+	m_requestsTodo.pop_front();
+	return true;
+}
+
+void CAuthAsyncHelper::addResult(const AuthRequest& request, bool fMatch)
+{
+	SimpleThreadLock lock(m_resultMutex);
+	m_results.emplace_back(AuthResult{ request.uiTicket, fMatch, request.iTimeQueued });
+}
+
+void CAuthAsyncHelper::processResults()
+{
+	ADDTOCALLSTACK("CAuthAsyncHelper::processResults");
+	std::deque<AuthResult> results;
+	{
+		SimpleThreadLock lock(m_resultMutex);
+		if ( m_results.empty() )
+			return;
+		results.swap(m_results);
+	}
+
+	const llong iTimeNow = CSTime::GetPreciseSysTimeMilli();
+	for ( const AuthResult& result : results )
+	{
+		--m_uiPending;
+		++m_uiProcessed;
+		const llong iLatency = iTimeNow - result.iTimeQueued;
+		m_iLatencyTotal += iLatency;
+		if ( iLatency > m_iLatencyMax )
+			m_iLatencyMax = iLatency;
+
+		// The client may have disconnected in the meanwhile.
+		const auto itClient = m_waitingClients.find(result.uiTicket);
+		if ( itClient == m_waitingClients.end() )
+			continue;
+		CClient *pClient = itClient->second;
+		m_waitingClients.erase(itClient);
+		pClient->OnAuthResult(result.fMatch);
+	}
+}
+
+void CAuthAsyncHelper::waitForClose()
+{
+	{
+		SimpleThreadLock lock(m_requestMutex);
+		m_requestsTodo.clear();
+	}
+	m_waitingClients.clear();
+
+	for ( std::unique_ptr<CAuthAsyncWorker>& pWorker : m_workers )
+		pWorker->waitForClose();
+	m_workers.clear();
+}
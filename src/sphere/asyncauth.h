@@ -0,0 +1,103 @@
+/**
+* @file asyncauth.h
+* @brief Accounts password verification, off the main thread.
+*/
+
+#ifndef _INC_ASYNCAUTH_H
+#define _INC_ASYNCAUTH_H
+
+#include "../../lib/parallel_hashmap/phmap.h"
+#include "../common/sphere_library/smutex.h"
+#include "threads.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+class CClient;
+
+// Max number of threads verifying the passwords.
+#define AUTH_THREADS_MAX	8
+
+
+class CAuthAsyncWorker : public AbstractSphereThread
+{
+public:
+	explicit CAuthAsyncWorker(const char *pcName);
+	~CAuthAsyncWorker(void) = default;
+private:
+	CAuthAsyncWorker(const CAuthAsyncWorker& copy);
+	CAuthAsyncWorker& operator=(const CAuthAsyncWorker& other);
+
+public:
+	virtual void tick();
+};
+
+class CAuthAsyncHelper
+{
+	friend class CAuthAsyncWorker;
+
+private:
+	struct AuthRequest
+	{
+		dword uiTicket;
+		CSString sPassword;		// password sent by the client
+		CSString sStored;		// password (or hash) stored in the account
+		bool fMD5;
+		llong iTimeQueued;
+	};
+	struct AuthResult
+	{
+		dword uiTicket;
+		bool fMatch;
+		llong iTimeQueued;
+	};
+
+	SimpleMutex m_requestMutex;
+	std::deque<AuthRequest> m_requestsTodo;
+	SimpleMutex m_resultMutex;
+	std::deque<AuthResult> m_results;
+
+	std::vector<std::unique_ptr<CAuthAsyncWorker>> m_workers;
+	dword m_uiLastTicket;
+	phmap::flat_hash_map<dword, CClient*> m_waitingClients;	// ticket -> client waiting for the result (main thread only)
+
+	// Stats (main thread only).
+	size_t m_uiPending;			// requests queued and not processed yet
+	ullong m_uiProcessed;
+	llong m_iLatencyTotal;		// ms
+	llong m_iLatencyMax;		// ms
+
+public:
+	CAuthAsyncHelper(void);
+	~CAuthAsyncHelper(void) = default;
+private:
+	CAuthAsyncHelper(const CAuthAsyncHelper& copy);
+	CAuthAsyncHelper& operator=(const CAuthAsyncHelper& other);
+
+	bool takeRequest(AuthRequest& request);
+	void addResult(const AuthRequest& request, bool fMatch);
+
+public:
+	bool isEnabled() const;
+	dword addRequest(CClient* pClient, lpctstr pszPassword, lpctstr pszStored, bool fMD5);
+	void removeClient(dword uiTicket);	// Main thread: the client disconnected before getting the result.
+	void processResults();	// Main thread: give the results to the clients waiting for them.
+	void waitForClose();
+
+	size_t getPending() const noexcept {
+		return m_uiPending;
+	}
+	ullong getProcessed() const noexcept {
+		return m_uiProcessed;
+	}
+	llong getLatencyAvg() const noexcept {
+		return m_uiProcessed ? (m_iLatencyTotal / (llong)m_uiProcessed) : 0;
+	}
+	llong getLatencyMax() const noexcept {
+		return m_iLatencyMax;
+	}
+};
+
+extern CAuthAsyncHelper g_asyncAuth;
+
+#endif // _INC_ASYNCAUTH_H
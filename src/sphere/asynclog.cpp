@@ -0,0 +1,23 @@
+#include "../common/CLog.h"
+#include "asynclog.h"
+
+CLogAsyncWriter g_asyncLog;
+
+
+CLogAsyncWriter::CLogAsyncWriter(void) : AbstractSphereThread("AsyncLogWriter", IThread::Normal)
+{
+}
+
+void CLogAsyncWriter::tick()
+{
+	// Write all the lines queued since the last tick. We are awaken earlier when the queue is filling up.
+	g_Log.WriteQueue();
+}
+
+void CLogAsyncWriter::waitForClose()
+{
+	AbstractSphereThread::waitForClose();
+
+	// Write the lines left in the queue, the next ones will be written directly.
+	g_Log.StopQueue();
+}
@@ -0,0 +1,28 @@
+/**
+* @file asynclog.h
+* @brief Log file writer, off the threads logging the lines.
+*/
+
+#ifndef _INC_ASYNCLOG_H
+#define _INC_ASYNCLOG_H
+
+#include "threads.h"
+
+
+class CLogAsyncWriter : public AbstractSphereThread
+{
+public:
+	CLogAsyncWriter(void);
+	~CLogAsyncWriter(void) = default;
+private:
+	CLogAsyncWriter(const CLogAsyncWriter& copy);
+	CLogAsyncWriter& operator=(const CLogAsyncWriter& other);
+
+public:
+	virtual void tick();
+	virtual void waitForClose();
+};
+
+extern CLogAsyncWriter g_asyncLog;
+
+#endif // _INC_ASYNCLOG_H
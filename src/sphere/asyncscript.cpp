@@ -0,0 +1,95 @@
+#include "../common/resource/CResourceScript.h"
+#include "../common/CException.h"
+#include "../common/CLog.h"
+#include "asyncscript.h"
+
+CScriptLoadHelper g_asyncScriptLoad;
+
+static const char * const sm_szScriptLoadThreadNames[SCRIPTLOAD_THREADS_MAX] =
+{
+	"AsyncScriptLoad#1", "AsyncScriptLoad#2", "AsyncScriptLoad#3", "AsyncScriptLoad#4",
+	"AsyncScriptLoad#5", "AsyncScriptLoad#6", "AsyncScriptLoad#7", "AsyncScriptLoad#8"
+};
+
+
+CScriptLoadWorker::CScriptLoadWorker(const char *pcName) : AbstractSphereThread(pcName, IThread::Normal)
+{
+}
+
+void CScriptLoadWorker::tick()
+{
+	g_asyncScriptLoad.preloadNext();
+}
+
+
+CScriptLoadHelper::CScriptLoadHelper(void) :
+	m_uiNext(0), m_uiDone(0)
+{
+}
+
+void CScriptLoadHelper::preloadNext()
+{
+	// Take the files one at a time until there are none left: big and small files are mixed, so no thread stays idle for long.
+	const size_t uiCount = m_files.size();
+	for (;;)
+	{
+		const size_t i = m_uiNext.fetch_add(1);
+		if ( i >= uiCount )
+			break;
+
+		try
+		{
+			m_files[i]->Preload();
+		}
+		catch ( const CSError& e )
+		{
+			g_Log.CatchEvent(&e, "Preloading script '%s'", m_files[i]->GetFilePath());
+		}
+		catch ( ... )
+		{
+			g_Log.CatchEvent(nullptr, "Preloading script '%s'", m_files[i]->GetFilePath());
+		}
+
+		if ( m_uiDone.fetch_add(1) + 1 == uiCount )
+			m_doneEvent.signal();
+	}
+}
+
+size_t CScriptLoadHelper::preloadFiles(const std::vector<CResourceScript*>& vFiles, int iThreads)
+{
+	ADDTOCALLSTACK("CScriptLoadHelper::preloadFiles");
+	if ( vFiles.empty() )
+		return 0;
+
+	m_files = vFiles;
+	m_uiNext = 0;
+	m_uiDone = 0;
+
+	// The threads are needed only while loading, which is rare: don't keep them around.
+	std::vector<std::unique_ptr<CScriptLoadWorker>> vWorkers;
+	const int iMaxThreads = minimum(iThreads, SCRIPTLOAD_THREADS_MAX);
+	const int iFilesLeft = (int)vFiles.size() - 1;
+	const size_t uiThreads = (size_t)maximum(0, minimum(iMaxThreads, iFilesLeft));	// ScriptLoadThreads may be negative in the ini
+	for ( size_t i = 0; i < uiThreads; ++i )
+	{
+		vWorkers.emplace_back(std::make_unique<CScriptLoadWorker>(sm_szScriptLoadThreadNames[i]));
+		vWorkers.back()->start();
+	}
+
+	// This thread reads the files too, then waits for the others.
+	preloadNext();
+	while ( m_uiDone < m_files.size() )
+		m_doneEvent.wait(100);
+
+	for ( std::unique_ptr<CScriptLoadWorker>& pWorker : vWorkers )
+		pWorker->waitForClose();
+
+	size_t uiChanged = 0;
+	for ( const CResourceScript* pFile : m_files )
+	{
+		if ( pFile->IsPreloadChanged() )
+			++uiChanged;
+	}
+	m_files.clear();
+	return uiChanged;
+}
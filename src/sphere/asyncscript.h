@@ -0,0 +1,62 @@
+/**
+* @file asyncscript.h
+* @brief Reads and indexes the script files in parallel, when loading or resyncing the scripts.
+*/
+
+#ifndef _INC_ASYNCSCRIPT_H
+#define _INC_ASYNCSCRIPT_H
+
+#include "../common/sphere_library/sresetevents.h"
+#include "threads.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class CResourceScript;
+
+// Max number of threads reading the script files.
+#define SCRIPTLOAD_THREADS_MAX	8
+
+
+class CScriptLoadWorker : public AbstractSphereThread
+{
+public:
+	explicit CScriptLoadWorker(const char *pcName);
+	~CScriptLoadWorker(void) = default;
+private:
+	CScriptLoadWorker(const CScriptLoadWorker& copy);
+	CScriptLoadWorker& operator=(const CScriptLoadWorker& other);
+
+public:
+	virtual void tick();
+};
+
+// Loading the scripts is done in two phases: first the files are read (only the changed ones on resync), split in lines
+//  and their section headers indexed, by a few threads at once; then the main thread loads the resources from them.
+class CScriptLoadHelper
+{
+	friend class CScriptLoadWorker;
+
+private:
+	std::vector<CResourceScript*> m_files;
+	std::atomic<size_t> m_uiNext;		// next file to be read
+	std::atomic<size_t> m_uiDone;		// files read
+	AutoResetEvent m_doneEvent;
+
+public:
+	CScriptLoadHelper(void);
+	~CScriptLoadHelper(void) = default;
+private:
+	CScriptLoadHelper(const CScriptLoadHelper& copy);
+	CScriptLoadHelper& operator=(const CScriptLoadHelper& other);
+
+	void preloadNext();
+
+public:
+	// Main thread: read the files and wait for all of them. RETURN: number of files with new content.
+	size_t preloadFiles(const std::vector<CResourceScript*>& vFiles, int iThreads);
+};
+
+extern CScriptLoadHelper g_asyncScriptLoad;
+
+#endif // _INC_ASYNCSCRIPT_H